@@ -0,0 +1,133 @@
+
+/*
+ * @file        main.h
+ * @brief       Host stub of the STM32 HAL core used by the OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+#ifndef _MAIN_H_
+#define _MAIN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <assert.h>
+
+/*************************************************************************************************/
+/** Defines **/
+/*************************************************************************************************/
+
+/* CMSIS compiler macros */
+#define __PACKED                  __attribute__((packed))
+#define __STATIC_INLINE           static inline
+#define __STATIC_FORCEINLINE      __attribute__((always_inline)) static inline
+#define __IO                      volatile
+
+/* HAL parameter check, active on host */
+#define assert_param(expr)        assert(expr)
+
+#define SET_BIT(reg, bit)         ((reg) |= (bit))
+#define CLEAR_BIT(reg, bit)       ((reg) &= ~(bit))
+
+#define GPIO_PIN_0                0x0001U
+#define GPIO_PIN_1                0x0002U
+#define GPIO_PIN_2                0x0004U
+#define GPIO_PIN_3                0x0008U
+#define GPIO_PIN_4                0x0010U
+#define GPIO_PIN_5                0x0020U
+#define GPIO_PIN_6                0x0040U
+#define GPIO_PIN_7                0x0080U
+#define GPIO_PIN_8                0x0100U
+#define IS_GPIO_PIN(pin)          ((((uint32_t)(pin)) & 0xFFFFUL) != 0UL)
+
+#define GPIO_MODE_OUTPUT_PP       0x01UL
+#define GPIO_MODE_OUTPUT_OD       0x11UL
+#define GPIO_NOPULL               0UL
+#define GPIO_SPEED_FREQ_HIGH      2UL
+
+/* Simulated ports at STM32F4 addresses, constant for ow.hpp bindings, mapped by ow_sim_reset() */
+#define GPIOA_BASE                0x40020000UL
+#define GPIOB_BASE                0x40020400UL
+#define GPIOC_BASE                0x40020800UL
+#define GPIOA                     ((GPIO_TypeDef *)GPIOA_BASE)
+#define GPIOB                     ((GPIO_TypeDef *)GPIOB_BASE)
+#define GPIOC                     ((GPIO_TypeDef *)GPIOC_BASE)
+
+/*************************************************************************************************/
+/** Typedef/Struct/Enum **/
+/*************************************************************************************************/
+
+typedef enum
+{
+  HAL_OK = 0,
+  HAL_ERROR,
+  HAL_BUSY,
+  HAL_TIMEOUT
+
+} HAL_StatusTypeDef;
+
+/* GPIO registers, only IDR, ODR and BSRR are simulated */
+typedef struct
+{
+  volatile uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2], BRR;
+
+} GPIO_TypeDef;
+
+typedef struct
+{
+  uint32_t                  Pin;
+  uint32_t                  Mode;
+  uint32_t                  Pull;
+  uint32_t                  Speed;
+  uint32_t                  Alternate;
+
+} GPIO_InitTypeDef;
+
+/*************************************************************************************************/
+/** API Functions **/
+/*************************************************************************************************/
+
+/* Pin mode change, records strong pull-up (push-pull) phases */
+void      HAL_GPIO_Init(GPIO_TypeDef *gpio, GPIO_InitTypeDef *init);
+
+/* Simulated time in ms */
+uint32_t  HAL_GetTick(void);
+
+/* Interrupt mask, one simulated core */
+void      __disable_irq(void);
+void      __enable_irq(void);
+uint32_t  __get_PRIMASK(void);
+void      __set_PRIMASK(uint32_t primask);
+
+/* Host cycle counter for OW_CYCLES(), TSC on x86 and ns elsewhere */
+uint32_t  ow_sim_cycles(void);
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _MAIN_H_ */
@@ -0,0 +1,1284 @@
+
+/*
+ * @file        ow_bench.c
+ * @brief       Host benchmark of the OneWire driver on simulated buses
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ow.h"
+#include "ow_sim.h"
+#include "ow_bench.h"
+#if (OW_PROG == 1)
+#include "ow_ds18b20.h"
+#include "ow_ds2431.h"
+#endif
+#if (OW_TRACE == 1)
+#include "ow_trace.h"
+#endif
+
+/*************************************************************************************************/
+/** Private Defines **/
+/*************************************************************************************************/
+
+#if (OW_STATS == 0)
+#error  ow_bench needs OW_STATS = 1!
+#endif
+
+#if (OW_MAX_DEVICE == 1)
+#error  ow_bench needs OW_MAX_DEVICE > 1!
+#endif
+
+/* 1: scenarios run on the bus bindings of ow_bench_hpp.cpp, 0: on one bus of the C API */
+#ifndef OW_BENCH_HPP
+#define OW_BENCH_HPP              0
+#endif
+
+/* Simulated time limit of one transaction */
+#define BENCH_TIMEOUT             OW_SIM_US(60000000)
+
+/* DS2431 bytes read in one transaction, limited by OW_XFER_BUF_MAX */
+#define BENCH_MEM_LEN             (((OW_XFER_BUF_MAX - 2) < 144) ? (OW_XFER_BUF_MAX - 2) : 144)
+
+/* Devices of rescan, verify, queue and sample, one ROM ID entry left for an arrival */
+#define BENCH_DEV                 ((OW_MAX_DEVICE > 8) ? 8 : (OW_MAX_DEVICE - 1))
+
+/* DS2431 rows written in one pipeline, from address 0x20 */
+#define BENCH_ROW_ADDR            0x20
+#define BENCH_ROW_LEN             32
+
+/* DS18B20 conversion time of the slave model */
+#define BENCH_CONV_US             750000
+
+#if ((OW_BACKEND == OW_BACKEND_TIM) && (OW_TIM_HW == 0))
+/* Slot ISRs of a reset and of one written byte, a last write release stops without one more event */
+#define BENCH_ISR_RESET           3
+#define BENCH_ISR_BYTE            16
+/* One search pass: reset, command, then bit, complement and selected bit of 64 ROM bits */
+#define BENCH_ISR_PASS            (BENCH_ISR_RESET + BENCH_ISR_BYTE + 64 * 8)
+#endif
+
+#if ((OW_TIM_SHARED == 1) && (OW_BENCH_HPP == 0))
+/* Buses of the shared timer scenario, on three compare channels */
+#define BENCH_SHARED_BUS          6
+#elif (OW_TIM_SHARED == 1)
+/* Bindings of ow_bench_hpp.cpp on the shared timer, two on CH1 and one on CH2 */
+#define BENCH_SHARED_BIND         3
+#endif
+
+/*************************************************************************************************/
+/** Private Function prototype **/
+/*************************************************************************************************/
+
+/* Column names of the rows */
+static void bench_header(void);
+
+/* New simulation with one empty bus */
+static void bench_setup(void);
+
+/* Initialize handle on the bus, after the slaves are added */
+static void bench_init(void);
+
+/* Run the bus until the transaction is done, false on timeout */
+static bool bench_wait(void);
+
+/* Clear counters of setup transactions */
+static void bench_clear(void);
+
+/* Print one result row, return its check */
+static bool bench_report(const char *name, int devices, bool ok, uint64_t t0, uint64_t isr0);
+
+/* Simulated slave of a ROM ID index, NULL if none */
+static ow_sim_slave_t *bench_slave(uint8_t rom_id);
+
+/* Scenarios, each returns its check */
+static bool bench_search(int devices);
+static bool bench_search_alarm(void);
+static bool bench_search_family(void);
+static bool bench_ds18b20_convert(void);
+static bool bench_ds18b20_read(int devices);
+static bool bench_ds2431_read(void);
+#if (OW_BACKEND == OW_BACKEND_TIM)
+static bool bench_timing(void);
+#endif
+static bool bench_rescan(void);
+static bool bench_verify(void);
+#if (OW_PROG == 1)
+static bool bench_ds18b20_poll(void);
+static bool bench_ds18b20_pullup(void);
+static bool bench_ds18b20_sample(void);
+static bool bench_ds2431_write(void);
+#endif
+#if (OW_OVERDRIVE == 1)
+static bool bench_overdrive(void);
+#endif
+#if (OW_CALIB == 1)
+static bool bench_calibrate(void);
+#endif
+#if (OW_MARGIN == 1)
+static bool bench_margin(void);
+#endif
+#if (OW_TRACE == 1)
+static bool bench_trace(void);
+#endif
+#if (OW_RETRY == 1)
+static bool bench_retry(void);
+#endif
+#if (OW_QUEUE_LEN > 0)
+static bool bench_queue(void);
+#endif
+#if (OW_TIM_SHARED == 1)
+static bool bench_shared(void);
+static bool bench_shared_report(const char *name, ow_t *const *ow, int buses, bool ok, uint64_t t0);
+#endif
+
+/*************************************************************************************************/
+/** Private Variables **/
+/*************************************************************************************************/
+
+static ow_t *bench_ow;
+static int bench_bus;
+static int bench_bind;
+static bool bench_dual;
+
+#if (OW_BACKEND == OW_BACKEND_UART)
+static USART_TypeDef bench_uart_reg;
+UART_HandleTypeDef bench_uart = { .Instance = &bench_uart_reg };
+#else
+static TIM_TypeDef bench_tim_reg;
+TIM_HandleTypeDef bench_tim = { .Instance = &bench_tim_reg };
+#endif
+
+#if (OW_BENCH_HPP == 0)
+static ow_t bench_handle;
+#if (OW_ROM_TABLE == 1)
+static ow_id_t bench_rom_id[OW_MAX_DEVICE];
+#endif
+#endif
+
+/* Rescan reports */
+static int bench_arrived;
+static int bench_departed;
+static uint8_t bench_arrived_id;
+static uint8_t bench_departed_id;
+
+#if (OW_QUEUE_LEN > 0)
+/* Queued jobs done, all with the temperature of their slave */
+static int bench_jobs;
+static bool bench_jobs_ok;
+#endif
+
+#if (OW_PROG == 1)
+static ow_ds18b20_t bench_ds18;
+static ow_ds2431_t bench_ds24;
+#endif
+
+#if ((OW_TIM_SHARED == 1) && (OW_BENCH_HPP == 0))
+/* Three buses on CH1, two on CH2 and one alone on CH3, each channel serves its buses by deadline */
+static const uint32_t bench_shared_ch[BENCH_SHARED_BUS] =
+{
+  TIM_CHANNEL_1, TIM_CHANNEL_1, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_2, TIM_CHANNEL_3
+};
+/* Buses served in one ISR on different ports, the simulated BSRR only keeps the last write of an ISR */
+static GPIO_TypeDef *const bench_shared_gpio[3] = { GPIOA, GPIOB, GPIOC };
+static ow_t bench_shared_ow[BENCH_SHARED_BUS];
+static ow_tim_list_t bench_shared_list[2];
+#endif
+
+/*************************************************************************************************/
+/** Function Implementations **/
+/*************************************************************************************************/
+
+#if (OW_BENCH_HPP == 0)
+#if (OW_BACKEND == OW_BACKEND_UART)
+/* UART callback, as in stm32 project */
+static void bench_cb(UART_HandleTypeDef *huart)
+{
+  (void)huart;
+  ow_callback(&bench_handle);
+}
+#else
+/* Timer callback, as in stm32 project */
+static void bench_cb(TIM_HandleTypeDef *htim)
+{
+  (void)htim;
+  ow_callback(&bench_handle);
+}
+#endif
+#endif
+
+#if ((OW_TIM_SHARED == 1) && (OW_BENCH_HPP == 0))
+/* Timer callback of all buses on the shared timer, as in stm32 project */
+static void bench_shared_cb(TIM_HandleTypeDef *htim)
+{
+  (void)htim;
+  for (int i = 0; i < BENCH_SHARED_BUS; i++)
+  {
+    uint32_t isr_cnt = bench_shared_ow[i].stats.isr_cnt;
+    ow_callback(&bench_shared_ow[i]);
+
+    /* Counter runs on while a bus is served, a bus called before may fall due meanwhile */
+    if (bench_shared_ow[i].stats.isr_cnt != isr_cnt)
+    {
+      ow_sim_post();
+      ow_sim_now += OW_SIM_US(1);
+      ow_sim_pre();
+    }
+  }
+}
+#endif
+
+/* Rescan callback, one call per arrived or departed device */
+static void bench_change_cb(ow_t *handle, uint8_t rom_id, bool arrived)
+{
+  (void)handle;
+  if (arrived)
+  {
+    bench_arrived++;
+    bench_arrived_id = rom_id;
+  }
+  else
+  {
+    bench_departed++;
+    bench_departed_id = rom_id;
+  }
+}
+
+#if (OW_QUEUE_LEN > 0)
+/* Queued scratchpad read done, argument is the slave of its ROM ID */
+static void bench_job_cb(ow_t *handle, ow_err_t error, void *arg)
+{
+  ow_sim_slave_t *slave = (ow_sim_slave_t *)arg;
+  uint8_t scratch[9];
+  bool ok = (error == OW_ERR_NONE) && (ow_read_resp(handle, scratch, sizeof(scratch)) == 9) &&
+            (ow_resp_crc(handle) == 0) && ((int16_t)(scratch[0] | (scratch[1] << 8)) == slave->temp);
+  bench_jobs_ok = bench_jobs_ok && ok;
+  bench_jobs++;
+}
+#endif
+
+#if (OW_PROG == 1)
+/* Done callbacks of the bus, step the device modules as in stm32 project */
+static void bench_ds18b20_done(ow_t *handle, ow_err_t error, void *arg)
+{
+  (void)handle;
+  ow_ds18b20_callback((ow_ds18b20_t *)arg, error);
+}
+
+static void bench_ds2431_done(ow_t *handle, ow_err_t error, void *arg)
+{
+  (void)handle;
+  ow_ds2431_callback((ow_ds2431_t *)arg, error);
+}
+#endif
+
+/*************************************************************************************************/
+/**
+ * @brief Run all scenarios, one row each: ISR calls, simulated bus time and host cycles in ISR.
+ *        Scenarios of OW_PROG, OW_RETRY and OW_QUEUE_LEN run when enabled.
+ * @param[in] argc: 1, or 2 with ISR entry latency in timer ticks.
+ * @param[in] argv: Program name and optional latency.
+ * @retval 0 if all checks passed, 1 otherwise.
+ */
+int main(int argc, char **argv)
+{
+  bool ok = true;
+  int binds = 1;
+  if (argc > 1)
+  {
+    ow_sim_lat = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+#if (OW_BENCH_HPP == 1)
+  binds = bench_hpp_count();
+#endif
+
+  for (bench_bind = 0; bench_bind < binds; bench_bind++)
+  {
+#if (OW_BENCH_HPP == 1)
+    bench_dual = bench_hpp_dual(bench_bind);
+    printf("%s\n", bench_hpp_name(bench_bind));
+#else
+    bench_dual = (OW_DUAL_PINS == 1);
+#endif
+    bench_header();
+
+    ok &= bench_ds18b20_convert();
+    ok &= bench_ds18b20_read(1);
+    ok &= bench_ds18b20_read(OW_MAX_DEVICE);
+    ok &= bench_ds2431_read();
+#if (OW_BACKEND == OW_BACKEND_TIM)
+    ok &= bench_timing();
+#endif
+#if (OW_PROG == 1)
+    ok &= bench_ds18b20_poll();
+    /* Strong pull-up of dual pins needs its own circuit */
+    if (!bench_dual)
+    {
+      ok &= bench_ds18b20_pullup();
+    }
+    ok &= bench_ds18b20_sample();
+    ok &= bench_ds2431_write();
+#endif
+#if (OW_OVERDRIVE == 1)
+    ok &= bench_overdrive();
+#endif
+#if (OW_CALIB == 1)
+    ok &= bench_calibrate();
+#endif
+#if (OW_MARGIN == 1)
+    ok &= bench_margin();
+#endif
+#if (OW_TRACE == 1)
+    ok &= bench_trace();
+#endif
+#if (OW_RETRY == 1)
+    ok &= bench_retry();
+#endif
+#if (OW_QUEUE_LEN > 0)
+    ok &= bench_queue();
+#endif
+#if ((OW_TIM_SHARED == 1) && (OW_BENCH_HPP == 0))
+    ok &= bench_shared();
+#endif
+    ok &= bench_rescan();
+    ok &= bench_verify();
+    ok &= bench_search_alarm();
+    ok &= bench_search_family();
+    ok &= bench_search(1);
+#if (OW_MAX_DEVICE > 8)
+    ok &= bench_search(8);
+#endif
+#if (OW_MAX_DEVICE > 64)
+    ok &= bench_search(64);
+#endif
+    ok &= bench_search(OW_MAX_DEVICE);
+  }
+#if ((OW_TIM_SHARED == 1) && (OW_BENCH_HPP == 1))
+
+  /* Bindings of one timer together, after each one alone */
+  printf("%d bindings on bench_tim\n", bench_hpp_shared_count());
+  bench_header();
+  ok &= bench_shared();
+#endif
+
+  ow_sim_reset();
+  return ok ? 0 : 1;
+}
+
+/*************************************************************************************************/
+/** Private Function Implementations **/
+/*************************************************************************************************/
+
+static void bench_header(void)
+{
+  printf("%-22s %5s %6s %8s %12s %12s %10s %10s\n", "test", "dev", "result", "isr", "bus_us", "isr_cyc",
+         "cyc/isr", "max_cyc");
+}
+
+/*************************************************************************************************/
+static void bench_setup(void)
+{
+  ow_sim_reset();
+#if (OW_BENCH_HPP == 1)
+  bench_bus = bench_hpp_bus(bench_bind);
+#elif (OW_DUAL_PINS == 1)
+  bench_bus = ow_sim_bus_add_dual(GPIOA, GPIO_PIN_0, GPIOA, GPIO_PIN_1, OW_INVERT_TX == 1, OW_INVERT_RX == 1);
+#else
+  bench_bus = ow_sim_bus_add(GPIOA, GPIO_PIN_0);
+#endif
+}
+
+/*************************************************************************************************/
+static void bench_init(void)
+{
+#if (OW_TIM_HW == 1)
+  ow_sim_bus_hw(bench_bus);
+#elif (OW_TIM_SHARED == 1)
+  /* Free running timer of all buses, one compare channel per bus */
+  bench_tim_reg.ARR = 0xFFFF;
+#endif
+#if (OW_BENCH_HPP == 1)
+  OW_SIM(bench_ow = bench_hpp_init(bench_bind));
+#else
+  ow_init_t init;
+  memset(&init, 0, sizeof(init));
+#if (OW_BACKEND == OW_BACKEND_UART)
+  init.uart_handle = &bench_uart;
+  init.uart_cb = bench_cb;
+#else
+  init.tim_handle = &bench_tim;
+  init.tim_cb = bench_cb;
+#if (OW_DUAL_PINS == 1)
+  init.gpio_tx = GPIOA;
+  init.pin_tx = GPIO_PIN_0;
+  init.gpio_rx = GPIOA;
+  init.pin_rx = GPIO_PIN_1;
+#else
+  init.gpio = GPIOA;
+  init.pin = GPIO_PIN_0;
+#endif
+#if ((OW_TIM_HW == 1) || (OW_TIM_SHARED == 1))
+  init.tim_ch = TIM_CHANNEL_1;
+#endif
+#endif
+#if (OW_ROM_TABLE == 1)
+  init.rom_id_table = bench_rom_id;
+  init.rom_id_max = OW_MAX_DEVICE;
+#endif
+  bench_ow = &bench_handle;
+  OW_SIM(ow_init(bench_ow, &init));
+#endif
+}
+
+/*************************************************************************************************/
+static bool bench_wait(void)
+{
+#if (OW_BACKEND == OW_BACKEND_UART)
+  ow_sim_uart_run(&bench_uart, bench_bus);
+  return true;
+#else
+  return ow_sim_run(BENCH_TIMEOUT) == 0;
+#endif
+}
+
+/*************************************************************************************************/
+static void bench_clear(void)
+{
+  ow_stats_t stats;
+  ow_stats(bench_ow, &stats, true);
+}
+
+/*************************************************************************************************/
+static bool bench_report(const char *name, int devices, bool ok, uint64_t t0, uint64_t isr0)
+{
+  /* Counters since bench_clear(), rows of chained transactions count all of them */
+  ow_stats_t stats;
+  ow_stats(bench_ow, &stats, true);
+  ok = ok && (ow_last_error(bench_ow) == OW_ERR_NONE) && (stats.isr_cnt == (uint32_t)(ow_sim_isr - isr0));
+  printf("%-22s %5d %6s %8lu %12llu %12llu %10lu %10lu\n", name, devices, ok ? "ok" : "FAIL",
+         (unsigned long)stats.isr_cnt, (unsigned long long)((ow_sim_now - t0) / OW_SIM_US(1)),
+         (unsigned long long)stats.isr_cyc_sum, (unsigned long)stats.isr_cyc_avg, (unsigned long)stats.isr_cyc_max);
+  return ok;
+}
+
+/*************************************************************************************************/
+static ow_sim_slave_t *bench_slave(uint8_t rom_id)
+{
+  for (int k = 0; k < ow_sim_slave_count(); k++)
+  {
+    ow_sim_slave_t *slave = ow_sim_slave_get(k);
+    if (memcmp(bench_ow->rom_id[rom_id].array, slave->rom, 8) == 0)
+    {
+      return slave;
+    }
+  }
+  return NULL;
+}
+
+/*************************************************************************************************/
+static bool bench_search(int devices)
+{
+  bool ok;
+  bench_setup();
+  ow_sim_rom_bulk(bench_bus, 0x28, devices, (uint32_t)devices);
+  bench_init();
+
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_update_rom_id(bench_ow));
+  ok = (err == OW_ERR_NONE) && bench_wait() && (ow_devices(bench_ow) == devices);
+
+  /* Every ROM ID found belongs to a simulated slave */
+  for (int i = 0; ok && (i < devices); i++)
+  {
+    bool found = false;
+    for (int k = 0; !found && (k < devices); k++)
+    {
+      found = (memcmp(bench_ow->rom_id[i].array, ow_sim_slave_get(k)->rom, 8) == 0);
+    }
+    ok = found;
+  }
+#if ((OW_BACKEND == OW_BACKEND_TIM) && (OW_TIM_HW == 0))
+  ok = ok && (ow_sim_isr - isr0 == (uint64_t)devices * BENCH_ISR_PASS);
+#endif
+  return bench_report("search", devices, ok, t0, isr0);
+}
+
+/*************************************************************************************************/
+static bool bench_search_alarm(void)
+{
+  bool ok;
+  int devices = BENCH_DEV + 1;
+  int alarms = 0;
+  bench_setup();
+  int first = ow_sim_rom_bulk(bench_bus, 0x28, devices, 0xA1A);
+  for (int i = 0; i < devices; i += 2)
+  {
+    ow_sim_slave_get(first + i)->alarm = true;
+    alarms++;
+  }
+  bench_init();
+
+  /* Conditional search lists the devices in alarm only */
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_search_alarm(bench_ow, 0));
+  ok = (err == OW_ERR_NONE) && bench_wait() && (ow_devices(bench_ow) == alarms);
+  for (uint8_t i = 0; ok && (i < alarms); i++)
+  {
+    ok = (bench_slave(i) != NULL) && bench_slave(i)->alarm;
+  }
+  return bench_report("alarm search", alarms, ok, t0, isr0);
+}
+
+/*************************************************************************************************/
+static bool bench_search_family(void)
+{
+  bool ok;
+  bench_setup();
+  ow_sim_rom_bulk(bench_bus, 0x28, BENCH_DEV, 0xFA28);
+  ow_sim_rom_bulk(bench_bus, 0x2D, BENCH_DEV, 0xFA2D);
+  ow_sim_slave_add(bench_bus, 0x3A, 0xFA3A);
+  bench_init();
+
+  /* Family between two others, its branch only */
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_search_family(bench_ow, 0x2D));
+  ok = (err == OW_ERR_NONE) && bench_wait() && (ow_devices(bench_ow) == BENCH_DEV);
+  for (uint8_t i = 0; ok && (i < BENCH_DEV); i++)
+  {
+    ok = (bench_slave(i) != NULL) && (bench_ow->rom_id[i].rom_id_struct.family == 0x2D);
+  }
+  return bench_report("family search", BENCH_DEV, ok, t0, isr0);
+}
+
+/*************************************************************************************************/
+static bool bench_ds18b20_convert(void)
+{
+  bool ok;
+  bench_setup();
+  ow_sim_ds18b20(ow_sim_slave_add(bench_bus, 0x28, 1), 0);
+  bench_init();
+
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_xfer(bench_ow, 0x44, NULL, 0, 0));
+  ok = (err == OW_ERR_NONE) && bench_wait();
+  ok = ok && (ow_sim_slave_get(0)->fn_cmd == 0x44);
+#if ((OW_BACKEND == OW_BACKEND_TIM) && (OW_TIM_HW == 0))
+  /* Skip ROM and Convert T, stopped at the release of the last bit */
+  ok = ok && (ow_sim_isr - isr0 == BENCH_ISR_RESET + 2 * BENCH_ISR_BYTE);
+#endif
+  return bench_report("ds18b20 convert", 1, ok, t0, isr0);
+}
+
+/*************************************************************************************************/
+static bool bench_ds18b20_read(int devices)
+{
+  bool ok;
+  bench_setup();
+  for (int i = 0; i < devices; i++)
+  {
+    ow_sim_ds18b20(ow_sim_slave_add(bench_bus, 0x28, 0x100 + (uint64_t)i), (int16_t)(400 + i));
+  }
+  bench_init();
+  OW_SIM(ow_update_rom_id(bench_ow));
+  ok = bench_wait() && (ow_devices(bench_ow) == devices);
+  bench_clear();
+
+  /* Read scratchpad of last device by Match ROM */
+  uint8_t rom_id = (uint8_t)(devices - 1);
+  uint8_t scratch[9];
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_xfer_by_id(bench_ow, rom_id, 0xBE, NULL, 0, 9));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait();
+  ok = ok && (ow_read_resp(bench_ow, scratch, sizeof(scratch)) == 9) && (ow_resp_crc(bench_ow) == 0);
+  /* Temperature of the simulated slave with this ROM ID */
+  ok = ok && (bench_slave(rom_id) != NULL) && (bench_slave(rom_id)->temp == (int16_t)(scratch[0] | (scratch[1] << 8)));
+  return bench_report("ds18b20 read", devices, ok, t0, isr0);
+}
+
+/*************************************************************************************************/
+static bool bench_ds2431_read(void)
+{
+  bool ok;
+  ow_sim_slave_t *slave;
+  bench_setup();
+  slave = ow_sim_slave_add(bench_bus, 0x2D, 1);
+  ow_sim_ds2431(slave);
+  for (int i = 0; i < (int)sizeof(slave->mem); i++)
+  {
+    slave->mem[i] = (uint8_t)(i * 7 + 1);
+  }
+  bench_init();
+  OW_SIM(ow_update_rom_id(bench_ow));
+  ok = bench_wait() && (ow_devices(bench_ow) == 1);
+  bench_clear();
+
+  /* Read memory from address 0 into caller buffer */
+  static const uint8_t addr[2] = { 0x00, 0x00 };
+  static uint8_t mem[BENCH_MEM_LEN];
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_xfer_buf_by_id(bench_ow, 0, 0xF0, addr, sizeof(addr), mem, sizeof(mem)));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait() && (memcmp(mem, slave->mem, sizeof(mem)) == 0);
+  return bench_report("ds2431 read", 1, ok, t0, isr0);
+}
+
+#if (OW_BACKEND == OW_BACKEND_TIM)
+/*************************************************************************************************/
+static bool bench_timing(void)
+{
+  bool ok;
+  bench_setup();
+  ow_sim_ds18b20(ow_sim_slave_add(bench_bus, 0x28, 1), 0x123);
+  bench_init();
+
+  /* 0 field and slots over 16 bits are rejected, table in use is kept */
+  ow_tim_t tim = bench_ow->tim_table[OW_SPEED_STD];
+  ow_tim_t bad = tim;
+  bad.write_low = 0;
+  ok = (ow_set_timing(bench_ow, OW_SPEED_STD, &bad) == OW_ERR_LEN);
+  bad = tim;
+  bad.rst = 0x8000;
+  ok = ok && (ow_set_timing(bench_ow, OW_SPEED_STD, &bad) == OW_ERR_LEN);
+  bad = tim;
+  bad.read_high = (uint16_t)(0x10000UL - bad.read_low - bad.read_sample);
+  ok = ok && (ow_set_timing(bench_ow, OW_SPEED_STD, &bad) == OW_ERR_LEN);
+  ok = ok && (memcmp(&bench_ow->tim_table[OW_SPEED_STD], &tim, sizeof(tim)) == 0);
+
+  /* Longer reset and write recovery, as for a long cable */
+  tim.rst = (uint16_t)(tim.rst + OW_SIM_US(100));
+  tim.write_high = (uint16_t)(tim.write_high + OW_SIM_US(10));
+  ok = ok && (ow_set_timing(bench_ow, OW_SPEED_STD, &tim) == OW_ERR_NONE);
+
+  uint8_t scratch[9];
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_xfer(bench_ow, 0xBE, NULL, 0, 9));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait();
+  ok = ok && (ow_read_resp(bench_ow, scratch, sizeof(scratch)) == 9) && (ow_resp_crc(bench_ow) == 0);
+  ok = ok && (scratch[0] == 0x23) && (scratch[1] == 0x01);
+  return bench_report("set timing", 1, ok, t0, isr0);
+}
+#endif
+
+/*************************************************************************************************/
+static bool bench_rescan(void)
+{
+  bool ok;
+  static uint8_t snap[OW_ROM_SNAP_LEN(OW_MAX_DEVICE)];
+  bench_setup();
+  int first = ow_sim_rom_bulk(bench_bus, 0x28, BENCH_DEV, 0x5CA1);
+  bench_init();
+  OW_SIM(ow_update_rom_id(bench_ow));
+  ok = bench_wait() && (ow_devices(bench_ow) == BENCH_DEV);
+  uint16_t snap_len = ow_rom_export(bench_ow, snap, sizeof(snap));
+  ok = ok && (snap_len == OW_ROM_SNAP_LEN(BENCH_DEV));
+
+  /* One device leaves and one arrives while the list is kept in a snapshot */
+  ow_sim_slave_t *gone = ow_sim_slave_get(first);
+  ow_sim_slave_t *added = ow_sim_slave_add(bench_bus, 0x28, 0xA221);
+  uint8_t gone_id = 0;
+  for (uint8_t i = 0; i < BENCH_DEV; i++)
+  {
+    gone_id = (bench_slave(i) == gone) ? i : gone_id;
+  }
+  ow_sim_slave_remove(gone);
+
+  /* Restored list keeps its indices, rescan reports the changes only */
+  bench_init();
+  ok = ok && (ow_rom_import(bench_ow, snap, snap_len) == OW_ERR_NONE) && (ow_devices(bench_ow) == BENCH_DEV);
+  bench_arrived = 0;
+  bench_departed = 0;
+  bench_clear();
+
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_rescan(bench_ow, bench_change_cb));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait();
+  ok = ok && (bench_arrived == 1) && (bench_slave(bench_arrived_id) == added);
+  ok = ok && (bench_departed == 1) && (bench_departed_id == gone_id) && (bench_ow->rom_id[gone_id].rom_id_struct.family == 0);
+  for (uint8_t i = 0; ok && (i < BENCH_DEV); i++)
+  {
+    ok = (i == gone_id) || (bench_slave(i) != NULL);
+  }
+  return bench_report("rescan", BENCH_DEV, ok, t0, isr0);
+}
+
+/*************************************************************************************************/
+static bool bench_verify(void)
+{
+  bool ok;
+  int devices = BENCH_DEV + 1;
+  bench_setup();
+  int first = ow_sim_rom_bulk(bench_bus, 0x28, devices, 0x7E51);
+  bench_init();
+  OW_SIM(ow_update_rom_id(bench_ow));
+  ok = bench_wait() && (ow_devices(bench_ow) == devices);
+
+  /* Departed device fails */
+  ow_sim_slave_t *gone = ow_sim_slave_get(first + devices - 1);
+  uint8_t gone_id = 0;
+  for (uint8_t i = 0; i < devices; i++)
+  {
+    gone_id = (bench_slave(i) == gone) ? i : gone_id;
+  }
+  ow_sim_slave_remove(gone);
+  OW_SIM(ow_verify(bench_ow, gone_id));
+  ok = ok && bench_wait() && (ow_last_error(bench_ow) != OW_ERR_NONE);
+  bench_clear();
+
+  /* Present device passes */
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_verify(bench_ow, (uint8_t)((gone_id + 1) % devices)));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait();
+  return bench_report("verify", devices, ok, t0, isr0);
+}
+
+#if (OW_PROG == 1)
+/*************************************************************************************************/
+static bool bench_ds18b20_poll(void)
+{
+  bool ok;
+  bench_setup();
+  ow_sim_ds18b20(ow_sim_slave_add(bench_bus, 0x28, 1), 0);
+  bench_init();
+
+  /* Read slots every 1 ms, done at the first one after the conversion */
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_xfer_poll(bench_ow, 0x44, 1000, 1000));
+  ok = (err == OW_ERR_NONE) && bench_wait();
+  ok = ok && (ow_sim_now - t0 > OW_SIM_US(BENCH_CONV_US)) && (ow_sim_now - t0 < OW_SIM_US(BENCH_CONV_US + 5000));
+  return bench_report("ds18b20 poll", 1, ok, t0, isr0);
+}
+
+/*************************************************************************************************/
+static bool bench_ds18b20_pullup(void)
+{
+  bool ok;
+  bench_setup();
+  ow_sim_ds18b20(ow_sim_slave_add(bench_bus, 0x28, 1), 0);
+  bench_init();
+
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_xfer_pullup(bench_ow, 0x44, BENCH_CONV_US / 1000));
+  ok = (err == OW_ERR_NONE) && bench_wait() && (ow_sim_pullup_cnt == 1);
+  ok = ok && (ow_sim_pullup_off - ow_sim_pullup_on >= OW_SIM_US(BENCH_CONV_US)) &&
+       (ow_sim_pullup_off - ow_sim_pullup_on < OW_SIM_US(BENCH_CONV_US + 1000));
+  return bench_report("ds18b20 pullup", 1, ok, t0, isr0);
+}
+
+/*************************************************************************************************/
+static bool bench_ds18b20_sample(void)
+{
+  bool ok;
+  static ow_ds18b20_val_t val[BENCH_DEV];
+  bench_setup();
+  for (int i = 0; i < BENCH_DEV; i++)
+  {
+    ow_sim_ds18b20(ow_sim_slave_add(bench_bus, 0x28, 0x200 + (uint64_t)i), (int16_t)(-200 + 37 * i));
+  }
+  bench_init();
+  OW_SIM(ow_update_rom_id(bench_ow));
+  ok = bench_wait() && (ow_devices(bench_ow) == BENCH_DEV);
+  ow_ds18b20_init(&bench_ds18, bench_ow, false, NULL);
+  ow_set_done_cb(bench_ow, bench_ds18b20_done, &bench_ds18);
+  bench_clear();
+
+  /* Convert all, poll, then every scratchpad read chained from the done callback */
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_ds18b20_sample(&bench_ds18, val, BENCH_DEV));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait() && !ow_ds18b20_is_busy(&bench_ds18);
+  for (uint8_t i = 0; ok && (i < BENCH_DEV); i++)
+  {
+    ok = (val[i].error == OW_ERR_NONE) && (bench_slave(i) != NULL) && (bench_slave(i)->temp == val[i].temp);
+  }
+  return bench_report("ds18b20 sample", BENCH_DEV, ok, t0, isr0);
+}
+
+/*************************************************************************************************/
+static bool bench_ds2431_write(void)
+{
+  bool ok;
+  ow_sim_slave_t *slave;
+  static uint8_t data[BENCH_ROW_LEN];
+  bench_setup();
+  slave = ow_sim_slave_add(bench_bus, 0x2D, 1);
+  ow_sim_ds2431(slave);
+  bench_init();
+  OW_SIM(ow_update_rom_id(bench_ow));
+  ok = bench_wait() && (ow_devices(bench_ow) == 1);
+  ow_ds2431_init(&bench_ds24, bench_ow, 0, NULL);
+  ow_set_done_cb(bench_ow, bench_ds2431_done, &bench_ds24);
+  bench_clear();
+  for (int i = 0; i < BENCH_ROW_LEN; i++)
+  {
+    data[i] = (uint8_t)(i * 11 + 3);
+  }
+
+  /* Write, verify and copy each row, next row started from the done callback */
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_ds2431_write(&bench_ds24, BENCH_ROW_ADDR, data, BENCH_ROW_LEN));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait() && !ow_ds2431_is_busy(&bench_ds24);
+  ok = ok && (bench_ds24.error == OW_ERR_NONE) && (memcmp(&slave->mem[BENCH_ROW_ADDR], data, BENCH_ROW_LEN) == 0);
+  ok = ok && (slave->mem[BENCH_ROW_ADDR - 1] == 0xFF) && (slave->mem[BENCH_ROW_ADDR + BENCH_ROW_LEN] == 0xFF);
+  return bench_report("ds2431 write", 1, ok, t0, isr0);
+}
+#endif
+
+#if (OW_OVERDRIVE == 1)
+/*************************************************************************************************/
+static bool bench_overdrive(void)
+{
+  bool ok;
+  ow_sim_slave_t *slave;
+  bench_setup();
+  slave = ow_sim_slave_add(bench_bus, 0x2D, 1);
+  ow_sim_ds2431(slave);
+  for (int i = 0; i < (int)sizeof(slave->mem); i++)
+  {
+    slave->mem[i] = (uint8_t)(i * 3 + 5);
+  }
+  bench_init();
+
+  /* Overdrive Skip ROM at standard speed, then memory read at overdrive speed */
+  static const uint8_t addr[2] = { 0x00, 0x00 };
+  static uint8_t mem[BENCH_MEM_LEN];
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_overdrive(bench_ow));
+  ok = (err == OW_ERR_NONE) && bench_wait() && slave->od && (bench_ow->speed == OW_SPEED_OD);
+  OW_SIM(err = ow_xfer_buf(bench_ow, 0xF0, addr, sizeof(addr), mem, sizeof(mem)));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait() && (memcmp(mem, slave->mem, sizeof(mem)) == 0);
+  ok = ok && (ow_set_speed(bench_ow, OW_SPEED_STD) == OW_ERR_NONE);
+  return bench_report("overdrive read", 1, ok, t0, isr0);
+}
+#endif
+
+#if (OW_CALIB == 1)
+/*************************************************************************************************/
+static bool bench_calibrate(void)
+{
+  bool ok;
+  ow_calib_t calib;
+  bench_setup();
+  ow_sim_ds18b20(ow_sim_slave_add(bench_bus, 0x28, 1), 0x1A5);
+  bench_init();
+
+  /* Read ROM measures pin access behind each event, ISR latency included */
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_calibrate(bench_ow));
+  ok = (err == OW_ERR_NONE) && bench_wait() && (ow_last_error(bench_ow) == OW_ERR_NONE);
+  ow_get_calib(bench_ow, &calib);
+  ok = ok && (calib.lat_max >= ow_sim_lat);
+
+  /* Next slots compensated, response unchanged */
+  uint8_t scratch[9];
+  OW_SIM(err = ow_xfer(bench_ow, 0xBE, NULL, 0, 9));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait();
+  ok = ok && (ow_read_resp(bench_ow, scratch, sizeof(scratch)) == 9) && (ow_resp_crc(bench_ow) == 0);
+  ok = ok && (scratch[0] == 0xA5) && (scratch[1] == 0x01);
+  return bench_report("calibrated read", 1, ok, t0, isr0);
+}
+#endif
+
+#if (OW_MARGIN == 1)
+/*************************************************************************************************/
+static bool bench_margin(void)
+{
+  bool ok;
+  ow_margin_t margin;
+  ow_sim_slave_t *slave;
+  bench_setup();
+  slave = ow_sim_slave_add(bench_bus, 0x28, 1);
+  ow_sim_ds18b20(slave, 0x1A5);
+  bench_init();
+
+  /* Empty bus: no presence, nothing to tune from */
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  uint8_t scratch[9];
+  ow_err_t err;
+  slave->present = false;
+  OW_SIM(err = ow_xfer(bench_ow, 0xBE, NULL, 0, 9));
+  ok = (err == OW_ERR_NONE) && bench_wait() && (ow_last_error(bench_ow) == OW_ERR_RESET);
+  ok = ok && (ow_margin(bench_ow, &margin) == OW_ERR_NONE) && (margin.presence_start == 0) && (margin.presence_width == 0);
+  ok = ok && (ow_margin_tune(bench_ow, OW_SIM_US(2)) == OW_ERR_BUS);
+
+  /* Scratchpad has read 0 and read 1 slots, presence pulse of the slave is 30 us after release for 120 us */
+  slave->present = true;
+  OW_SIM(err = ow_xfer(bench_ow, 0xBE, NULL, 0, 9));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait() && (ow_margin(bench_ow, &margin) == OW_ERR_NONE);
+  ok = ok && (margin.presence_start == OW_SIM_US(30)) && (margin.presence_width == OW_SIM_US(120));
+  ok = ok && (margin.ones > 0) && (margin.zeros > 0) && (margin.rise_max < margin.hold_min);
+
+  /* Earliest safe sample point, response unchanged */
+  ok = ok && (ow_margin_tune(bench_ow, OW_SIM_US(2)) == OW_ERR_NONE);
+  ok = ok && (bench_ow->tim->read_low + bench_ow->tim->read_sample == margin.rise_max + OW_SIM_US(2));
+  OW_SIM(err = ow_xfer(bench_ow, 0xBE, NULL, 0, 9));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait();
+  ok = ok && (ow_read_resp(bench_ow, scratch, sizeof(scratch)) == 9) && (ow_resp_crc(bench_ow) == 0);
+  ok = ok && (scratch[0] == 0xA5) && (scratch[1] == 0x01);
+  return bench_report("margin tune", 1, ok, t0, isr0);
+}
+#endif
+
+#if (OW_TRACE == 1)
+/*************************************************************************************************/
+static bool bench_trace(void)
+{
+  bool ok;
+  static ow_trace_t trace[OW_TRACE_LEN];
+  static ow_trace_slot_t slot[24];
+  bench_setup();
+  bench_init();
+
+  /* Empty bus: the ring holds the failed reset, one slot without presence */
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  OW_SIM(err = ow_xfer(bench_ow, 0x44, NULL, 0, 0));
+  ok = (err == OW_ERR_NONE) && bench_wait() && (ow_last_error(bench_ow) == OW_ERR_RESET);
+  uint16_t cnt = ow_trace_read(bench_ow, trace, OW_TRACE_LEN);
+  uint16_t slots = ow_trace_decode(trace, cnt, slot, 24);
+  ok = ok && (slots == 1) && (slot[0].type == OW_TRACE_SLOT_RESET) && (slot[0].bit == 1) &&
+       (slot[0].low == bench_ow->tim_table[OW_SPEED_STD].rst);
+
+  /* Device arrived: reset with presence, then Skip ROM and Convert T */
+  ow_sim_ds18b20(ow_sim_slave_add(bench_bus, 0x28, 1), 0);
+  OW_SIM(err = ow_xfer(bench_ow, 0x44, NULL, 0, 0));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait();
+  cnt = ow_trace_read(bench_ow, trace, OW_TRACE_LEN);
+  slots = ow_trace_decode(trace, cnt, slot, 24);
+  ok = ok && (slots == 17) && (slot[0].type == OW_TRACE_SLOT_RESET) && (slot[0].bit == 0);
+  for (uint16_t i = 1; ok && (i < slots); i++)
+  {
+    uint8_t byte = (i <= 8) ? 0xCC : 0x44;
+    ok = (slot[i].type == OW_TRACE_SLOT_WRITE) &&
+         ((slot[i].bit == ((byte >> ((i - 1) % 8)) & 1)) || (slot[i].bit == OW_TRACE_BIT_NONE));
+  }
+  return bench_report("trace", 1, ok, t0, isr0);
+}
+#endif
+
+#if (OW_RETRY == 1)
+/*************************************************************************************************/
+static bool bench_retry(void)
+{
+  bool ok;
+  ow_stats_t stats;
+  bench_setup();
+  ow_sim_ds18b20(ow_sim_slave_add(bench_bus, 0x28, 1), 0x191);
+  bench_init();
+  ok = (ow_set_retry(bench_ow, OW_CHECK_CRC8, 2, 100) == OW_ERR_NONE);
+
+  /* Noise holds the bus low during the first scratchpad read, second attempt is clean */
+  uint8_t scratch[9];
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  ow_err_t err;
+  ow_sim_glitch_from = t0 + OW_SIM_US(3000);
+  ow_sim_glitch_until = ow_sim_glitch_from + OW_SIM_US(300);
+  OW_SIM(err = ow_xfer(bench_ow, 0xBE, NULL, 0, 9));
+  ok = ok && (err == OW_ERR_NONE) && bench_wait();
+  ok = ok && (ow_read_resp(bench_ow, scratch, sizeof(scratch)) == 9) && (ow_resp_crc(bench_ow) == 0);
+  ok = ok && (scratch[0] == 0x91) && (scratch[1] == 0x01);
+  ow_stats(bench_ow, &stats, false);
+  ok = ok && (stats.retry == 1) && (stats.xfer == 1);
+  return bench_report("retry", 1, ok, t0, isr0);
+}
+#endif
+
+#if (OW_QUEUE_LEN > 0)
+/*************************************************************************************************/
+static bool bench_queue(void)
+{
+  bool ok;
+  int jobs = (OW_QUEUE_LEN < BENCH_DEV) ? OW_QUEUE_LEN : BENCH_DEV;
+  bench_setup();
+  for (int i = 0; i < BENCH_DEV; i++)
+  {
+    ow_sim_ds18b20(ow_sim_slave_add(bench_bus, 0x28, 0x300 + (uint64_t)i), (int16_t)(100 + 5 * i));
+  }
+  bench_init();
+  OW_SIM(ow_update_rom_id(bench_ow));
+  ok = bench_wait() && (ow_devices(bench_ow) == BENCH_DEV);
+  bench_jobs = 0;
+  bench_jobs_ok = true;
+  bench_clear();
+
+  /* First job starts at once, the others chain from ISR without the caller */
+  uint64_t t0 = ow_sim_now;
+  uint64_t isr0 = ow_sim_isr;
+  for (uint8_t i = 0; i < jobs; i++)
+  {
+    ow_err_t err;
+    OW_SIM(err = ow_queue_xfer_by_id(bench_ow, i, 0xBE, NULL, 0, 9, bench_job_cb, bench_slave(i)));
+    ok = ok && (err == OW_ERR_NONE);
+  }
+  ok = ok && (ow_queue_count(bench_ow) == jobs - 1) && bench_wait();
+  ok = ok && (bench_jobs == jobs) && bench_jobs_ok && (ow_queue_count(bench_ow) == 0);
+  return bench_report("queue", jobs, ok, t0, isr0);
+}
+#endif
+
+#if ((OW_TIM_SHARED == 1) && (OW_BENCH_HPP == 0))
+/*************************************************************************************************/
+static bool bench_shared(void)
+{
+  bool ok = true;
+  int bus[BENCH_SHARED_BUS];
+  ow_sim_reset();
+  bench_tim_reg.ARR = 0xFFFF;
+  for (int i = 0; i < BENCH_SHARED_BUS; i++)
+  {
+#if (OW_DUAL_PINS == 1)
+    bus[i] = ow_sim_bus_add_dual(bench_shared_gpio[i % 3], (uint16_t)(1U << (4 + 2 * i)), bench_shared_gpio[i % 3],
+                                 (uint16_t)(2U << (4 + 2 * i)), OW_INVERT_TX == 1, OW_INVERT_RX == 1);
+#else
+    bus[i] = ow_sim_bus_add(bench_shared_gpio[i % 3], (uint16_t)(1U << (4 + i)));
+#endif
+  }
+
+  /* Searches on CH1 and CH2 run over several counter wraps, reads and converts end between them */
+  int first[BENCH_SHARED_BUS] = {0};
+  first[0] = ow_sim_rom_bulk(bus[0], 0x28, BENCH_DEV, 0x5A0);
+  ow_sim_slave_t *ds18 = ow_sim_slave_add(bus[1], 0x28, 0x5A1);
+  ow_sim_ds18b20(ds18, 0x155);
+  ow_sim_slave_t *ds24 = ow_sim_slave_add(bus[2], 0x2D, 0x5A2);
+  ow_sim_ds2431(ds24);
+  for (int i = 0; i < (int)sizeof(ds24->mem); i++)
+  {
+    ds24->mem[i] = (uint8_t)(i * 5 + 2);
+  }
+  first[3] = ow_sim_rom_bulk(bus[3], 0x28, BENCH_DEV, 0x5A3);
+  ow_sim_slave_t *ds18_ch2 = ow_sim_slave_add(bus[4], 0x28, 0x5A4);
+  ow_sim_ds18b20(ds18_ch2, -0x37);
+  ow_sim_slave_t *ds18_ch3 = ow_sim_slave_add(bus[5], 0x28, 0x5A5);
+  ow_sim_ds18b20(ds18_ch3, 0x2A0);
+
+  memset(bench_shared_list, 0, sizeof(bench_shared_list));
+  for (int i = 0; i < BENCH_SHARED_BUS; i++)
+  {
+    ow_init_t init;
+    memset(&init, 0, sizeof(init));
+    init.tim_handle = &bench_tim;
+    init.tim_cb = bench_shared_cb;
+#if (OW_DUAL_PINS == 1)
+    init.gpio_tx = bench_shared_gpio[i % 3];
+    init.pin_tx = (uint16_t)(1U << (4 + 2 * i));
+    init.gpio_rx = bench_shared_gpio[i % 3];
+    init.pin_rx = (uint16_t)(2U << (4 + 2 * i));
+#else
+    init.gpio = bench_shared_gpio[i % 3];
+    init.pin = (uint16_t)(1U << (4 + i));
+#endif
+    /* CH3 bus alone, without a list of its own */
+    init.tim_ch = bench_shared_ch[i];
+    init.tim_list = (bench_shared_ch[i] == TIM_CHANNEL_3) ? NULL : &bench_shared_list[bench_shared_ch[i] >> 2];
+    OW_SIM(ow_init(&bench_shared_ow[i], &init));
+  }
+
+  /* Started together, CH3 stops after its convert while CH1 and CH2 run on */
+  static const uint8_t addr[2] = { 0x00, 0x00 };
+  static uint8_t mem[BENCH_MEM_LEN];
+  uint8_t scratch[9];
+  ow_err_t err[BENCH_SHARED_BUS];
+  uint64_t t0 = ow_sim_now;
+  OW_SIM(err[1] = ow_xfer(&bench_shared_ow[1], 0xBE, NULL, 0, 9));
+  OW_SIM(err[2] = ow_xfer_buf(&bench_shared_ow[2], 0xF0, addr, sizeof(addr), mem, sizeof(mem)));
+  OW_SIM(err[4] = ow_xfer(&bench_shared_ow[4], 0xBE, NULL, 0, 9));
+  OW_SIM(err[5] = ow_xfer(&bench_shared_ow[5], 0x44, NULL, 0, 0));
+
+  /* Searches 1 us later fall due while the reads of their channel are served, by generated event */
+  ow_sim_now += OW_SIM_US(1);
+  OW_SIM(err[0] = ow_update_rom_id(&bench_shared_ow[0]));
+  OW_SIM(err[3] = ow_update_rom_id(&bench_shared_ow[3]));
+  for (int i = 0; i < BENCH_SHARED_BUS; i++)
+  {
+    ok = ok && (err[i] == OW_ERR_NONE);
+  }
+  ok = ok && (ow_sim_run(OW_SIM_US(5000)) == 1) && (ds18_ch3->fn_cmd == 0x44) && !ow_is_busy(&bench_shared_ow[5]);
+  ok = ok && ow_is_busy(&bench_shared_ow[0]) && ow_is_busy(&bench_shared_ow[3]);
+  ok = ok && ((bench_tim.ch_running & 0x07) == 0x03);
+
+  /* Read of CH1 done, its next read joins the running searches */
+  ok = ok && (ow_sim_run(OW_SIM_US(15000)) == 1) && !ow_is_busy(&bench_shared_ow[1]);
+  ok = ok && (ow_read_resp(&bench_shared_ow[1], scratch, sizeof(scratch)) == 9) && (ow_resp_crc(&bench_shared_ow[1]) == 0);
+  ok = ok && ((int16_t)(scratch[0] | (scratch[1] << 8)) == ds18->temp);
+  OW_SIM(err[1] = ow_xfer(&bench_shared_ow[1], 0xBE, NULL, 0, 9));
+  OW_SIM(err[5] = ow_xfer(&bench_shared_ow[5], 0xBE, NULL, 0, 9));
+  ok = ok && (err[1] == OW_ERR_NONE) && (err[5] == OW_ERR_NONE) && (ow_sim_run(BENCH_TIMEOUT) == 0);
+
+  /* Every result checked */
+  for (int i = 0; i < BENCH_SHARED_BUS; i++)
+  {
+    ok = ok && (ow_last_error(&bench_shared_ow[i]) == OW_ERR_NONE);
+  }
+  for (int b = 0; b < BENCH_SHARED_BUS; b += 3)
+  {
+    ok = ok && (ow_devices(&bench_shared_ow[b]) == BENCH_DEV);
+    for (int i = 0; ok && (i < BENCH_DEV); i++)
+    {
+      bool found = false;
+      for (int k = first[b]; !found && (k < first[b] + BENCH_DEV); k++)
+      {
+        found = (memcmp(bench_shared_ow[b].rom_id[i].array, ow_sim_slave_get(k)->rom, 8) == 0);
+      }
+      ok = found;
+    }
+  }
+  ok = ok && (memcmp(mem, ds24->mem, sizeof(mem)) == 0);
+  const int read_bus[3] = { 1, 4, 5 };
+  ow_sim_slave_t *const read_dev[3] = { ds18, ds18_ch2, ds18_ch3 };
+  for (int i = 0; i < 3; i++)
+  {
+    ow_t *ow = &bench_shared_ow[read_bus[i]];
+    ok = ok && (ow_read_resp(ow, scratch, sizeof(scratch)) == 9) && (ow_resp_crc(ow) == 0);
+    ok = ok && ((int16_t)(scratch[0] | (scratch[1] << 8)) == read_dev[i]->temp);
+  }
+  ok = ok && (bench_tim.ch_running == 0);
+
+  ow_t *ow[BENCH_SHARED_BUS];
+  for (int i = 0; i < BENCH_SHARED_BUS; i++)
+  {
+    ow[i] = &bench_shared_ow[i];
+  }
+  return bench_shared_report("shared timer", ow, BENCH_SHARED_BUS, ok, t0);
+}
+#elif (OW_TIM_SHARED == 1)
+/*************************************************************************************************/
+static bool bench_shared(void)
+{
+  bool ok = true;
+  int binds = BENCH_SHARED_BIND;
+  int bus[BENCH_SHARED_BIND];
+  ow_t *ow[BENCH_SHARED_BIND];
+  ow_sim_reset();
+  bench_tim_reg.ARR = 0xFFFF;
+  for (int i = 0; i < binds; i++)
+  {
+    bus[i] = bench_hpp_shared_bus(i);
+  }
+
+  /* Search and scratchpad read on CH1, memory read on CH2 */
+  int first = ow_sim_rom_bulk(bus[0], 0x28, BENCH_DEV, 0x5B0);
+  ow_sim_slave_t *ds18 = ow_sim_slave_add(bus[1], 0x28, 0x5B1);
+  ow_sim_ds18b20(ds18, 0xF3);
+  ow_sim_slave_t *ds24 = ow_sim_slave_add(bus[2], 0x2D, 0x5B2);
+  ow_sim_ds2431(ds24);
+  for (int i = 0; i < (int)sizeof(ds24->mem); i++)
+  {
+    ds24->mem[i] = (uint8_t)(i * 9 + 4);
+  }
+  for (int i = 0; i < binds; i++)
+  {
+    OW_SIM(ow[i] = bench_hpp_shared_init(i));
+  }
+
+  /* Started together, the scratchpad read ends while the others run on */
+  static const uint8_t addr[2] = { 0x00, 0x00 };
+  static uint8_t mem[BENCH_MEM_LEN];
+  uint8_t scratch[9];
+  ow_err_t err[BENCH_SHARED_BIND];
+  uint64_t t0 = ow_sim_now;
+  OW_SIM(err[0] = ow_update_rom_id(ow[0]));
+  OW_SIM(err[1] = ow_xfer(ow[1], 0xBE, NULL, 0, 9));
+  OW_SIM(err[2] = ow_xfer_buf(ow[2], 0xF0, addr, sizeof(addr), mem, sizeof(mem)));
+  ok = (bench_hpp_shared_count() == BENCH_SHARED_BIND);
+  ok = ok && (err[0] == OW_ERR_NONE) && (err[1] == OW_ERR_NONE) && (err[2] == OW_ERR_NONE);
+  ok = ok && (ow_sim_run(OW_SIM_US(15000)) == 1) && !ow_is_busy(ow[1]) && ow_is_busy(ow[0]) && ow_is_busy(ow[2]);
+  ok = ok && (ow_sim_run(BENCH_TIMEOUT) == 0);
+
+  /* Every result checked */
+  for (int i = 0; i < binds; i++)
+  {
+    ok = ok && (ow_last_error(ow[i]) == OW_ERR_NONE);
+  }
+  ok = ok && (ow_devices(ow[0]) == BENCH_DEV);
+  for (int i = 0; ok && (i < BENCH_DEV); i++)
+  {
+    bool found = false;
+    for (int k = first; !found && (k < first + BENCH_DEV); k++)
+    {
+      found = (memcmp(ow[0]->rom_id[i].array, ow_sim_slave_get(k)->rom, 8) == 0);
+    }
+    ok = found;
+  }
+  ok = ok && (ow_read_resp(ow[1], scratch, sizeof(scratch)) == 9) && (ow_resp_crc(ow[1]) == 0);
+  ok = ok && ((int16_t)(scratch[0] | (scratch[1] << 8)) == ds18->temp);
+  ok = ok && (memcmp(mem, ds24->mem, sizeof(mem)) == 0);
+  ok = ok && (bench_tim.ch_running == 0);
+  return bench_shared_report("shared bindings", ow, binds, ok, t0);
+}
+#endif
+
+#if (OW_TIM_SHARED == 1)
+/*************************************************************************************************/
+static bool bench_shared_report(const char *name, ow_t *const *ow, int buses, bool ok, uint64_t t0)
+{
+  /* Sum of all buses, one timer interrupt may serve buses due at the same time */
+  ow_stats_t stats;
+  uint32_t isr_cnt = 0;
+  uint64_t isr_cyc = 0;
+  uint32_t isr_max = 0;
+  for (int i = 0; i < buses; i++)
+  {
+    ow_stats(ow[i], &stats, true);
+    isr_cnt += stats.isr_cnt;
+    isr_cyc += stats.isr_cyc_sum;
+    isr_max = (stats.isr_cyc_max > isr_max) ? stats.isr_cyc_max : isr_max;
+  }
+  printf("%-22s %5d %6s %8lu %12llu %12llu %10lu %10lu\n", name, buses, ok ? "ok" : "FAIL",
+         (unsigned long)isr_cnt, (unsigned long long)((ow_sim_now - t0) / OW_SIM_US(1)),
+         (unsigned long long)isr_cyc, (unsigned long)(isr_cyc / (isr_cnt ? isr_cnt : 1)), (unsigned long)isr_max);
+  return ok;
+}
+#endif
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
@@ -0,0 +1,77 @@
+
+/*
+ * @file        ow_bench.h
+ * @brief       Host benchmark: bus bindings of ow.hpp run by ow_bench.c
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+#ifndef _OW_BENCH_H_
+#define _OW_BENCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "ow.h"
+#include "ow_sim.h"
+
+/*************************************************************************************************/
+/** Variables **/
+/*************************************************************************************************/
+
+/* Timer or UART of all scenarios, one binding runs at a time except in the shared timer scenario */
+#if (OW_BACKEND == OW_BACKEND_UART)
+extern UART_HandleTypeDef bench_uart;
+#else
+extern TIM_HandleTypeDef bench_tim;
+#endif
+
+/*************************************************************************************************/
+/** API Functions **/
+/*************************************************************************************************/
+
+/* Bindings of ow_bench_hpp.cpp, each one runs all scenarios (ow_bench built with OW_BENCH_HPP = 1) */
+int         bench_hpp_count(void);
+const char *bench_hpp_name(int bind);
+
+/* Binding of dual pins, strong pull-up is refused */
+bool        bench_hpp_dual(int bind);
+
+/* Add simulated bus of binding after ow_sim_reset(), return its index */
+int         bench_hpp_bus(int bind);
+
+/* Init binding after the slaves are added, return its handle */
+ow_t       *bench_hpp_init(int bind);
+
+#if (OW_TIM_SHARED == 1)
+/* Bindings on one shared timer, run together: count, simulated bus and init as above */
+int         bench_hpp_shared_count(void);
+int         bench_hpp_shared_bus(int bind);
+ow_t       *bench_hpp_shared_init(int bind);
+#endif
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _OW_BENCH_H_ */
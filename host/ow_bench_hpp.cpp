@@ -0,0 +1,184 @@
+
+/*
+ * @file        ow_bench_hpp.cpp
+ * @brief       Host benchmark: bus bindings of ow.hpp, the scenarios of ow_bench.c run on each one
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "ow.hpp"
+#include "ow_bench.h"
+
+/*************************************************************************************************/
+/** Private Typedef/Struct/Enum **/
+/*************************************************************************************************/
+
+#if (OW_BACKEND == OW_BACKEND_UART)
+/* Half-duplex UART */
+using Uart = ow::Bus<bench_uart>;
+#else
+/* Open-drain pin, the ISR of ow.hpp writes and reads PA0 by constant address */
+using Od = ow::Bus<ow::OpenDrain<GPIOA_BASE, GPIO_PIN_0>, bench_tim, TIM_CHANNEL_1>;
+#if (OW_TIM_HW == 0)
+/* Isolated TX/RX pins, both inverted, in the same image whatever OW_DUAL_PINS and OW_INVERT_TX/RX are */
+using Iso = ow::Bus<ow::DualPin<GPIOA_BASE, GPIO_PIN_2, GPIOA_BASE, GPIO_PIN_3, true, true>, bench_tim, TIM_CHANNEL_1>;
+#endif
+#if (OW_TIM_SHARED == 1)
+/* Bindings on bench_tim with Od, one more on CH1 and one on CH2, each on its own port */
+using ShB = ow::Bus<ow::OpenDrain<GPIOB_BASE, GPIO_PIN_1>, bench_tim, TIM_CHANNEL_1>;
+using ShC = ow::Bus<ow::OpenDrain<GPIOC_BASE, GPIO_PIN_2>, bench_tim, TIM_CHANNEL_2>;
+#endif
+#endif
+
+/* One binding, with the simulated bus it is wired to */
+typedef struct
+{
+  const char                *name;
+  bool                      dual;
+  int                       (*bus)(void);
+  ow_t                      *(*init)(void);
+
+} bench_bind_t;
+
+/*************************************************************************************************/
+/** Private Function Implementations **/
+/*************************************************************************************************/
+
+/* Init a binding with its own ROM ID table, return its handle */
+template <typename Bind>
+static ow_t *bench_hpp_start(void)
+{
+#if (OW_ROM_TABLE == 1)
+  static ow_id_t rom_id[OW_MAX_DEVICE];
+  Bind::rom_table(rom_id);
+#endif
+  Bind::init();
+  return Bind::handle();
+}
+
+/*************************************************************************************************/
+static int bench_hpp_bus_a0(void)
+{
+  return ow_sim_bus_add(GPIOA, GPIO_PIN_0);
+}
+
+#if ((OW_BACKEND == OW_BACKEND_TIM) && (OW_TIM_HW == 0))
+/*************************************************************************************************/
+static int bench_hpp_bus_a2_a3(void)
+{
+  return ow_sim_bus_add_dual(GPIOA, GPIO_PIN_2, GPIOA, GPIO_PIN_3, true, true);
+}
+#endif
+
+#if (OW_TIM_SHARED == 1)
+/*************************************************************************************************/
+static int bench_hpp_bus_b1(void)
+{
+  return ow_sim_bus_add(GPIOB, GPIO_PIN_1);
+}
+
+/*************************************************************************************************/
+static int bench_hpp_bus_c2(void)
+{
+  return ow_sim_bus_add(GPIOC, GPIO_PIN_2);
+}
+#endif
+
+/*************************************************************************************************/
+/** Private Variables **/
+/*************************************************************************************************/
+
+static const bench_bind_t bench_binds[] =
+{
+#if (OW_BACKEND == OW_BACKEND_UART)
+  { "ow::Bus<bench_uart>", false, bench_hpp_bus_a0, bench_hpp_start<Uart> },
+#else
+  { "ow::Bus<ow::OpenDrain<PA0>>", false, bench_hpp_bus_a0, bench_hpp_start<Od> },
+#if (OW_TIM_HW == 0)
+  { "ow::Bus<ow::DualPin<PA2, PA3, true, true>>", true, bench_hpp_bus_a2_a3, bench_hpp_start<Iso> },
+#endif
+#endif
+};
+
+#if (OW_TIM_SHARED == 1)
+/* Bindings running together on bench_tim */
+static const bench_bind_t bench_shared_binds[] =
+{
+  { "ow::Bus<ow::OpenDrain<PA0>, CH1>", false, bench_hpp_bus_a0, bench_hpp_start<Od> },
+  { "ow::Bus<ow::OpenDrain<PB1>, CH1>", false, bench_hpp_bus_b1, bench_hpp_start<ShB> },
+  { "ow::Bus<ow::OpenDrain<PC2>, CH2>", false, bench_hpp_bus_c2, bench_hpp_start<ShC> },
+};
+#endif
+
+/*************************************************************************************************/
+/** Function Implementations **/
+/*************************************************************************************************/
+
+int bench_hpp_count(void)
+{
+  return static_cast<int>(sizeof(bench_binds) / sizeof(bench_binds[0]));
+}
+
+/*************************************************************************************************/
+const char *bench_hpp_name(int bind)
+{
+  return bench_binds[bind].name;
+}
+
+/*************************************************************************************************/
+bool bench_hpp_dual(int bind)
+{
+  return bench_binds[bind].dual;
+}
+
+/*************************************************************************************************/
+int bench_hpp_bus(int bind)
+{
+  return bench_binds[bind].bus();
+}
+
+/*************************************************************************************************/
+ow_t *bench_hpp_init(int bind)
+{
+  return bench_binds[bind].init();
+}
+
+#if (OW_TIM_SHARED == 1)
+/*************************************************************************************************/
+int bench_hpp_shared_count(void)
+{
+  return static_cast<int>(sizeof(bench_shared_binds) / sizeof(bench_shared_binds[0]));
+}
+
+/*************************************************************************************************/
+int bench_hpp_shared_bus(int bind)
+{
+  return bench_shared_binds[bind].bus();
+}
+
+/*************************************************************************************************/
+ow_t *bench_hpp_shared_init(int bind)
+{
+  return bench_shared_binds[bind].init();
+}
+#endif
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
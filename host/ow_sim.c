@@ -0,0 +1,1315 @@
+
+/*
+ * @file        ow_sim.c
+ * @brief       Host simulator of OneWire buses, timers and slaves
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L
+#define _DEFAULT_SOURCE
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "ow_sim.h"
+
+/*************************************************************************************************/
+/** Private Defines **/
+/*************************************************************************************************/
+
+/* Max timers of one simulation */
+#define OW_SIM_MAX_TIM            4
+
+/* UART kernel clock, BRR = clock / baudrate */
+#define OW_SIM_PCLK               170000000UL
+
+/* Slave state */
+#define OW_SIM_ST_IDLE            0
+#define OW_SIM_ST_RX              1
+#define OW_SIM_ST_TX              2
+#define OW_SIM_ST_SEARCH          3
+
+/* Slave command layer */
+#define OW_SIM_LAYER_ROM          0
+#define OW_SIM_LAYER_MATCH        1
+#define OW_SIM_LAYER_FUNC         2
+#define OW_SIM_LAYER_DEV          3
+
+/*************************************************************************************************/
+/** Private Typedef **/
+/*************************************************************************************************/
+
+/* One bus, open-drain or dual pins */
+typedef struct
+{
+  GPIO_TypeDef              *gpio;                 /* TX (or open-drain) port */
+  uint16_t                  pin;
+  GPIO_TypeDef              *gpio_rx;              /* RX port of dual pins */
+  uint16_t                  pin_rx;
+  bool                      dual;
+  bool                      inv_tx;
+  bool                      inv_rx;
+  bool                      master_low;            /* Driver pulls bus low */
+
+} ow_sim_bus_t;
+
+/* One timer, free running or restarted by the driver */
+typedef struct
+{
+  TIM_HandleTypeDef         *htim;
+  uint64_t                  start;                 /* Time of counter 0 of update timer */
+  uint64_t                  next;                  /* Time of next update event */
+  uint64_t                  base;                  /* Time of counter 0 of compare channels */
+  uint64_t                  ch_next[4];            /* Time of next compare event per channel */
+  uint32_t                  ch_ccr[4];             /* Compare value of ch_next per channel */
+  uint32_t                  ch_gen;                /* Compare events generated now, one bit per channel */
+  bool                      oc;                    /* Compare channel started once, counter runs free */
+  int                       pwm;                   /* PWM channel + 1, 0 == none (OW_TIM_HW) */
+  int                       ic;                    /* Input capture channel index */
+  bool                      ug;                    /* Update event generated in running callback */
+  uint32_t                  sh_arr;                /* Preloaded (shadow) period of running slot */
+  uint32_t                  sh_ccr;                /* Preloaded (shadow) low time of running slot */
+  uint16_t                  *dma;                  /* Capture DMA target */
+  int                       dma_len;
+  int                       dma_pos;
+  bool                      dma_on;
+  bool                      cc_on;                 /* Input capture enabled */
+  uint64_t                  cc_t;                  /* Time of last captured edge */
+
+} ow_sim_tim_t;
+
+/*************************************************************************************************/
+/** Private Function prototype **/
+/*************************************************************************************************/
+
+/* Timer state of a handle, added at first use */
+static ow_sim_tim_t *ow_sim_tim(TIM_HandleTypeDef *htim);
+
+/* Timer counter at a time */
+static uint32_t ow_sim_tim_cnt(ow_sim_tim_t *tim, uint64_t t);
+
+/* Arm compare event of a channel after a reference time */
+static void ow_sim_tim_arm(ow_sim_tim_t *tim, int ch, uint64_t ref, uint32_t ref_cnt);
+
+/* One hardware slot on the PWM pin, captures rising edges or both edges (OW_TIM_HW) */
+static void ow_sim_pwm_slot(ow_sim_tim_t *tim, uint64_t ev);
+
+/* Capture one edge of a slot, into DMA if its request is enabled */
+static void ow_sim_pwm_cap(ow_sim_tim_t *tim, uint64_t ev, uint64_t t);
+
+/* Bus level at a time, true == high */
+static bool ow_sim_level(int bus, uint64_t t);
+
+/* Drive IDR of all ports from bus levels */
+static void ow_sim_idr(void);
+
+/* Apply BSRR of a port to its buses */
+static void ow_sim_bsrr(GPIO_TypeDef *gpio);
+
+/* Bus edges seen by the slaves of a bus */
+static void ow_sim_bus_edge(int bus, bool low);
+
+/* Slave protocol */
+static void ow_sim_slave_fall(ow_sim_slave_t *slave, uint64_t t);
+static void ow_sim_slave_rise(ow_sim_slave_t *slave, uint64_t t);
+static void ow_sim_slave_rom(ow_sim_slave_t *slave, uint8_t rom_cmd);
+static void ow_sim_slave_rx_done(ow_sim_slave_t *slave);
+
+/*************************************************************************************************/
+/** Variables **/
+/*************************************************************************************************/
+
+uint64_t ow_sim_now;
+uint64_t ow_sim_isr;
+uint32_t ow_sim_lat;
+uint64_t ow_sim_glitch_from;
+uint64_t ow_sim_glitch_until;
+uint64_t ow_sim_pullup_on;
+uint64_t ow_sim_pullup_off;
+uint32_t ow_sim_pullup_cnt;
+
+/*************************************************************************************************/
+/** Private Variables **/
+/*************************************************************************************************/
+
+static ow_sim_bus_t ow_sim_buses[OW_SIM_MAX_BUS];
+static int ow_sim_bus_cnt;
+static ow_sim_slave_t *ow_sim_slaves[OW_SIM_MAX_SLAVE];
+static int ow_sim_slave_cnt;
+static ow_sim_tim_t ow_sim_tims[OW_SIM_MAX_TIM];
+static int ow_sim_tim_num;
+static int ow_sim_hw_bus;
+static uint32_t ow_sim_primask;
+
+/* Simulated ports, sampled and driven by ow_sim_pre/post() */
+static GPIO_TypeDef *const ow_sim_ports[] = { GPIOA, GPIOB, GPIOC };
+
+/* Capture DMA of each timer channel, linked as by CubeMX MspInit */
+static DMA_HandleTypeDef ow_sim_dma[OW_SIM_MAX_TIM][4];
+
+/*************************************************************************************************/
+/** Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/** Simulation **/
+/*************************************************************************************************/
+
+void ow_sim_reset(void)
+{
+  static bool mapped;
+  if (!mapped)
+  {
+    /* Host page at the port addresses, as GPIOx_BASE on target */
+    void *page = (void *)(GPIOA_BASE & ~0xFFFFUL);
+    mapped = (mmap(page, 0x10000, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == page);
+    assert(mapped);
+  }
+  for (int i = 0; i < ow_sim_slave_cnt; i++)
+  {
+    free(ow_sim_slaves[i]);
+  }
+  ow_sim_slave_cnt = 0;
+  ow_sim_bus_cnt = 0;
+  ow_sim_tim_num = 0;
+  ow_sim_hw_bus = 0;
+  ow_sim_now = 0;
+  ow_sim_isr = 0;
+  ow_sim_lat = 0;
+  ow_sim_glitch_from = 0;
+  ow_sim_glitch_until = 0;
+  memset(ow_sim_tims, 0, sizeof(ow_sim_tims));
+  for (size_t i = 0; i < sizeof(ow_sim_ports) / sizeof(ow_sim_ports[0]); i++)
+  {
+    memset(ow_sim_ports[i], 0, sizeof(GPIO_TypeDef));
+    ow_sim_ports[i]->ODR = 0xFFFF;
+  }
+}
+
+/*************************************************************************************************/
+int ow_sim_bus_add(GPIO_TypeDef *gpio, uint16_t pin)
+{
+  assert(ow_sim_bus_cnt < OW_SIM_MAX_BUS);
+  ow_sim_bus_t *bus = &ow_sim_buses[ow_sim_bus_cnt];
+  memset(bus, 0, sizeof(ow_sim_bus_t));
+  bus->gpio = gpio;
+  bus->pin = pin;
+  return ow_sim_bus_cnt++;
+}
+
+/*************************************************************************************************/
+int ow_sim_bus_add_dual(GPIO_TypeDef *gpio_tx, uint16_t pin_tx, GPIO_TypeDef *gpio_rx,
+                        uint16_t pin_rx, bool inv_tx, bool inv_rx)
+{
+  int idx = ow_sim_bus_add(gpio_tx, pin_tx);
+  ow_sim_bus_t *bus = &ow_sim_buses[idx];
+  bus->gpio_rx = gpio_rx;
+  bus->pin_rx = pin_rx;
+  bus->dual = true;
+  bus->inv_tx = inv_tx;
+  bus->inv_rx = inv_rx;
+
+  /* TX at released level before init */
+  if (inv_tx)
+  {
+    gpio_tx->ODR |= pin_tx;
+  }
+  else
+  {
+    gpio_tx->ODR &= ~(uint32_t)pin_tx;
+  }
+  return idx;
+}
+
+/*************************************************************************************************/
+void ow_sim_bus_hw(int bus)
+{
+  ow_sim_hw_bus = bus;
+}
+
+/*************************************************************************************************/
+ow_sim_slave_t *ow_sim_slave_add(int bus, uint8_t family, uint64_t serial)
+{
+  assert(ow_sim_slave_cnt < OW_SIM_MAX_SLAVE);
+  ow_sim_slave_t *slave = calloc(1, sizeof(ow_sim_slave_t));
+  assert(slave != NULL);
+  slave->bus = bus;
+  slave->present = true;
+  slave->rom[0] = family;
+  for (int i = 0; i < 6; i++)
+  {
+    slave->rom[1 + i] = (uint8_t)(serial >> (8 * i));
+  }
+  slave->rom[7] = ow_sim_crc8(slave->rom, 7);
+  slave->state = OW_SIM_ST_IDLE;
+  ow_sim_slaves[ow_sim_slave_cnt++] = slave;
+  return slave;
+}
+
+/*************************************************************************************************/
+void ow_sim_slave_remove(ow_sim_slave_t *slave)
+{
+  slave->present = false;
+}
+
+/*************************************************************************************************/
+int ow_sim_slave_count(void)
+{
+  return ow_sim_slave_cnt;
+}
+
+/*************************************************************************************************/
+ow_sim_slave_t *ow_sim_slave_get(int index)
+{
+  return ow_sim_slaves[index];
+}
+
+/*************************************************************************************************/
+void ow_sim_slave_rx(ow_sim_slave_t *slave, int len)
+{
+  slave->state = OW_SIM_ST_RX;
+  slave->rx_need = len;
+  slave->rx_len = 0;
+  slave->rx_bits = 0;
+  slave->rx_byte = 0;
+}
+
+/*************************************************************************************************/
+void ow_sim_slave_tx(ow_sim_slave_t *slave, const uint8_t *data, int len)
+{
+  slave->state = OW_SIM_ST_TX;
+  memcpy(slave->tx_buf, data, (size_t)len);
+  slave->tx_len = len;
+  slave->tx_pos = 0;
+  slave->tx_bit = 0;
+  slave->poll = NULL;
+}
+
+/*************************************************************************************************/
+void ow_sim_slave_poll(ow_sim_slave_t *slave, int (*poll)(ow_sim_slave_t *slave, uint64_t t))
+{
+  slave->state = OW_SIM_ST_TX;
+  slave->tx_len = 0;
+  slave->tx_pos = 0;
+  slave->tx_bit = 0;
+  slave->poll = poll;
+}
+
+/*************************************************************************************************/
+void ow_sim_slave_idle(ow_sim_slave_t *slave)
+{
+  slave->state = OW_SIM_ST_IDLE;
+}
+
+/*************************************************************************************************/
+void ow_sim_pre(void)
+{
+  for (int i = 0; i < ow_sim_tim_num; i++)
+  {
+    ow_sim_tims[i].htim->Instance->CNT = ow_sim_tim_cnt(&ow_sim_tims[i], ow_sim_now);
+  }
+  ow_sim_idr();
+}
+
+/*************************************************************************************************/
+void ow_sim_post(void)
+{
+  /* Compare value written while the channel runs, matches when the counter reaches it */
+  for (int i = 0; i < ow_sim_tim_num; i++)
+  {
+    ow_sim_tim_t *tim = &ow_sim_tims[i];
+    for (int c = 0; c < 4; c++)
+    {
+      if ((tim->htim->ch_running & (1UL << c)) && (*(&tim->htim->Instance->CCR1 + c) != tim->ch_ccr[c]))
+      {
+        ow_sim_tim_arm(tim, c, ow_sim_now, ow_sim_tim_cnt(tim, ow_sim_now));
+      }
+    }
+  }
+  for (size_t i = 0; i < sizeof(ow_sim_ports) / sizeof(ow_sim_ports[0]); i++)
+  {
+    ow_sim_bsrr(ow_sim_ports[i]);
+  }
+}
+
+/*************************************************************************************************/
+int ow_sim_run(uint64_t max_ticks)
+{
+  uint64_t end = ow_sim_now + max_ticks;
+  for (;;)
+  {
+    /* Earliest update or compare event of all timers */
+    ow_sim_tim_t *tim = NULL;
+    int ch = -1;
+    uint64_t ev = UINT64_MAX;
+    for (int i = 0; i < ow_sim_tim_num; i++)
+    {
+      ow_sim_tim_t *t = &ow_sim_tims[i];
+      if (t->htim->running && (t->next < ev))
+      {
+        ev = t->next;
+        tim = t;
+        ch = -1;
+      }
+      for (int c = 0; c < 4; c++)
+      {
+        /* Generated event is pending at once, compare event stays armed */
+        uint64_t ch_ev = (t->ch_gen & (1UL << c)) ? ow_sim_now : t->ch_next[c];
+        if ((t->htim->ch_running & (1UL << c)) && (ch_ev < ev))
+        {
+          ev = ch_ev;
+          tim = t;
+          ch = c;
+        }
+      }
+    }
+    if (tim == NULL)
+    {
+      return 0;
+    }
+    if (ev > end)
+    {
+      return 1;
+    }
+    if (ow_sim_now < ev + ow_sim_lat)
+    {
+      ow_sim_now = ev + ow_sim_lat;
+    }
+    ow_sim_isr++;
+
+    if ((ch < 0) && tim->pwm)
+    {
+      /* Slot of preloaded period and low time, next one loaded by callback */
+      tim->start = ev;
+      tim->ug = false;
+      tim->sh_arr = tim->htim->Instance->ARR;
+      tim->sh_ccr = *(&tim->htim->Instance->CCR1 + (tim->pwm - 1));
+      ow_sim_pre();
+      tim->htim->PeriodElapsedCallback(tim->htim);
+      ow_sim_post();
+      if (!tim->ug)
+      {
+        ow_sim_pwm_slot(tim, ev);
+        if (tim->htim->running)
+        {
+          tim->next = ev + tim->sh_arr + 1;
+        }
+      }
+      if (ow_sim_now < ev)
+      {
+        ow_sim_now = ev;
+      }
+    }
+    else if (ch < 0)
+    {
+      tim->start = ev;
+      ow_sim_pre();
+      tim->htim->Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+      tim->htim->PeriodElapsedCallback(tim->htim);
+      ow_sim_post();
+      if (tim->htim->running)
+      {
+        /* Period written in callback, after a restart too */
+        tim->next = tim->start + tim->htim->Instance->ARR + 1;
+      }
+    }
+    else
+    {
+      /* Compare value not changed by callback matches again one period later */
+      bool gen = (tim->ch_gen & (1UL << ch)) != 0;
+      tim->ch_gen &= ~(1UL << ch);
+      uint64_t next = tim->ch_next[ch];
+      ow_sim_pre();
+      tim->htim->Channel = (HAL_TIM_ActiveChannel)(1 << ch);
+      tim->htim->OC_DelayElapsedCallback(tim->htim);
+      ow_sim_post();
+      if (!gen && (tim->htim->ch_running & (1UL << ch)) && (tim->ch_next[ch] == next))
+      {
+        ow_sim_tim_arm(tim, ch, ev, tim->ch_ccr[ch]);
+      }
+    }
+  }
+}
+
+/*************************************************************************************************/
+void ow_sim_uart_run(UART_HandleTypeDef *huart, int bus)
+{
+  double t = (double)ow_sim_now;
+  while (huart->pending)
+  {
+    huart->pending = false;
+    ow_sim_isr++;
+
+    /* One UART byte per slot: start bit and leading 0 bits pull the bus low */
+    double bit_t = (double)huart->Instance->BRR * OW_SIM_US(1) * 1e6 / OW_SIM_PCLK;
+    for (int i = 0; i < huart->len; i++)
+    {
+      uint8_t tx = huart->tx[i];
+      int low = 1;
+      while ((low < 9) && !((tx >> (low - 1)) & 1))
+      {
+        low++;
+      }
+      ow_sim_now = (uint64_t)t;
+      ow_sim_bus_edge(bus, true);
+      double rise = t + low * bit_t;
+      ow_sim_now = (uint64_t)rise;
+      ow_sim_bus_edge(bus, false);
+
+      /* Bus sampled in the middle of each data bit */
+      uint8_t rx = 0;
+      for (int k = 0; k < 8; k++)
+      {
+        double ts = t + (1.5 + k) * bit_t;
+        if ((ts >= rise) && ow_sim_level(bus, (uint64_t)ts))
+        {
+          rx |= (uint8_t)(1 << k);
+        }
+      }
+      huart->rx[i] = rx;
+      t += 10 * bit_t;
+    }
+    ow_sim_now = (uint64_t)t;
+    huart->RxCpltCallback(huart);
+  }
+}
+
+/*************************************************************************************************/
+uint8_t ow_sim_crc8(const uint8_t *data, int len)
+{
+  uint8_t crc = 0;
+  while (len--)
+  {
+    uint8_t byte = *data++;
+    for (int i = 0; i < 8; i++)
+    {
+      uint8_t mix = (crc ^ byte) & 1;
+      crc >>= 1;
+      if (mix)
+      {
+        crc ^= 0x8C;
+      }
+      byte >>= 1;
+    }
+  }
+  return crc;
+}
+
+/*************************************************************************************************/
+uint16_t ow_sim_crc16(uint16_t crc, const uint8_t *data, int len)
+{
+  while (len--)
+  {
+    crc ^= *data++;
+    for (int i = 0; i < 8; i++)
+    {
+      crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+    }
+  }
+  return crc;
+}
+
+/*************************************************************************************************/
+/** HAL Core **/
+/*************************************************************************************************/
+
+void HAL_GPIO_Init(GPIO_TypeDef *gpio, GPIO_InitTypeDef *init)
+{
+  (void)gpio;
+  if (init->Mode == GPIO_MODE_OUTPUT_PP)
+  {
+    ow_sim_pullup_on = ow_sim_now;
+    ow_sim_pullup_cnt++;
+  }
+  else
+  {
+    ow_sim_pullup_off = ow_sim_now;
+  }
+}
+
+/*************************************************************************************************/
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)(ow_sim_now / OW_SIM_US(1000));
+}
+
+/*************************************************************************************************/
+void __disable_irq(void)
+{
+  ow_sim_primask = 1;
+}
+
+/*************************************************************************************************/
+void __enable_irq(void)
+{
+  ow_sim_primask = 0;
+}
+
+/*************************************************************************************************/
+uint32_t __get_PRIMASK(void)
+{
+  return ow_sim_primask;
+}
+
+/*************************************************************************************************/
+void __set_PRIMASK(uint32_t primask)
+{
+  ow_sim_primask = primask;
+}
+
+/*************************************************************************************************/
+uint32_t ow_sim_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return (uint32_t)__builtin_ia32_rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+/*************************************************************************************************/
+/** HAL Timer **/
+/*************************************************************************************************/
+
+HAL_StatusTypeDef HAL_TIM_RegisterCallback(TIM_HandleTypeDef *htim, HAL_TIM_CallbackIDTypeDef id,
+                                           pTIM_CallbackTypeDef cb)
+{
+  ow_sim_tim(htim);
+  if (id == HAL_TIM_PERIOD_ELAPSED_CB_ID)
+  {
+    htim->PeriodElapsedCallback = cb;
+  }
+  else
+  {
+    htim->OC_DelayElapsedCallback = cb;
+  }
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+  ow_sim_tim_t *tim = ow_sim_tim(htim);
+  htim->running = 1;
+  if (tim->pwm == 0)
+  {
+    tim->start = ow_sim_now - htim->Instance->CNT;
+    tim->next = tim->start + htim->Instance->ARR + 1;
+  }
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim)
+{
+  htim->running = 0;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_TIM_OC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *config, uint32_t ch)
+{
+  (void)htim;
+  (void)config;
+  (void)ch;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_TIM_OC_Start_IT(TIM_HandleTypeDef *htim, uint32_t ch)
+{
+  ow_sim_tim_t *tim = ow_sim_tim(htim);
+  int c = (int)(ch >> 2);
+  if (!tim->oc)
+  {
+    tim->base = ow_sim_now - htim->Instance->CNT;
+    tim->oc = true;
+  }
+  htim->ch_running |= 1UL << c;
+  ow_sim_tim_arm(tim, c, ow_sim_now, ow_sim_tim_cnt(tim, ow_sim_now));
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_TIM_OC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t ch)
+{
+  htim->ch_running &= ~(1UL << (ch >> 2));
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *config, uint32_t ch)
+{
+  (void)htim;
+  (void)config;
+  (void)ch;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t ch)
+{
+  ow_sim_tim(htim)->pwm = (int)(ch >> 2) + 1;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_TIM_IC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_IC_InitTypeDef *config, uint32_t ch)
+{
+  (void)config;
+  ow_sim_tim_t *tim = ow_sim_tim(htim);
+  tim->ic = (int)(ch >> 2);
+
+  /* Halfword DMA unless the caller linked its own */
+  if (htim->hdma[TIM_DMA_ID_CC1 + tim->ic] == NULL)
+  {
+    DMA_HandleTypeDef *hdma = &ow_sim_dma[tim - ow_sim_tims][tim->ic];
+    hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    hdma->Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    htim->hdma[TIM_DMA_ID_CC1 + tim->ic] = hdma;
+  }
+  htim->hdma[TIM_DMA_ID_CC1 + tim->ic]->Parent = htim;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_TIM_IC_Start(TIM_HandleTypeDef *htim, uint32_t ch)
+{
+  ow_sim_tim_t *tim = ow_sim_tim(htim);
+  assert(tim->ic == (int)(ch >> 2));
+  tim->cc_on = true;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_TIM_IC_Stop(TIM_HandleTypeDef *htim, uint32_t ch)
+{
+  (void)ch;
+  ow_sim_tim(htim)->cc_on = false;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_TIM_GenerateEvent(TIM_HandleTypeDef *htim, uint32_t source)
+{
+  ow_sim_tim_t *tim = ow_sim_tim(htim);
+  if (source != TIM_EVENTSOURCE_UPDATE)
+  {
+    /* Compare event of channels now, without a match */
+    tim->ch_gen |= source / TIM_EVENTSOURCE_CC1;
+    return HAL_OK;
+  }
+  tim->ug = true;
+  if (tim->pwm)
+  {
+    /* Update event loads preload registers and starts a slot now */
+    uint64_t now = ow_sim_now;
+    tim->sh_arr = htim->Instance->ARR;
+    tim->sh_ccr = *(&htim->Instance->CCR1 + (tim->pwm - 1));
+    tim->start = now;
+    tim->next = now + tim->sh_arr + 1;
+    ow_sim_pwm_slot(tim, now);
+    ow_sim_now = now;
+  }
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+uint32_t HAL_TIM_ReadCapturedValue(TIM_HandleTypeDef *htim, uint32_t ch)
+{
+  htim->Instance->SR &= ~(TIM_FLAG_CC1 << (ch >> 2));
+  return *(&htim->Instance->CCR1 + (ch >> 2));
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t src, uint32_t dst, uint32_t len)
+{
+  ow_sim_tim_t *tim = ow_sim_tim((TIM_HandleTypeDef *)hdma->Parent);
+  assert(src == (uint32_t)(uintptr_t)(&tim->htim->Instance->CCR1 + tim->ic));
+  assert(hdma->Init.MemDataAlignment == DMA_MDATAALIGN_HALFWORD);
+  tim->dma = (uint16_t *)(uintptr_t)dst;
+  tim->dma_len = (int)len;
+  tim->dma_pos = 0;
+  tim->dma_on = true;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma)
+{
+  ow_sim_tim((TIM_HandleTypeDef *)hdma->Parent)->dma_on = false;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+uint32_t ow_sim_dma_counter(DMA_HandleTypeDef *hdma)
+{
+  ow_sim_tim_t *tim = ow_sim_tim((TIM_HandleTypeDef *)hdma->Parent);
+  return (uint32_t)(tim->dma_len - tim->dma_pos);
+}
+
+/*************************************************************************************************/
+void ow_sim_tim_clear(TIM_HandleTypeDef *htim, uint32_t flags)
+{
+  ow_sim_tim_t *tim = ow_sim_tim(htim);
+  uint32_t cc = TIM_FLAG_CC1 << tim->ic;
+  htim->Instance->SR &= ~flags;
+
+  /* Slot edges are computed at slot start, without DMA the flag of an edge still ahead survives */
+  if ((flags & cc) && tim->cc_on && (tim->cc_t > ow_sim_now) && !(htim->Instance->DIER & (TIM_DMA_CC1 << tim->ic)))
+  {
+    htim->Instance->SR |= cc;
+  }
+}
+
+/*************************************************************************************************/
+/** HAL UART **/
+/*************************************************************************************************/
+
+HAL_StatusTypeDef HAL_HalfDuplex_Init(UART_HandleTypeDef *huart)
+{
+  huart->Instance->BRR = OW_SIM_PCLK / huart->Init.BaudRate;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_UART_RegisterCallback(UART_HandleTypeDef *huart, HAL_UART_CallbackIDTypeDef id,
+                                            pUART_CallbackTypeDef cb)
+{
+  if (id == HAL_UART_RX_COMPLETE_CB_ID)
+  {
+    huart->RxCpltCallback = cb;
+  }
+  else
+  {
+    huart->ErrorCallback = cb;
+  }
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *data, uint16_t len)
+{
+  huart->rx = data;
+  huart->len = len;
+  huart->ErrorCode = HAL_UART_ERROR_NONE;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len)
+{
+  assert(huart->Instance->CR1 & 1UL);
+  assert(len == huart->len);
+  huart->tx = data;
+  huart->pending = true;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart)
+{
+  huart->pending = false;
+  return HAL_OK;
+}
+
+/*************************************************************************************************/
+/** Private Function Implementations **/
+/*************************************************************************************************/
+
+static ow_sim_tim_t *ow_sim_tim(TIM_HandleTypeDef *htim)
+{
+  for (int i = 0; i < ow_sim_tim_num; i++)
+  {
+    if (ow_sim_tims[i].htim == htim)
+    {
+      return &ow_sim_tims[i];
+    }
+  }
+  assert(ow_sim_tim_num < OW_SIM_MAX_TIM);
+  ow_sim_tims[ow_sim_tim_num].htim = htim;
+  return &ow_sim_tims[ow_sim_tim_num++];
+}
+
+/*************************************************************************************************/
+static uint32_t ow_sim_tim_cnt(ow_sim_tim_t *tim, uint64_t t)
+{
+  /* Compare channels free run, also between transfers, update timer is restarted per slot */
+  if (tim->oc)
+  {
+    return (uint32_t)((t - tim->base) % (tim->htim->Instance->ARR + 1UL));
+  }
+  return (uint32_t)(t - tim->start);
+}
+
+/*************************************************************************************************/
+static void ow_sim_tim_arm(ow_sim_tim_t *tim, int ch, uint64_t ref, uint32_t ref_cnt)
+{
+  uint32_t mod = tim->htim->Instance->ARR + 1UL;
+  uint32_t ccr = *(&tim->htim->Instance->CCR1 + ch);
+  uint32_t delta = (ccr + mod - ref_cnt) % mod;
+  if (delta == 0)
+  {
+    delta = mod;
+  }
+  tim->ch_next[ch] = ref + delta;
+  tim->ch_ccr[ch] = ccr;
+}
+
+/*************************************************************************************************/
+static void ow_sim_pwm_slot(ow_sim_tim_t *tim, uint64_t ev)
+{
+  int bus = ow_sim_hw_bus;
+  uint64_t end = ev + tim->sh_arr + 1;
+  if (tim->sh_ccr == 0)
+  {
+    return;
+  }
+
+  /* Low for CCR ticks, then released */
+  uint64_t rise = ev + tim->sh_ccr;
+  ow_sim_now = ev;
+  ow_sim_bus_edge(bus, true);
+  ow_sim_now = rise;
+  ow_sim_bus_edge(bus, false);
+
+  /* Edges in the slot: release of the pin, end and with both edge polarity start of a slave pulse */
+  static uint64_t edge[OW_SIM_MAX_SLAVE * 2 + 1];
+  int edge_cnt = 0;
+  bool both = (((tim->htim->Instance->CCER >> (tim->ic * 4)) & TIM_ICPOLARITY_BOTHEDGE) == TIM_ICPOLARITY_BOTHEDGE);
+  edge[edge_cnt++] = rise;
+  for (int k = 0; k < ow_sim_slave_cnt; k++)
+  {
+    ow_sim_slave_t *slave = ow_sim_slaves[k];
+    if ((slave->bus == bus) && slave->present && (slave->low_until > rise) && (slave->low_until < end))
+    {
+      edge[edge_cnt++] = slave->low_until;
+    }
+    /* Both edge polarity: start of a slave pulse too */
+    if (both && (slave->bus == bus) && slave->present && (slave->low_from > rise) && (slave->low_from < end))
+    {
+      edge[edge_cnt++] = slave->low_from;
+    }
+  }
+  for (int i = 0; i < edge_cnt; i++)
+  {
+    for (int j = i + 1; j < edge_cnt; j++)
+    {
+      if (edge[j] < edge[i])
+      {
+        uint64_t tmp = edge[i];
+        edge[i] = edge[j];
+        edge[j] = tmp;
+      }
+    }
+  }
+
+  /* Capture each low to high change, with both edge polarity each change from the pin low on */
+  if (both)
+  {
+    ow_sim_pwm_cap(tim, ev, ev);
+  }
+  uint64_t last = 0;
+  for (int i = 0; i < edge_cnt; i++)
+  {
+    uint64_t t = edge[i];
+    if (t == last)
+    {
+      continue;
+    }
+    last = t;
+    bool before = (t == rise) ? false : ow_sim_level(bus, t - 1);
+    bool after = ow_sim_level(bus, t);
+    if ((before == after) || (before && !both))
+    {
+      continue;
+    }
+    ow_sim_pwm_cap(tim, ev, t);
+  }
+}
+
+/*************************************************************************************************/
+static void ow_sim_pwm_cap(ow_sim_tim_t *tim, uint64_t ev, uint64_t t)
+{
+  if (!tim->cc_on)
+  {
+    return;
+  }
+  uint32_t cap = (uint32_t)(t - ev);
+  *(&tim->htim->Instance->CCR1 + tim->ic) = cap;
+  tim->htim->Instance->SR |= TIM_FLAG_CC1 << tim->ic;
+  tim->cc_t = t;
+  if (tim->dma_on && (tim->htim->Instance->DIER & (TIM_DMA_CC1 << tim->ic)) && (tim->dma_pos < tim->dma_len))
+  {
+    tim->dma[tim->dma_pos++] = (uint16_t)cap;
+    tim->htim->Instance->SR &= ~(TIM_FLAG_CC1 << tim->ic);
+  }
+}
+
+/*************************************************************************************************/
+static bool ow_sim_level(int bus, uint64_t t)
+{
+  if (ow_sim_buses[bus].master_low)
+  {
+    return false;
+  }
+  if ((ow_sim_glitch_from <= t) && (t < ow_sim_glitch_until))
+  {
+    return false;
+  }
+  for (int i = 0; i < ow_sim_slave_cnt; i++)
+  {
+    ow_sim_slave_t *slave = ow_sim_slaves[i];
+    if ((slave->bus == bus) && slave->present && (slave->low_from <= t) && (t < slave->low_until))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*************************************************************************************************/
+static void ow_sim_idr(void)
+{
+  for (size_t i = 0; i < sizeof(ow_sim_ports) / sizeof(ow_sim_ports[0]); i++)
+  {
+    ow_sim_ports[i]->IDR = 0;
+  }
+  for (int b = 0; b < ow_sim_bus_cnt; b++)
+  {
+    ow_sim_bus_t *bus = &ow_sim_buses[b];
+    bool high = ow_sim_level(b, ow_sim_now);
+    if (!bus->dual)
+    {
+      if (high)
+      {
+        bus->gpio->IDR |= bus->pin;
+      }
+    }
+    else if (high != bus->inv_rx)
+    {
+      bus->gpio_rx->IDR |= bus->pin_rx;
+    }
+  }
+}
+
+/*************************************************************************************************/
+static void ow_sim_bsrr(GPIO_TypeDef *gpio)
+{
+  uint32_t bsrr = gpio->BSRR;
+  gpio->BSRR = 0;
+  if (bsrr == 0)
+  {
+    return;
+  }
+  gpio->ODR |= bsrr & 0xFFFFUL;
+  gpio->ODR &= ~(bsrr >> 16);
+  for (int b = 0; b < ow_sim_bus_cnt; b++)
+  {
+    ow_sim_bus_t *bus = &ow_sim_buses[b];
+    if (bus->gpio != gpio)
+    {
+      continue;
+    }
+    bool low = (gpio->ODR & bus->pin) == 0;
+
+    /* Dual pins: TX drives a transistor, high pulls the bus low unless inverted */
+    if (bus->dual)
+    {
+      low = (!low) != bus->inv_tx;
+    }
+    if (low != bus->master_low)
+    {
+      ow_sim_bus_edge(b, low);
+    }
+  }
+}
+
+/*************************************************************************************************/
+static void ow_sim_bus_edge(int bus, bool low)
+{
+  /* A slave holding the line keeps it low, the driver edge still marks slot boundaries */
+  ow_sim_buses[bus].master_low = low;
+  for (int i = 0; i < ow_sim_slave_cnt; i++)
+  {
+    ow_sim_slave_t *slave = ow_sim_slaves[i];
+    if ((slave->bus != bus) || !slave->present)
+    {
+      continue;
+    }
+    if (low)
+    {
+      ow_sim_slave_fall(slave, ow_sim_now);
+    }
+    else
+    {
+      ow_sim_slave_rise(slave, ow_sim_now);
+    }
+  }
+}
+
+/*************************************************************************************************/
+static void ow_sim_slave_fall(ow_sim_slave_t *slave, uint64_t t)
+{
+  int bit;
+  slave->fall_t = t;
+  if (slave->state == OW_SIM_ST_TX)
+  {
+    bit = 1;
+    if (slave->tx_pos < slave->tx_len)
+    {
+      bit = (slave->tx_buf[slave->tx_pos] >> slave->tx_bit) & 1;
+    }
+    else if (slave->poll != NULL)
+    {
+      bit = slave->poll(slave, t);
+    }
+  }
+  else if ((slave->state == OW_SIM_ST_SEARCH) && (slave->search_sub < 2))
+  {
+    /* ROM bit, then its complement */
+    bit = ((slave->rom[slave->search_bit / 8] >> (slave->search_bit % 8)) & 1) ^ (slave->search_sub == 1);
+  }
+  else
+  {
+    return;
+  }
+
+  /* Send a 0 by holding the line low */
+  if (bit == 0)
+  {
+    slave->low_from = t;
+    slave->low_until = t + (slave->od ? OW_SIM_US(4) : OW_SIM_US(slave->low_us ? slave->low_us : 30));
+  }
+}
+
+/*************************************************************************************************/
+static void ow_sim_slave_rise(ow_sim_slave_t *slave, uint64_t t)
+{
+  uint64_t low = t - slave->fall_t;
+
+  /* Reset pulse, presence pulse after it */
+  if ((low >= OW_SIM_US(480)) || (slave->od && (low >= OW_SIM_US(45))))
+  {
+    if (low >= OW_SIM_US(480))
+    {
+      slave->od = false;
+      slave->low_from = t + OW_SIM_US(30);
+      slave->low_until = t + OW_SIM_US(150);
+    }
+    else
+    {
+      slave->low_from = t + OW_SIM_US(3);
+      slave->low_until = t + OW_SIM_US(12);
+    }
+    slave->resets++;
+    slave->layer = OW_SIM_LAYER_ROM;
+    ow_sim_slave_rx(slave, 1);
+    return;
+  }
+
+  /* Written bit by low time */
+  int bit = (low < (slave->od ? OW_SIM_US(3) : OW_SIM_US(15))) ? 1 : 0;
+  slave->slots++;
+  if (slave->state == OW_SIM_ST_RX)
+  {
+    if (bit)
+    {
+      slave->rx_byte |= (uint8_t)(1 << slave->rx_bits);
+    }
+    if (++slave->rx_bits == 8)
+    {
+      slave->rx_buf[slave->rx_len++] = slave->rx_byte;
+      slave->rx_bits = 0;
+      slave->rx_byte = 0;
+      if (slave->rx_len == slave->rx_need)
+      {
+        ow_sim_slave_rx_done(slave);
+      }
+    }
+  }
+  else if (slave->state == OW_SIM_ST_TX)
+  {
+    if ((slave->tx_pos < slave->tx_len) && (++slave->tx_bit == 8))
+    {
+      slave->tx_bit = 0;
+      slave->tx_pos++;
+    }
+  }
+  else if (slave->state == OW_SIM_ST_SEARCH)
+  {
+    if (slave->search_sub < 2)
+    {
+      slave->search_sub++;
+    }
+    else
+    {
+      /* Direction written by master, other devices leave the search */
+      if (bit != ((slave->rom[slave->search_bit / 8] >> (slave->search_bit % 8)) & 1))
+      {
+        slave->state = OW_SIM_ST_IDLE;
+        return;
+      }
+      slave->search_sub = 0;
+      if (++slave->search_bit == 64)
+      {
+        slave->layer = OW_SIM_LAYER_FUNC;
+        ow_sim_slave_rx(slave, 1);
+      }
+    }
+  }
+}
+
+/*************************************************************************************************/
+static void ow_sim_slave_rom(ow_sim_slave_t *slave, uint8_t rom_cmd)
+{
+  switch (rom_cmd)
+  {
+  /* Read ROM */
+  case 0x33:
+    slave->resume = false;
+    ow_sim_slave_tx(slave, slave->rom, 8);
+    slave->layer = OW_SIM_LAYER_FUNC;
+    break;
+  /* Match ROM */
+  case 0x55:
+    slave->od_match = false;
+    slave->layer = OW_SIM_LAYER_MATCH;
+    ow_sim_slave_rx(slave, 8);
+    break;
+  /* Overdrive Match ROM */
+  case 0x69:
+    if (slave->od_cap)
+    {
+      slave->od = true;
+      slave->od_match = true;
+      slave->layer = OW_SIM_LAYER_MATCH;
+      ow_sim_slave_rx(slave, 8);
+    }
+    else
+    {
+      slave->state = OW_SIM_ST_IDLE;
+    }
+    break;
+  /* Skip ROM */
+  case 0xCC:
+    slave->resume = false;
+    slave->layer = OW_SIM_LAYER_FUNC;
+    ow_sim_slave_rx(slave, 1);
+    break;
+  /* Overdrive Skip ROM */
+  case 0x3C:
+    if (slave->od_cap)
+    {
+      slave->od = true;
+      slave->resume = false;
+      slave->layer = OW_SIM_LAYER_FUNC;
+      ow_sim_slave_rx(slave, 1);
+    }
+    else
+    {
+      slave->state = OW_SIM_ST_IDLE;
+    }
+    break;
+  /* Search ROM, Alarm Search */
+  case 0xF0:
+  case 0xEC:
+    slave->resume = false;
+    if ((rom_cmd == 0xF0) || slave->alarm)
+    {
+      slave->state = OW_SIM_ST_SEARCH;
+      slave->search_bit = 0;
+      slave->search_sub = 0;
+    }
+    else
+    {
+      slave->state = OW_SIM_ST_IDLE;
+    }
+    break;
+  /* Resume */
+  case 0xA5:
+    if (slave->resume)
+    {
+      slave->layer = OW_SIM_LAYER_FUNC;
+      ow_sim_slave_rx(slave, 1);
+    }
+    else
+    {
+      slave->state = OW_SIM_ST_IDLE;
+    }
+    break;
+  default:
+    slave->state = OW_SIM_ST_IDLE;
+    break;
+  }
+}
+
+/*************************************************************************************************/
+static void ow_sim_slave_rx_done(ow_sim_slave_t *slave)
+{
+  switch (slave->layer)
+  {
+  case OW_SIM_LAYER_ROM:
+    ow_sim_slave_rom(slave, slave->rx_buf[0]);
+    break;
+  case OW_SIM_LAYER_MATCH:
+    if (memcmp(slave->rx_buf, slave->rom, 8) == 0)
+    {
+      slave->resume = true;
+      slave->layer = OW_SIM_LAYER_FUNC;
+      ow_sim_slave_rx(slave, 1);
+    }
+    else
+    {
+      slave->resume = false;
+      if (slave->od_match)
+      {
+        slave->od = false;
+      }
+      slave->state = OW_SIM_ST_IDLE;
+    }
+    break;
+  case OW_SIM_LAYER_FUNC:
+    slave->layer = OW_SIM_LAYER_DEV;
+    slave->fn_cmd = slave->rx_buf[0];
+    slave->state = OW_SIM_ST_IDLE;
+    if (slave->on_func != NULL)
+    {
+      slave->on_func(slave, slave->rx_buf[0]);
+    }
+    break;
+  default:
+    if (slave->on_rx_done != NULL)
+    {
+      slave->on_rx_done(slave);
+    }
+    else
+    {
+      slave->state = OW_SIM_ST_IDLE;
+    }
+    break;
+  }
+}
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
@@ -0,0 +1,194 @@
+
+/*
+ * @file        ow_sim.h
+ * @brief       Host simulator of OneWire buses, timers and slaves
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+#ifndef _OW_SIM_H_
+#define _OW_SIM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "main.h"
+#include "tim.h"
+#include "usart.h"
+#include "ow_config.h"
+
+/*************************************************************************************************/
+/** Defines **/
+/*************************************************************************************************/
+
+/* Simulated time runs in timer ticks */
+#define OW_SIM_US(us)             ((uint64_t)(us) * OW_TIM_TICK_PER_US)
+
+/* Max buses and slaves of one simulation */
+#define OW_SIM_MAX_BUS            8
+#define OW_SIM_MAX_SLAVE          600
+
+/* Buffer of one slave function command, DS2431 whole memory */
+#define OW_SIM_BUF_LEN            160
+
+/* Run code that touches the bus as the target would: IDR sampled before, BSRR applied after */
+#define OW_SIM(x)                 do { ow_sim_pre(); x; ow_sim_post(); } while (0)
+
+/*************************************************************************************************/
+/** Typedef/Struct/Enum **/
+/*************************************************************************************************/
+
+typedef struct ow_sim_slave_s ow_sim_slave_t;
+
+/* One simulated slave, ROM layer in ow_sim.c, function layer set by a device model */
+struct ow_sim_slave_s
+{
+  int                       bus;                   /* Bus index of ow_sim_bus_add() */
+  uint8_t                   rom[8];                /* ROM ID, family first, CRC last */
+  bool                      present;               /* On the bus */
+  bool                      alarm;                 /* Answers Alarm Search (0xEC) */
+  bool                      od_cap;                /* Overdrive capable */
+  bool                      od;                    /* In overdrive speed */
+  bool                      od_match;              /* Selected by Overdrive Match ROM */
+  bool                      resume;                /* Selected, so Resume (0xA5) is accepted */
+  uint16_t                  low_us;                /* Length of a written 0, 0 == 30 us */
+
+  /* Bus state */
+  uint64_t                  fall_t;                /* Time of last falling edge */
+  uint64_t                  low_from;              /* Slave pulls bus low from this time */
+  uint64_t                  low_until;             /* Up to this time */
+  int                       state;                 /* Idle, receive, send or search */
+  int                       layer;                 /* ROM command, match ROM, function command, device */
+  uint32_t                  slots;                 /* Slots seen */
+  uint32_t                  resets;                /* Reset pulses seen */
+
+  /* Receive */
+  uint8_t                   rx_buf[OW_SIM_BUF_LEN];
+  uint8_t                   rx_byte;
+  int                       rx_bits;
+  int                       rx_len;
+  int                       rx_need;
+
+  /* Send, poll() answers read slots after tx_buf, NULL == 1 bits */
+  uint8_t                   tx_buf[OW_SIM_BUF_LEN];
+  int                       tx_len;
+  int                       tx_pos;
+  int                       tx_bit;
+  int                       (*poll)(ow_sim_slave_t *slave, uint64_t t);
+
+  /* Search */
+  int                       search_bit;
+  int                       search_sub;
+
+  /* Function layer of device model */
+  void                      (*on_func)(ow_sim_slave_t *slave, uint8_t fn_cmd);
+  void                      (*on_rx_done)(ow_sim_slave_t *slave);
+  int                       fn_cmd;                /* Last function command */
+  uint64_t                  busy_until;            /* Conversion or copy in progress */
+
+  /* Device memory */
+  int16_t                   temp;                  /* DS18B20 temperature, 1/16 degree */
+  uint8_t                   scratch[9];            /* DS18B20 scratchpad */
+  uint8_t                   mem[144];              /* DS2431 memory */
+  uint8_t                   sp[8];                 /* DS2431 scratchpad */
+  uint8_t                   ta1;                   /* DS2431 target address */
+  uint8_t                   ta2;
+  uint8_t                   es;                    /* DS2431 ending offset and status */
+
+};
+
+/*************************************************************************************************/
+/** Variables **/
+/*************************************************************************************************/
+
+extern uint64_t ow_sim_now;                        /* Simulated time in ticks */
+extern uint64_t ow_sim_isr;                        /* Simulated interrupts */
+extern uint32_t ow_sim_lat;                        /* Interrupt entry latency in ticks */
+extern uint64_t ow_sim_glitch_from;                /* Bus held low by noise from this time */
+extern uint64_t ow_sim_glitch_until;               /* Up to this time */
+extern uint64_t ow_sim_pullup_on;                  /* Last strong pull-up start */
+extern uint64_t ow_sim_pullup_off;                 /* Last strong pull-up end */
+extern uint32_t ow_sim_pullup_cnt;                 /* Strong pull-ups */
+
+/*************************************************************************************************/
+/** API Functions **/
+/*************************************************************************************************/
+
+/* Remove all buses, timers and slaves, time back to 0 */
+void            ow_sim_reset(void);
+
+/* Add an open-drain bus, return its index */
+int             ow_sim_bus_add(GPIO_TypeDef *gpio, uint16_t pin);
+
+/* Add a dual pin bus, TX high pulls it low unless inv_tx, RX reads it inverted if inv_rx */
+int             ow_sim_bus_add_dual(GPIO_TypeDef *gpio_tx, uint16_t pin_tx, GPIO_TypeDef *gpio_rx,
+                                    uint16_t pin_rx, bool inv_tx, bool inv_rx);
+
+/* Select bus of timer PWM and input capture slots (OW_TIM_HW) */
+void            ow_sim_bus_hw(int bus);
+
+/* Add a slave with a ROM ID, without function commands until a device model is set */
+ow_sim_slave_t *ow_sim_slave_add(int bus, uint8_t family, uint64_t serial);
+
+/* Take a slave off the bus, it stays in memory until ow_sim_reset() */
+void            ow_sim_slave_remove(ow_sim_slave_t *slave);
+
+/* Slave function layer, for device models: receive len bytes then on_rx_done(), send bytes,
+   answer read slots by poll() (NULL == 1 bits), or ignore slots until next reset */
+void            ow_sim_slave_rx(ow_sim_slave_t *slave, int len);
+void            ow_sim_slave_tx(ow_sim_slave_t *slave, const uint8_t *data, int len);
+void            ow_sim_slave_poll(ow_sim_slave_t *slave, int (*poll)(ow_sim_slave_t *slave, uint64_t t));
+void            ow_sim_slave_idle(ow_sim_slave_t *slave);
+
+/* Number of slaves, and slave by index */
+int             ow_sim_slave_count(void);
+ow_sim_slave_t *ow_sim_slave_get(int index);
+
+/* Sample bus into IDR and timer counters, before code that touches the bus */
+void            ow_sim_pre(void);
+
+/* Apply BSRR writes to the bus, after code that touches the bus */
+void            ow_sim_post(void);
+
+/* Run timer events until all timers stop (return 0) or max_ticks elapse (return 1) */
+int             ow_sim_run(uint64_t max_ticks);
+
+/* Run started UART transfers of a bus until the driver starts no new one */
+void            ow_sim_uart_run(UART_HandleTypeDef *huart, int bus);
+
+/* Maxim CRC8 and CRC16 */
+uint8_t         ow_sim_crc8(const uint8_t *data, int len);
+uint16_t        ow_sim_crc16(uint16_t crc, const uint8_t *data, int len);
+
+/* Device models, ow_sim_dev.c */
+void            ow_sim_ds18b20(ow_sim_slave_t *slave, int16_t temp);
+void            ow_sim_ds2431(ow_sim_slave_t *slave);
+
+/* Add count slaves of one family, serials from seed, return first index of ow_sim_slave_get() */
+int             ow_sim_rom_bulk(int bus, uint8_t family, int count, uint32_t seed);
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _OW_SIM_H_ */
@@ -0,0 +1,272 @@
+
+/*
+ * @file        ow_sim_dev.c
+ * @brief       Host simulator device models: DS18B20, DS2431 and bulk ROM populations
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include <string.h>
+#include "ow_sim.h"
+
+/*************************************************************************************************/
+/** Private Defines **/
+/*************************************************************************************************/
+
+/* DS18B20 conversion time at 12 bit */
+#define OW_SIM_DS18B20_CONV_US    750000
+
+/* DS2431 copy scratchpad time */
+#define OW_SIM_DS2431_COPY_US     10000
+
+/*************************************************************************************************/
+/** Private Function prototype **/
+/*************************************************************************************************/
+
+/* DS18B20 */
+static void ow_sim_ds18b20_func(ow_sim_slave_t *slave, uint8_t fn_cmd);
+static void ow_sim_ds18b20_rx_done(ow_sim_slave_t *slave);
+static int  ow_sim_ds18b20_poll(ow_sim_slave_t *slave, uint64_t t);
+static void ow_sim_ds18b20_scratch(ow_sim_slave_t *slave);
+
+/* DS2431 */
+static void ow_sim_ds2431_func(ow_sim_slave_t *slave, uint8_t fn_cmd);
+static void ow_sim_ds2431_rx_done(ow_sim_slave_t *slave);
+static int  ow_sim_ds2431_poll(ow_sim_slave_t *slave, uint64_t t);
+
+/*************************************************************************************************/
+/** Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief DS18B20: Convert T (0x44, read slots 0 until done), Read (0xBE) and Write (0x4E) Scratchpad.
+ * @param[in] slave: Slave of ow_sim_slave_add(), family 0x28.
+ * @param[in] temp: Temperature in 1/16 degree.
+ */
+void ow_sim_ds18b20(ow_sim_slave_t *slave, int16_t temp)
+{
+  slave->temp = temp;
+  slave->on_func = ow_sim_ds18b20_func;
+  slave->on_rx_done = ow_sim_ds18b20_rx_done;
+  ow_sim_ds18b20_scratch(slave);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief DS2431: Write (0x0F), Read (0xAA) and Copy (0x55) Scratchpad, Read Memory (0xF0).
+ * @param[in] slave: Slave of ow_sim_slave_add(), family 0x2D.
+ */
+void ow_sim_ds2431(ow_sim_slave_t *slave)
+{
+  slave->on_func = ow_sim_ds2431_func;
+  slave->on_rx_done = ow_sim_ds2431_rx_done;
+  slave->od_cap = true;
+  memset(slave->mem, 0xFF, sizeof(slave->mem));
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Add a population of ROM-only slaves, serials from a xorshift sequence.
+ * @param[in] bus: Bus index of ow_sim_bus_add().
+ * @param[in] family: Family code of all slaves.
+ * @param[in] count: Number of slaves.
+ * @param[in] seed: Start of serial sequence, runs with the same seed use the same ROM IDs.
+ * @retval Index of the first added slave in ow_sim_slave_get().
+ */
+int ow_sim_rom_bulk(int bus, uint8_t family, int count, uint32_t seed)
+{
+  int first = ow_sim_slave_count();
+  uint64_t x = 0x9E3779B97F4A7C15ULL ^ seed;
+  for (int i = 0; i < count; i++)
+  {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    ow_sim_slave_add(bus, family, x & 0xFFFFFFFFFFFFULL);
+  }
+  return first;
+}
+
+/*************************************************************************************************/
+/** Private Function Implementations **/
+/*************************************************************************************************/
+
+static void ow_sim_ds18b20_func(ow_sim_slave_t *slave, uint8_t fn_cmd)
+{
+  switch (fn_cmd)
+  {
+  /* Convert T, busy until done */
+  case 0x44:
+    slave->busy_until = ow_sim_now + OW_SIM_US(OW_SIM_DS18B20_CONV_US);
+    ow_sim_ds18b20_scratch(slave);
+    ow_sim_slave_poll(slave, ow_sim_ds18b20_poll);
+    break;
+  /* Read Scratchpad */
+  case 0xBE:
+    ow_sim_slave_tx(slave, slave->scratch, 9);
+    break;
+  /* Write Scratchpad: TH, TL, configuration */
+  case 0x4E:
+    ow_sim_slave_rx(slave, 3);
+    break;
+  default:
+    ow_sim_slave_poll(slave, NULL);
+    break;
+  }
+}
+
+/*************************************************************************************************/
+static void ow_sim_ds18b20_rx_done(ow_sim_slave_t *slave)
+{
+  if (slave->fn_cmd == 0x4E)
+  {
+    memcpy(&slave->scratch[2], slave->rx_buf, 3);
+    slave->scratch[8] = ow_sim_crc8(slave->scratch, 8);
+  }
+  ow_sim_slave_idle(slave);
+}
+
+/*************************************************************************************************/
+static int ow_sim_ds18b20_poll(ow_sim_slave_t *slave, uint64_t t)
+{
+  return (t >= slave->busy_until) ? 1 : 0;
+}
+
+/*************************************************************************************************/
+static void ow_sim_ds18b20_scratch(ow_sim_slave_t *slave)
+{
+  slave->scratch[0] = (uint8_t)slave->temp;
+  slave->scratch[1] = (uint8_t)((uint16_t)slave->temp >> 8);
+  slave->scratch[4] = 0x7F;
+  slave->scratch[5] = 0xFF;
+  slave->scratch[6] = 0x0C;
+  slave->scratch[7] = 0x10;
+  slave->scratch[8] = ow_sim_crc8(slave->scratch, 8);
+}
+
+/*************************************************************************************************/
+static void ow_sim_ds2431_func(ow_sim_slave_t *slave, uint8_t fn_cmd)
+{
+  switch (fn_cmd)
+  {
+  /* Write Scratchpad: TA1, TA2, 8 data bytes */
+  case 0x0F:
+    ow_sim_slave_rx(slave, 10);
+    break;
+  /* Copy Scratchpad: TA1, TA2, E/S */
+  case 0x55:
+    ow_sim_slave_rx(slave, 3);
+    break;
+  /* Read Memory: TA1, TA2 */
+  case 0xF0:
+    ow_sim_slave_rx(slave, 2);
+    break;
+  /* Read Scratchpad: TA1, TA2, E/S, data, inverted CRC16 */
+  case 0xAA:
+  {
+    uint8_t crc_buf[12];
+    uint8_t out[13];
+    out[0] = slave->ta1;
+    out[1] = slave->ta2;
+    out[2] = slave->es;
+    memcpy(&out[3], slave->sp, 8);
+    crc_buf[0] = fn_cmd;
+    memcpy(&crc_buf[1], out, 11);
+    uint16_t crc = (uint16_t)~ow_sim_crc16(0, crc_buf, 12);
+    out[11] = (uint8_t)crc;
+    out[12] = (uint8_t)(crc >> 8);
+    ow_sim_slave_tx(slave, out, 13);
+    break;
+  }
+  default:
+    ow_sim_slave_idle(slave);
+    break;
+  }
+}
+
+/*************************************************************************************************/
+static void ow_sim_ds2431_rx_done(ow_sim_slave_t *slave)
+{
+  switch (slave->fn_cmd)
+  {
+  /* Write Scratchpad, answer inverted CRC16 of command and data */
+  case 0x0F:
+  {
+    uint8_t crc_buf[11];
+    slave->ta1 = slave->rx_buf[0];
+    slave->ta2 = slave->rx_buf[1];
+    memcpy(slave->sp, &slave->rx_buf[2], 8);
+    slave->es = (uint8_t)((slave->ta1 & 7) + 7);
+    crc_buf[0] = 0x0F;
+    memcpy(&crc_buf[1], slave->rx_buf, 10);
+    uint16_t crc = (uint16_t)~ow_sim_crc16(0, crc_buf, 11);
+    uint8_t out[2] = { (uint8_t)crc, (uint8_t)(crc >> 8) };
+    ow_sim_slave_tx(slave, out, 2);
+    break;
+  }
+  /* Copy Scratchpad, authorized by matching TA1, TA2 and E/S */
+  case 0x55:
+    if ((slave->rx_buf[0] == slave->ta1) && (slave->rx_buf[1] == slave->ta2) && (slave->rx_buf[2] == slave->es))
+    {
+      uint16_t addr = (uint16_t)((slave->ta1 | (slave->ta2 << 8)) & ~7U);
+      if (addr < sizeof(slave->mem))
+      {
+        memcpy(&slave->mem[addr], slave->sp, 8);
+      }
+      slave->es |= 0x80;
+      slave->busy_until = ow_sim_now + OW_SIM_US(OW_SIM_DS2431_COPY_US);
+      ow_sim_slave_poll(slave, ow_sim_ds2431_poll);
+    }
+    else
+    {
+      ow_sim_slave_idle(slave);
+    }
+    break;
+  /* Read Memory up to its end */
+  case 0xF0:
+  {
+    uint16_t addr = (uint16_t)(slave->rx_buf[0] | (slave->rx_buf[1] << 8));
+    int len = (addr < sizeof(slave->mem)) ? (int)sizeof(slave->mem) - addr : 0;
+    ow_sim_slave_tx(slave, &slave->mem[(len != 0) ? addr : 0], len);
+    break;
+  }
+  default:
+    ow_sim_slave_idle(slave);
+    break;
+  }
+}
+
+/*************************************************************************************************/
+static int ow_sim_ds2431_poll(ow_sim_slave_t *slave, uint64_t t)
+{
+  /* 1 while copying, then 0xAA pattern */
+  if (t < slave->busy_until)
+  {
+    return 1;
+  }
+  uint8_t done = 0xAA;
+  ow_sim_slave_tx(slave, &done, 1);
+  slave->poll = ow_sim_ds2431_poll;
+  return 0;
+}
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
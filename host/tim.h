@@ -0,0 +1,208 @@
+
+/*
+ * @file        tim.h
+ * @brief       Host stub of the STM32 HAL timer and DMA used by the OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+#ifndef _TIM_H_
+#define _TIM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "main.h"
+
+/*************************************************************************************************/
+/** Defines **/
+/*************************************************************************************************/
+
+#define TIM_CHANNEL_1                   0x00UL
+#define TIM_CHANNEL_2                   0x04UL
+#define TIM_CHANNEL_3                   0x08UL
+#define TIM_CHANNEL_4                   0x0CUL
+
+#define TIM_CR1_ARPE                    (1UL << 7)
+#define TIM_EVENTSOURCE_UPDATE          1UL
+#define TIM_EVENTSOURCE_CC1             2UL
+#define TIM_FLAG_UPDATE                 1UL
+#define TIM_FLAG_CC1                    2UL
+#define TIM_IT_UPDATE                   1UL
+#define TIM_IT_CC1                      2UL
+#define TIM_IT_CC2                      4UL
+#define TIM_IT_CC3                      8UL
+#define TIM_IT_CC4                      16UL
+#define TIM_DMA_ID_CC1                  1UL
+#define TIM_DMA_CC1                     0x200UL
+
+#define TIM_OCMODE_TIMING               0UL
+#define TIM_OCMODE_PWM2                 0x70UL
+#define TIM_OCPOLARITY_HIGH             0UL
+#define TIM_OCFAST_DISABLE              0UL
+#define TIM_ICPOLARITY_RISING           0UL
+#define TIM_ICPOLARITY_FALLING          0x2UL
+#define TIM_ICPOLARITY_BOTHEDGE         0xAUL
+#define TIM_ICSELECTION_DIRECTTI        1UL
+#define TIM_ICSELECTION_INDIRECTTI      2UL
+#define TIM_ICPSC_DIV1                  0UL
+
+#define DMA_PDATAALIGN_HALFWORD         0x100UL
+#define DMA_MDATAALIGN_HALFWORD         0x400UL
+#define DMA_MDATAALIGN_WORD             0x800UL
+
+/* Register macros, counter is brought up to simulated time before each callback */
+#define __HAL_TIM_SET_AUTORELOAD(h, v)  do { (h)->Instance->ARR = (v); (h)->Init.Period = (v); } while (0)
+#define __HAL_TIM_GET_AUTORELOAD(h)     ((h)->Instance->ARR)
+#define __HAL_TIM_SET_COUNTER(h, v)     ((h)->Instance->CNT = (v))
+#define __HAL_TIM_GET_COUNTER(h)        ((h)->Instance->CNT)
+#define __HAL_TIM_SET_COMPARE(h, c, v)  (*(&(h)->Instance->CCR1 + ((c) >> 2)) = (v))
+#define __HAL_TIM_GET_COMPARE(h, c)     (*(&(h)->Instance->CCR1 + ((c) >> 2)))
+#define __HAL_TIM_CLEAR_IT(h, f)        ow_sim_tim_clear((h), (f))
+#define __HAL_TIM_CLEAR_FLAG(h, f)      ow_sim_tim_clear((h), (f))
+#define __HAL_TIM_GET_FLAG(h, f)        ((((h)->Instance->SR & (f)) == (f)) ? 1 : 0)
+#define __HAL_TIM_ENABLE_DMA(h, f)      ((h)->Instance->DIER |= (f))
+#define __HAL_TIM_DISABLE_DMA(h, f)     ((h)->Instance->DIER &= ~(f))
+#define __HAL_TIM_SET_CAPTUREPOLARITY(h, c, p) \
+  ((h)->Instance->CCER = ((h)->Instance->CCER & ~(TIM_ICPOLARITY_BOTHEDGE << (c))) | ((p) << (c)))
+#define __HAL_DMA_GET_COUNTER(h)        ow_sim_dma_counter(h)
+
+/*************************************************************************************************/
+/** Typedef/Struct/Enum **/
+/*************************************************************************************************/
+
+typedef struct
+{
+  volatile uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR, RCR, CCR1, CCR2, CCR3, CCR4;
+
+} TIM_TypeDef;
+
+typedef struct
+{
+  uint32_t                  Prescaler;
+  uint32_t                  CounterMode;
+  uint32_t                  Period;
+
+} TIM_Base_InitTypeDef;
+
+typedef enum
+{
+  HAL_TIM_ACTIVE_CHANNEL_CLEARED = 0x00,
+  HAL_TIM_ACTIVE_CHANNEL_1 = 0x01,
+  HAL_TIM_ACTIVE_CHANNEL_2 = 0x02,
+  HAL_TIM_ACTIVE_CHANNEL_3 = 0x04,
+  HAL_TIM_ACTIVE_CHANNEL_4 = 0x08
+
+} HAL_TIM_ActiveChannel;
+
+typedef struct
+{
+  uint32_t                  PeriphDataAlignment;
+  uint32_t                  MemDataAlignment;
+
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef
+{
+  DMA_InitTypeDef           Init;
+  void                      *Parent;
+
+} DMA_HandleTypeDef;
+
+typedef struct __TIM_HandleTypeDef
+{
+  TIM_TypeDef               *Instance;
+  TIM_Base_InitTypeDef      Init;
+  HAL_TIM_ActiveChannel     Channel;
+  DMA_HandleTypeDef         *hdma[7];
+  void                      (*PeriodElapsedCallback)(struct __TIM_HandleTypeDef *htim);
+  void                      (*OC_DelayElapsedCallback)(struct __TIM_HandleTypeDef *htim);
+  int                       running;               /* Update interrupt enabled */
+  uint32_t                  ch_running;            /* Compare interrupts enabled, one bit per channel */
+
+} TIM_HandleTypeDef;
+
+typedef enum
+{
+  HAL_TIM_PERIOD_ELAPSED_CB_ID,
+  HAL_TIM_OC_DELAY_ELAPSED_CB_ID
+
+} HAL_TIM_CallbackIDTypeDef;
+
+typedef void (*pTIM_CallbackTypeDef)(TIM_HandleTypeDef *htim);
+
+typedef struct
+{
+  uint32_t                  OCMode;
+  uint32_t                  Pulse;
+  uint32_t                  OCPolarity;
+  uint32_t                  OCNPolarity;
+  uint32_t                  OCFastMode;
+  uint32_t                  OCIdleState;
+  uint32_t                  OCNIdleState;
+
+} TIM_OC_InitTypeDef;
+
+typedef struct
+{
+  uint32_t                  ICPolarity;
+  uint32_t                  ICSelection;
+  uint32_t                  ICPrescaler;
+  uint32_t                  ICFilter;
+
+} TIM_IC_InitTypeDef;
+
+/*************************************************************************************************/
+/** API Functions **/
+/*************************************************************************************************/
+
+HAL_StatusTypeDef HAL_TIM_RegisterCallback(TIM_HandleTypeDef *htim, HAL_TIM_CallbackIDTypeDef id,
+                                           pTIM_CallbackTypeDef cb);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_OC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *config, uint32_t ch);
+HAL_StatusTypeDef HAL_TIM_OC_Start_IT(TIM_HandleTypeDef *htim, uint32_t ch);
+HAL_StatusTypeDef HAL_TIM_OC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t ch);
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *config, uint32_t ch);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t ch);
+HAL_StatusTypeDef HAL_TIM_IC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_IC_InitTypeDef *config, uint32_t ch);
+HAL_StatusTypeDef HAL_TIM_IC_Start(TIM_HandleTypeDef *htim, uint32_t ch);
+HAL_StatusTypeDef HAL_TIM_IC_Stop(TIM_HandleTypeDef *htim, uint32_t ch);
+HAL_StatusTypeDef HAL_TIM_GenerateEvent(TIM_HandleTypeDef *htim, uint32_t source);
+uint32_t          HAL_TIM_ReadCapturedValue(TIM_HandleTypeDef *htim, uint32_t ch);
+
+/* Channel DMA, addresses are 32-bit as on target (host build links with -no-pie) */
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t src, uint32_t dst, uint32_t len);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+
+/* Transfers left of channel DMA, as NDTR */
+uint32_t          ow_sim_dma_counter(DMA_HandleTypeDef *hdma);
+
+/* Clear status flags, a capture of an edge still ahead in the simulated slot stays pending */
+void              ow_sim_tim_clear(TIM_HandleTypeDef *htim, uint32_t flags);
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _TIM_H_ */
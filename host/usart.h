@@ -0,0 +1,105 @@
+
+/*
+ * @file        usart.h
+ * @brief       Host stub of the STM32 HAL half-duplex UART used by the OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+#ifndef _USART_H_
+#define _USART_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "main.h"
+
+/*************************************************************************************************/
+/** Defines **/
+/*************************************************************************************************/
+
+#define HAL_UART_ERROR_NONE       0UL
+#define HAL_UART_ERROR_FE         4UL
+
+#define __HAL_UART_ENABLE(h)      ((h)->Instance->CR1 |= 1UL)
+#define __HAL_UART_DISABLE(h)     ((h)->Instance->CR1 &= ~1UL)
+
+/*************************************************************************************************/
+/** Typedef/Struct/Enum **/
+/*************************************************************************************************/
+
+typedef struct
+{
+  volatile uint32_t CR1, CR2, CR3, BRR, ISR, ICR, RDR, TDR;
+
+} USART_TypeDef;
+
+typedef struct
+{
+  uint32_t                  BaudRate;
+  uint32_t                  WordLength;
+  uint32_t                  StopBits;
+  uint32_t                  Parity;
+  uint32_t                  Mode;
+
+} UART_InitTypeDef;
+
+typedef struct __UART_HandleTypeDef
+{
+  USART_TypeDef             *Instance;
+  UART_InitTypeDef          Init;
+  volatile uint32_t         ErrorCode;
+  void                      (*RxCpltCallback)(struct __UART_HandleTypeDef *huart);
+  void                      (*ErrorCallback)(struct __UART_HandleTypeDef *huart);
+  uint8_t                   *rx;                   /* DMA receive buffer */
+  const uint8_t             *tx;                   /* DMA transmit buffer */
+  uint16_t                  len;                   /* DMA length of both directions */
+  bool                      pending;               /* Transmit started, not yet simulated */
+
+} UART_HandleTypeDef;
+
+typedef enum
+{
+  HAL_UART_RX_COMPLETE_CB_ID,
+  HAL_UART_ERROR_CB_ID
+
+} HAL_UART_CallbackIDTypeDef;
+
+typedef void (*pUART_CallbackTypeDef)(UART_HandleTypeDef *huart);
+
+/*************************************************************************************************/
+/** API Functions **/
+/*************************************************************************************************/
+
+HAL_StatusTypeDef HAL_HalfDuplex_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_RegisterCallback(UART_HandleTypeDef *huart, HAL_UART_CallbackIDTypeDef id,
+                                            pUART_CallbackTypeDef cb);
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *data, uint16_t len);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len);
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart);
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _USART_H_ */
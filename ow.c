@@ -24,6 +24,40 @@
 
 #include <string.h>
 #include "ow.h"
+#include "ow_isr.h"
+
+/*************************************************************************************************/
+/** Private Macros **/
+/*************************************************************************************************/
+
+#if (OW_RETRY == 1)
+/* CRC16 over data and its inverted CRC16 */
+#define OW_CRC16_RESIDUAL               0xB001
+#endif
+
+#if (OW_MARGIN == 1)
+/* Store captured edge of one read slot */
+#define OW_MARGIN_SLOT(handle, edge, one)  ow_margin_slot((handle), (edge), (one))
+/* Capture both edges of the reset slot that starts at this update */
+#define OW_MARGIN_RST(handle)           ow_margin_rst(handle)
+/* Edges of a reset slot: master low and release, start and end of presence pulse */
+#define OW_MARGIN_RST_EDGES             4
+#else
+#define OW_MARGIN_SLOT(handle, edge, one)
+#define OW_MARGIN_RST(handle)
+#endif
+
+#if (OW_LANES > 1)
+/* Handle drives several lanes in lockstep, a ROM ID selects one device of one lane only */
+#define OW_LANE_MULTI(handle)           ((handle)->lane_cnt > 1)
+#else
+#define OW_LANE_MULTI(handle)           false
+#endif
+
+/* Slot ISR hooks (ow_isr.h), pins and timing of handle */
+#define OW_PIN_WRITE(handle, high)      ow_write_bit((handle), (high))
+#define OW_PIN_READ(handle)             ow_read_bit(handle)
+#define OW_SLOT(handle, field)          ((handle)->tim->field)
 
 /*************************************************************************************************/
 /** Private Function prototype **/
@@ -32,15 +66,162 @@
 /* Start OneWire communication */
 ow_err_t  ow_start(ow_t *handle);
 
-/* Stop OneWire communication */
-void      ow_stop(ow_t *handle);
+/* Handle timer (or UART) event, in ow_isr_impl.h */
+__STATIC_FORCEINLINE void ow_isr(ow_t *handle);
+
+/* Set bus idle, call done callbacks and start next queued transaction */
+void      ow_done(ow_t *handle);
+
+/* Get write byte of transfer, header or caller data */
+__STATIC_FORCEINLINE uint8_t ow_buf_write(ow_t *handle, uint16_t byte_idx);
+
+/* Get read byte of transfer, in handle or caller buffer */
+__STATIC_FORCEINLINE uint8_t *ow_buf_read(ow_t *handle, uint16_t byte_idx);
+
+#if (OW_QUEUE_LEN > 0)
+/* Start next queued transaction */
+void      ow_queue_next(ow_t *handle);
+
+/* Add transaction to queue, start it if bus is free */
+ow_err_t  ow_queue_push(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len,
+                        uint16_t r_len, ow_job_cb_t cb, void *arg);
+#endif
 
 /* Handle transfer state machine */
 __STATIC_FORCEINLINE void ow_state_xfer(ow_t *handle);
 
+#if (OW_PROG == 1)
+/* Load next step of transaction program */
+__STATIC_FORCEINLINE void ow_prog_next(ow_t *handle);
+
+/* Count down wait step in chunks the timer can hold */
+__STATIC_FORCEINLINE void ow_prog_wait(ow_t *handle);
+
+/* Switch pin between push-pull (strong pull-up) and open-drain */
+__STATIC_FORCEINLINE void ow_pullup(ow_t *handle, bool enable);
+
+/* Build poll step from interval and timeout */
+__STATIC_FORCEINLINE ow_op_t ow_prog_poll_op(ow_t *handle, uint16_t interval_us, uint16_t timeout_ms);
+
+/* Run command followed by poll or pull-up step */
+ow_err_t  ow_prog_cmd(ow_t *handle, bool by_id, uint8_t rom_id, uint8_t fn_cmd, const ow_op_t *tail);
+#endif
+
 #if (OW_MAX_DEVICE > 1)
+/* Start ROM search by command, optionally of one family */
+ow_err_t  ow_search_start(ow_t *handle, uint8_t cmd, uint8_t family, ow_search_mode_t mode);
+
+/* Report departed devices at end of rescan */
+void      ow_search_merge_end(ow_t *handle);
+
 /* Handle search state machine */
 __STATIC_FORCEINLINE void ow_state_search(ow_t *handle);
+
+/* Resolve search direction of current ROM bit */
+__STATIC_FORCEINLINE bool ow_search_resolve(ow_t *handle);
+
+/* Walk running search pass again from reset */
+__STATIC_FORCEINLINE bool ow_search_retry(ow_t *handle);
+
+/* Store selected ROM bit and finish ROM ID */
+__STATIC_FORCEINLINE bool ow_search_advance(ow_t *handle);
+#endif
+
+#if (OW_RETRY == 1)
+/* Keep prepared transfer for retry */
+__STATIC_FORCEINLINE void ow_retry_arm(ow_t *handle, uint16_t fn_idx);
+
+/* Check response, start transfer again if it failed */
+bool      ow_retry(ow_t *handle);
+
+/* CRC16 of function command, write and read bytes */
+__STATIC_FORCEINLINE uint16_t ow_retry_crc16(ow_t *handle);
+#endif
+
+#if (OW_CALIB == 1)
+/* Sample timer count after pin access while calibrating */
+__STATIC_FORCEINLINE void ow_calib_mark(ow_t *handle, uint8_t point);
+
+/* Compute edge offset compensation at end of calibration */
+void      ow_calib_end(ow_t *handle);
+#endif
+
+#if (OW_STATS == 1)
+/* Update ISR cost counters */
+__STATIC_FORCEINLINE void ow_stats_isr(ow_t *handle, uint32_t cyc, uint16_t lat);
+
+/* Store ISR calls, cycles and duration of finished transaction */
+__STATIC_FORCEINLINE void ow_stats_done(ow_t *handle);
+#endif
+
+#if (OW_TRACE == 1)
+/* Record timer event in trace ring */
+__STATIC_FORCEINLINE void ow_trace_isr(ow_t *handle, uint16_t lat);
+#endif
+
+#if (OW_BACKEND == OW_BACKEND_UART)
+/* Start one DMA transfer of bit slots at given baud rate */
+__STATIC_FORCEINLINE void ow_uart_xmit(ow_t *handle, uint32_t brr, uint16_t slot_idx, uint16_t slot_len);
+
+/* Encode and send next block of transfer slots */
+__STATIC_FORCEINLINE void ow_uart_xfer_block(ow_t *handle);
+
+/* Check presence pulse from reset slot echo */
+__STATIC_FORCEINLINE bool ow_uart_presence(ow_t *handle);
+#else
+#if (OW_TIM_HW == 0)
+/* Schedule next timer event */
+__STATIC_FORCEINLINE void ow_tim_next(ow_t *handle, uint16_t ticks);
+
+/* Finish transfer at its last slot edge */
+__STATIC_FORCEINLINE void ow_tim_done(ow_t *handle);
+
+#if (OW_TIM_SHARED == 1)
+/* Timer ticks from counter value to deadline, negative if passed */
+__STATIC_FORCEINLINE int32_t ow_tim_until(ow_t *handle, uint32_t cnt, uint32_t due);
+
+/* Remove bus from event list of its compare channel */
+__STATIC_FORCEINLINE void ow_tim_unlink(ow_t *handle);
+
+/* Program compare channel to earliest deadline of its event list, stop it if empty */
+__STATIC_FORCEINLINE void ow_tim_arm(ow_t *handle);
+#endif
+#else
+/* Preload next slot on timer channel */
+__STATIC_FORCEINLINE void ow_tim_slot(ow_t *handle, uint16_t low, uint16_t period);
+
+/* Preload next write or read slot of transfer */
+__STATIC_FORCEINLINE void ow_tim_xfer_slot(ow_t *handle, uint16_t slot_idx);
+
+/* Check presence pulse from captured edges of reset slot */
+__STATIC_FORCEINLINE bool ow_tim_presence(ow_t *handle);
+
+/* Start DMA of captured edges into capture buffer, capture keeps running */
+__STATIC_FORCEINLINE void ow_tim_cap_start(ow_t *handle, uint16_t len);
+
+/* Stop DMA of captured edges, capture keeps running */
+__STATIC_FORCEINLINE void ow_tim_cap_stop(ow_t *handle);
+
+#if (OW_MARGIN == 1)
+/* Store captured edge of one read slot */
+__STATIC_FORCEINLINE void ow_margin_slot(ow_t *handle, uint16_t edge, bool one);
+
+/* Capture both edges of reset slot by DMA */
+__STATIC_FORCEINLINE void ow_margin_rst(ow_t *handle);
+#endif
+#endif
+
+#if ((OW_STATS == 1) || (OW_TRACE == 1))
+/* Timer ticks from programmed event to now */
+__STATIC_FORCEINLINE uint16_t ow_tim_lat(ow_t *handle);
+#endif
+
+#if (OW_LANES > 1)
+/* Check presence pulse of each lane, true if any lane answered */
+__STATIC_FORCEINLINE bool ow_lane_presence(ow_t *handle);
+
+/* Sample all lanes with one port read and store read bit of each lane */
+__STATIC_FORCEINLINE void ow_lane_sample(ow_t *handle);
 #endif
 
 /* Write one bit on bus */
@@ -48,6 +229,143 @@ __STATIC_FORCEINLINE void ow_write_bit(ow_t *handle, bool high);
 
 /* Read one bit from bus */
 __STATIC_FORCEINLINE uint8_t ow_read_bit(ow_t *handle);
+#endif
+
+/*************************************************************************************************/
+/** Private Variables **/
+/*************************************************************************************************/
+
+#if (OW_BACKEND == OW_BACKEND_UART)
+/* Reset slot: one UART byte, the low bits form the reset pulse */
+static const uint32_t ow_uart_baud_rst[OW_SPEED_MAX] =
+{
+  9600,
+#if (OW_OVERDRIVE == 1)
+  115200,
+#endif
+};
+
+/* Reset slot byte per bus speed, the presence pulse changes its echo */
+static const uint8_t ow_uart_rst[OW_SPEED_MAX] =
+{
+  0xF0,
+#if (OW_OVERDRIVE == 1)
+  0xE0,
+#endif
+};
+
+/* Bit slots: one UART byte per slot, 0x00 writes 0, 0xFF writes 1 or reads */
+static const uint32_t ow_uart_baud_data[OW_SPEED_MAX] =
+{
+  115200,
+#if (OW_OVERDRIVE == 1)
+  1000000,
+#endif
+};
+#else
+/* Default slot timing per bus speed, in timer ticks */
+static const ow_tim_t ow_tim_default[OW_SPEED_MAX] =
+{
+  {
+    .rst          = OW_TIM_RST * OW_TIM_TICK_PER_US,
+    .rst_det      = OW_TIM_RST_DET * OW_TIM_TICK_PER_US,
+    .write_high   = OW_TIM_WRITE_HIGH * OW_TIM_TICK_PER_US,
+    .write_low    = OW_TIM_WRITE_LOW * OW_TIM_TICK_PER_US,
+    .read_low     = OW_TIM_READ_LOW * OW_TIM_TICK_PER_US,
+    .read_sample  = OW_TIM_READ_SAMPLE * OW_TIM_TICK_PER_US,
+    .read_high    = OW_TIM_READ_HIGH * OW_TIM_TICK_PER_US,
+  },
+#if (OW_OVERDRIVE == 1)
+  {
+    .rst          = OW_TIM_OD_RST * OW_TIM_TICK_PER_US,
+    .rst_det      = OW_TIM_OD_RST_DET * OW_TIM_TICK_PER_US,
+    .write_high   = OW_TIM_OD_WRITE_HIGH * OW_TIM_TICK_PER_US,
+    .write_low    = OW_TIM_OD_WRITE_LOW * OW_TIM_TICK_PER_US,
+    .read_low     = OW_TIM_OD_READ_LOW * OW_TIM_TICK_PER_US,
+    .read_sample  = OW_TIM_OD_READ_SAMPLE * OW_TIM_TICK_PER_US,
+    .read_high    = OW_TIM_OD_READ_HIGH * OW_TIM_TICK_PER_US,
+  },
+#endif
+};
+#endif
+
+#if (OW_RESUME == 1)
+/* Families keeping their selection for Resume command */
+static const uint8_t ow_resume_family[] = OW_RESUME_FAMILY;
+#endif
+
+#if (OW_CRC_TABLE == 256)
+/* CRC8 lookup table, polynomial x^8 + x^5 + x^4 + 1 (0x8C reflected) */
+static const uint8_t ow_crc8_table[256] =
+{
+  0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+  0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E, 0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC,
+  0x23, 0x7D, 0x9F, 0xC1, 0x42, 0x1C, 0xFE, 0xA0, 0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
+  0xBE, 0xE0, 0x02, 0x5C, 0xDF, 0x81, 0x63, 0x3D, 0x7C, 0x22, 0xC0, 0x9E, 0x1D, 0x43, 0xA1, 0xFF,
+  0x46, 0x18, 0xFA, 0xA4, 0x27, 0x79, 0x9B, 0xC5, 0x84, 0xDA, 0x38, 0x66, 0xE5, 0xBB, 0x59, 0x07,
+  0xDB, 0x85, 0x67, 0x39, 0xBA, 0xE4, 0x06, 0x58, 0x19, 0x47, 0xA5, 0xFB, 0x78, 0x26, 0xC4, 0x9A,
+  0x65, 0x3B, 0xD9, 0x87, 0x04, 0x5A, 0xB8, 0xE6, 0xA7, 0xF9, 0x1B, 0x45, 0xC6, 0x98, 0x7A, 0x24,
+  0xF8, 0xA6, 0x44, 0x1A, 0x99, 0xC7, 0x25, 0x7B, 0x3A, 0x64, 0x86, 0xD8, 0x5B, 0x05, 0xE7, 0xB9,
+  0x8C, 0xD2, 0x30, 0x6E, 0xED, 0xB3, 0x51, 0x0F, 0x4E, 0x10, 0xF2, 0xAC, 0x2F, 0x71, 0x93, 0xCD,
+  0x11, 0x4F, 0xAD, 0xF3, 0x70, 0x2E, 0xCC, 0x92, 0xD3, 0x8D, 0x6F, 0x31, 0xB2, 0xEC, 0x0E, 0x50,
+  0xAF, 0xF1, 0x13, 0x4D, 0xCE, 0x90, 0x72, 0x2C, 0x6D, 0x33, 0xD1, 0x8F, 0x0C, 0x52, 0xB0, 0xEE,
+  0x32, 0x6C, 0x8E, 0xD0, 0x53, 0x0D, 0xEF, 0xB1, 0xF0, 0xAE, 0x4C, 0x12, 0x91, 0xCF, 0x2D, 0x73,
+  0xCA, 0x94, 0x76, 0x28, 0xAB, 0xF5, 0x17, 0x49, 0x08, 0x56, 0xB4, 0xEA, 0x69, 0x37, 0xD5, 0x8B,
+  0x57, 0x09, 0xEB, 0xB5, 0x36, 0x68, 0x8A, 0xD4, 0x95, 0xCB, 0x29, 0x77, 0xF4, 0xAA, 0x48, 0x16,
+  0xE9, 0xB7, 0x55, 0x0B, 0x88, 0xD6, 0x34, 0x6A, 0x2B, 0x75, 0x97, 0xC9, 0x4A, 0x14, 0xF6, 0xA8,
+  0x74, 0x2A, 0xC8, 0x96, 0x15, 0x4B, 0xA9, 0xF7, 0xB6, 0xE8, 0x0A, 0x54, 0xD7, 0x89, 0x6B, 0x35,
+};
+
+/* CRC16 lookup table, polynomial x^16 + x^15 + x^2 + 1 (0xA001 reflected) */
+static const uint16_t ow_crc16_table[256] =
+{
+  0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+  0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+  0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+  0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+  0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+  0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+  0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+  0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+  0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+  0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+  0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+  0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+  0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+  0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+  0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+  0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+  0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+  0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+  0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+  0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+  0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+  0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+  0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+  0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+  0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+  0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+  0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+  0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+  0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+  0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+  0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+  0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040,
+};
+#else
+/* CRC8 nibble lookup table, polynomial x^8 + x^5 + x^4 + 1 (0x8C reflected) */
+static const uint8_t ow_crc8_table[16] =
+{
+  0x00, 0x9D, 0x23, 0xBE, 0x46, 0xDB, 0x65, 0xF8, 0x8C, 0x11, 0xAF, 0x32, 0xCA, 0x57, 0xE9, 0x74,
+};
+
+/* CRC16 nibble lookup table, polynomial x^16 + x^15 + x^2 + 1 (0xA001 reflected) */
+static const uint16_t ow_crc16_table[16] =
+{
+  0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+  0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400,
+};
+#endif
 
 /*************************************************************************************************/
 /** Function Implementations **/
@@ -55,7 +373,7 @@ __STATIC_FORCEINLINE uint8_t ow_read_bit(ow_t *handle);
 
 /*************************************************************************************************/
 /**
- * @brief  Initialize 1-Wire handle with GPIO and timer configuration.
+ * @brief  Initialize 1-Wire handle with GPIO and timer (or UART) configuration.
  * @param[in,out]  handle: Pointer to the 1-Wire handle to initialize.
  * @param[in]  init: Pointer to initialization data (GPIO, pin, timer, callback).
  */
@@ -63,6 +381,91 @@ void ow_init(ow_t *handle, const ow_init_t *init)
 {
   assert_param(handle != NULL);
   assert_param(init != NULL);
+
+#if (OW_QUEUE_LEN > 0)
+  /* Empty transaction queue */
+  handle->queue_head = 0;
+  handle->queue_cnt = 0;
+  handle->job_cb = NULL;
+#endif
+#if (OW_MAX_DEVICE > 1)
+  /* Empty ROM ID list, a table of caller is sized to its bus */
+#if (OW_ROM_TABLE == 1)
+  assert_param(init->rom_id_table != NULL);
+  assert_param((init->rom_id_max > 0) && (init->rom_id_max <= OW_MAX_DEVICE));
+  handle->rom_id = init->rom_id_table;
+  handle->rom_id_max = init->rom_id_max;
+#else
+  handle->rom_id_max = OW_MAX_DEVICE;
+#endif
+  handle->rom_id_found = 0;
+  memset(handle->rom_id, 0, handle->rom_id_max * sizeof(ow_id_t));
+#endif
+#if (OW_RESUME == 1)
+  handle->resume_id = OW_RESUME_NONE;
+#endif
+#if (OW_STATS == 1)
+  /* Clear counters, start DWT cycle counter if not running */
+  memset(&handle->stats, 0, sizeof(ow_stats_t));
+  handle->stats_t0 = 0;
+  handle->stats_isr = 0;
+  handle->stats_cyc = 0;
+  handle->stats_in_isr = false;
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+#endif
+#if (OW_TRACE == 1)
+  /* Empty trace ring */
+  handle->trace_head = 0;
+  handle->trace_cnt = 0;
+  handle->trace_time = 0;
+  handle->trace_hold = false;
+#endif
+#if (OW_RETRY == 1)
+  /* No check and retry until set */
+  handle->retry_check = OW_CHECK_NONE;
+  handle->retry_max = 0;
+  handle->retry_backoff = 0;
+  handle->retry_on = false;
+#endif
+#if (OW_CALIB == 1)
+  /* No compensation until calibrated */
+  memset(&handle->calib, 0, sizeof(ow_calib_t));
+  handle->calib_run = false;
+#endif
+#if (OW_BACKEND == OW_BACKEND_UART)
+  assert_param(init->uart_handle != NULL);
+  assert_param(init->uart_cb != NULL);
+
+  /* Save configuration */
+  handle->config.uart_handle = init->uart_handle;
+  handle->config.done_cb = init->done_cb;
+  handle->config.done_arg_cb = init->done_arg_cb;
+  handle->config.done_arg = init->done_arg;
+
+  /* ROM ID Filter, 0 == Accept All */
+#if (OW_MAX_DEVICE > 1)
+  handle->rom_id_filter = init->rom_id_filter;
+#endif
+
+  /* Cache baud rate registers of each slot type, BRR layout differs between families */
+  for (uint8_t speed = 0; speed < OW_SPEED_MAX; speed++)
+  {
+    handle->config.uart_handle->Init.BaudRate = ow_uart_baud_data[speed];
+    HAL_HalfDuplex_Init(handle->config.uart_handle);
+    handle->config.brr_data[speed] = handle->config.uart_handle->Instance->BRR;
+    handle->config.uart_handle->Init.BaudRate = ow_uart_baud_rst[speed];
+    HAL_HalfDuplex_Init(handle->config.uart_handle);
+    handle->config.brr_rst[speed] = handle->config.uart_handle->Instance->BRR;
+  }
+  handle->speed = OW_SPEED_STD;
+
+  /* Register user UART callback for slot echo and error events */
+  HAL_UART_RegisterCallback(handle->config.uart_handle, HAL_UART_RX_COMPLETE_CB_ID, init->uart_cb);
+  HAL_UART_RegisterCallback(handle->config.uart_handle, HAL_UART_ERROR_CB_ID, init->uart_cb);
+#else
   assert_param(init->tim_handle != NULL);
   assert_param(init->tim_cb != NULL);
 
@@ -74,6 +477,20 @@ void ow_init(ow_t *handle, const ow_init_t *init)
   handle->config.pin_reset = init->pin << 16UL;
   handle->config.pin_read = init->pin;
   handle->config.gpio = init->gpio;
+  handle->config.gpio_rx = init->gpio;
+  handle->config.pin_inv = 0;
+#if (OW_LANES > 1)
+  /* Each pin of the mask is one lane, lowest pin is lane 0 */
+  handle->lane_cnt = 0;
+  for (uint8_t bit = 0; bit < 16; bit++)
+  {
+    if (init->pin & (1UL << bit))
+    {
+      assert_param(handle->lane_cnt < OW_LANES);
+      handle->lane_pin[handle->lane_cnt++] = (uint16_t)(1UL << bit);
+    }
+  }
+#endif
 #else
   assert_param(init->gpio_tx != NULL);
   assert_param(init->gpio_rx != NULL);
@@ -88,51 +505,112 @@ void ow_init(ow_t *handle, const ow_init_t *init)
 #endif
   handle->config.gpio_rx = init->gpio_rx;
   handle->config.pin_read = init->pin_rx;
+  handle->config.pin_inv = (OW_INVERT_RX == 1) ? init->pin_rx : 0;
   handle->config.gpio = init->gpio_tx;
+#endif
+#if (OW_TIM_HW == 0)
+  /* Bus binding of ow.hpp, its pin mode may differ from OW_DUAL_PINS and OW_INVERT_TX/RX */
+  if (init->pins != NULL)
+  {
+    handle->config.gpio = init->pins->gpio;
+    handle->config.pin_set = init->pins->pin_set;
+    handle->config.pin_reset = init->pins->pin_reset;
+    handle->config.gpio_rx = init->pins->gpio_rx;
+    handle->config.pin_read = init->pins->pin_read;
+    handle->config.pin_inv = init->pins->pin_inv;
+  }
 #endif
   handle->config.tim_handle = init->tim_handle;
   handle->config.done_cb = init->done_cb;
+  handle->config.done_arg_cb = init->done_arg_cb;
+  handle->config.done_arg = init->done_arg;
 
   /* ROM ID Filter, 0 == Accept All */
 #if (OW_MAX_DEVICE > 1)
   handle->rom_id_filter = init->rom_id_filter;
 #endif
 
+  /* Load default slot timing, start at standard speed */
+  memcpy(handle->tim_table, ow_tim_default, sizeof(handle->tim_table));
+  handle->speed = OW_SPEED_STD;
+  handle->tim = &handle->tim_table[OW_SPEED_STD];
+
+#if (OW_TIM_SHARED == 1)
+  /* Timer counts free for all buses, buses of a compare channel take turns by deadline */
+  assert_param((init->tim_ch == TIM_CHANNEL_1) || (init->tim_ch == TIM_CHANNEL_2) ||
+               (init->tim_ch == TIM_CHANNEL_3) || (init->tim_ch == TIM_CHANNEL_4));
+  assert_param(__HAL_TIM_GET_AUTORELOAD(init->tim_handle) >= 0xFFFFUL);
+  handle->config.tim_ch = init->tim_ch;
+  handle->config.tim_active = HAL_TIM_ACTIVE_CHANNEL_1 << (init->tim_ch >> 2);
+  handle->config.tim_it = TIM_IT_CC1 << (init->tim_ch >> 2);
+  handle->config.tim_list = (init->tim_list != NULL) ? init->tim_list : &handle->tim_own;
+  handle->tim_own.head = NULL;
+  handle->tim_next = NULL;
+  handle->tim_linked = false;
+
+  TIM_OC_InitTypeDef oc = {0};
+  oc.OCMode = TIM_OCMODE_TIMING;
+  oc.Pulse = 0;
+  oc.OCPolarity = TIM_OCPOLARITY_HIGH;
+  oc.OCFastMode = TIM_OCFAST_DISABLE;
+  HAL_TIM_OC_ConfigChannel(handle->config.tim_handle, &oc, handle->config.tim_ch);
+
+  /* Register user timer callback for compare events, shared by all buses on timer */
+  HAL_TIM_RegisterCallback(handle->config.tim_handle, HAL_TIM_OC_DELAY_ELAPSED_CB_ID, init->tim_cb);
+#else
   /* Register user timer callback for timing events */
   HAL_TIM_RegisterCallback(handle->config.tim_handle, HAL_TIM_PERIOD_ELAPSED_CB_ID, init->tim_cb);
+#endif
 
+#if (OW_TIM_HW == 1)
+  /* Bus pin on PWM channel, rising edges captured by paired channel (CH1 <-> CH2, CH3 <-> CH4) */
+  assert_param((init->tim_ch == TIM_CHANNEL_1) || (init->tim_ch == TIM_CHANNEL_2) ||
+               (init->tim_ch == TIM_CHANNEL_3) || (init->tim_ch == TIM_CHANNEL_4));
+  handle->config.tim_ch_out = init->tim_ch;
+  handle->config.tim_ch_in = init->tim_ch ^ 0x04UL;
+
+  /* PWM mode 2: bus low while counter is below compare value, released after */
+  TIM_OC_InitTypeDef oc = {0};
+  oc.OCMode = TIM_OCMODE_PWM2;
+  oc.Pulse = 0;
+  oc.OCPolarity = TIM_OCPOLARITY_HIGH;
+  oc.OCFastMode = TIM_OCFAST_DISABLE;
+  HAL_TIM_PWM_ConfigChannel(handle->config.tim_handle, &oc, handle->config.tim_ch_out);
+
+  TIM_IC_InitTypeDef ic = {0};
+  ic.ICPolarity = TIM_ICPOLARITY_RISING;
+  ic.ICSelection = TIM_ICSELECTION_INDIRECTTI;
+  ic.ICPrescaler = TIM_ICPSC_DIV1;
+  ic.ICFilter = 0;
+  HAL_TIM_IC_ConfigChannel(handle->config.tim_handle, &ic, handle->config.tim_ch_in);
+
+  /* Edge times are 16-bit, DMA of capture channel must write halfwords (also on 32-bit TIM2/TIM5) */
+  handle->config.tim_dma = handle->config.tim_handle->hdma[TIM_DMA_ID_CC1 + (handle->config.tim_ch_in >> 2)];
+  assert_param(handle->config.tim_dma != NULL);
+  assert_param(handle->config.tim_dma->Init.MemDataAlignment == DMA_MDATAALIGN_HALFWORD);
+
+  /* Period and compare are preloaded, each update event starts the next slot */
+  SET_BIT(handle->config.tim_handle->Instance->CR1, TIM_CR1_ARPE);
+
+  /* Set bus to idle state (high) */
+  HAL_TIM_PWM_Start(handle->config.tim_handle, handle->config.tim_ch_out);
+#else
   /* Set bus to idle state (high) */
   ow_write_bit(handle, true);
+#endif
+#endif
 }
 
 /*************************************************************************************************/
 /**
- * @brief Handle 1-Wire timer callback and call state handlers.
+ * @brief Handle 1-Wire timer callback, runs slot ISR of ow_isr_impl.h.
  * @param[in] handle: Pointer to the 1-Wire handle.
  */
 void ow_callback(ow_t *handle)
 {
   assert_param(handle != NULL);
 
-  switch (handle->state)
-  {
-    /* Ongoing data transfer */
-    case OW_STATE_XFER:       
-      ow_state_xfer(handle);
-      break;
-
-#if (OW_MAX_DEVICE > 1)
-    /* ROM search operation */
-    case OW_STATE_SEARCH:     
-      ow_state_search(handle);
-      break;
-#endif
-
-    /* Any invalid state -> stop */
-    default:                  
-      ow_stop(handle);
-      break;
-  }
+  ow_isr(handle);
 }
 
 /*************************************************************************************************/
@@ -150,22 +628,69 @@ uint8_t ow_crc(const uint8_t *data, uint16_t len)
 
   while (len--)
   {
-    uint8_t inbyte = *data++;
-    for (uint8_t i = 8; i > 0; i--)
-    {
-      /* Compute CRC using polynomial x^8 + x^5 + x^4 + 1 (0x8C) */
-      uint8_t mix = (uint8_t)(crc ^ inbyte) & 0x01;
-      crc >>= 1;
-      if (mix)
-      {
-        crc ^= 0x8C;
-      }
-      inbyte >>= 1;
-    }
+    crc = ow_crc_update(crc, *data++);
+  }
+  return crc;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Update 8-bit CRC with one byte.
+ * @param[in] crc: CRC of previous bytes, 0 for the first byte.
+ * @param[in] data: Next data byte.
+ * @retval Updated CRC8 value.
+ */
+uint8_t ow_crc_update(uint8_t crc, uint8_t data)
+{
+#if (OW_CRC_TABLE == 256)
+  return ow_crc8_table[crc ^ data];
+#else
+  /* Two nibble steps per byte, low nibble first */
+  crc ^= data;
+  crc = (crc >> 4) ^ ow_crc8_table[crc & 0x0F];
+  return (crc >> 4) ^ ow_crc8_table[crc & 0x0F];
+#endif
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Calculate 16-bit CRC (polynomial 0xA001) for given data.
+ * @param[in] data: Pointer to the data buffer.
+ * @param[in] len: Length of the data in bytes.
+ * @retval Calculated CRC16 value, devices send it inverted.
+ */
+uint16_t ow_crc16(const uint8_t *data, uint16_t len)
+{
+  uint16_t crc = 0;
+  assert_param(data != NULL);
+  assert_param(len > 0);
+
+  while (len--)
+  {
+    crc = ow_crc16_update(crc, *data++);
   }
   return crc;
 }
 
+/*************************************************************************************************/
+/**
+ * @brief Update 16-bit CRC with one byte.
+ * @param[in] crc: CRC of previous bytes, 0 for the first byte.
+ * @param[in] data: Next data byte.
+ * @retval Updated CRC16 value.
+ */
+uint16_t ow_crc16_update(uint16_t crc, uint8_t data)
+{
+#if (OW_CRC_TABLE == 256)
+  return (crc >> 8) ^ ow_crc16_table[(crc ^ data) & 0xFF];
+#else
+  /* Two nibble steps per byte, low nibble first */
+  crc ^= data;
+  crc = (crc >> 4) ^ ow_crc16_table[crc & 0x0F];
+  return (crc >> 4) ^ ow_crc16_table[crc & 0x0F];
+#endif
+}
+
 /*************************************************************************************************/
 /**
  * @brief Check if 1-Wire bus is busy.
@@ -190,6 +715,30 @@ ow_err_t ow_last_error(ow_t *handle)
   return handle->error;
 }
 
+/*************************************************************************************************/
+/**
+ * @brief Stop running transfer or search and release the bus.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ *
+ * @details
+ * Done callbacks report OW_ERR_TIMEOUT and no retry is started. After return the transfer no
+ * longer writes into caller buffers. Queued transactions start as after any failed transfer.
+ */
+void ow_abort(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  /* Bus interrupt must not step the transfer while it stops */
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (handle->state != OW_STATE_IDLE)
+  {
+    handle->error = OW_ERR_TIMEOUT;
+    ow_stop(handle);
+  }
+  __set_PRIMASK(primask);
+}
+
 #if (OW_MAX_DEVICE == 1)
 /*************************************************************************************************/
 /**
@@ -201,6 +750,13 @@ ow_err_t ow_update_rom_id(ow_t *handle)
 {
   assert_param(handle != NULL);
 
+  /* Keep ongoing transfer, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
   do
   {
     /* Start 1-Wire communication */
@@ -232,34 +788,13 @@ ow_err_t ow_update_rom_id(ow_t *handle)
  * @brief Start search to update all ROM IDs on the 1-Wire bus.
  * @param[in] handle: Pointer to the 1-Wire handle.
  * @retval Last error code (ow_err_t)
+ *
+ * @details
+ * With a ROM ID filter, only the branch of that family is searched.
  */
 ow_err_t ow_update_rom_id(ow_t *handle)
 {
-  assert_param(handle != NULL);
-
-  do
-  {
-    /* Start 1-Wire communication */
-    handle->error = ow_start(handle);
-    if (handle->error != OW_ERR_NONE)
-    {
-      /* Stop bus if start failed */
-      ow_stop(handle);
-      break;
-    }
-
-    /* Prepare for ROM search */
-    handle->state = OW_STATE_SEARCH;
-    handle->buf.data[0] = OW_CMD_SEARCH_ROM;
-    handle->rom_id_found = 0;
-
-    /* Clear previous search and ROM ID data */
-    memset(&handle->search, 0, sizeof(ow_search_t));
-    memset(handle->rom_id, 0, sizeof(handle->rom_id));
-
-  } while (0);
-
-  return handle->error;
+  return ow_search_start(handle, OW_CMD_SEARCH_ROM, handle->rom_id_filter, OW_SEARCH_LIST);
 }
 #endif
 
@@ -277,6 +812,13 @@ ow_err_t ow_xfer(ow_t *handle, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w
 {
   assert_param(handle != NULL);
 
+  /* Keep ongoing transfer, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
   do
   {
     /* Check if w_data is NULL but requested write data */
@@ -308,6 +850,9 @@ ow_err_t ow_xfer(ow_t *handle, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w
 
     /* Skip ROM for single device */
     handle->buf.data[0] = OW_CMD_SKIP_ROM;
+#if (OW_RESUME == 1)
+    handle->resume_id = OW_RESUME_NONE;
+#endif
 
     /* Send function command */
     handle->buf.data[1] = fn_cmd;
@@ -328,53 +873,69 @@ ow_err_t ow_xfer(ow_t *handle, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w
 
     /* Set expected read length */
     handle->buf.read_len  = r_len;
+#if (OW_RETRY == 1)
+    ow_retry_arm(handle, 1);
+#endif
 
   } while (0);
 
   return handle->error;
 }
 
-#if (OW_MAX_DEVICE > 1)
 /*************************************************************************************************/
 /**
- * @brief Transfer a command and optional data to/from a specific 1-Wire device by ROM ID index.
+ * @brief Transfer a command by SKIP ROM, write and read data directly from/to caller buffers.
  * @param[in] handle Pointer to the 1-Wire handle structure.
- * @param[in] rom_id Index of the target ROM ID in the handle's rom_id array.
  * @param[in] fn_cmd Function or command byte to send.
- * @param[in] w_data Pointer to the data buffer to write (can be NULL if w_len is 0).
+ * @param[in] w_data Pointer to the data to write (can be NULL if w_len is 0), not copied.
  * @param[in] w_len Number of bytes to write from w_data (can be 0).
- * @param[in] r_len Number of bytes to read into the internal buffer (can be 0).
+ * @param[out] r_data Pointer to the buffer for read data (can be NULL if r_len is 0).
+ * @param[in] r_len Number of bytes to read into r_data (can be 0).
  * @retval Error code (ow_err_t).
+ *
+ * @details
+ * Both buffers must stay valid until the transfer is done. Lengths are not limited by
+ * OW_MAX_DATA_LEN, only by OW_XFER_BUF_MAX.
  */
-ow_err_t ow_xfer_by_id(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len, uint16_t r_len)
+ow_err_t ow_xfer_buf(ow_t *handle, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len, uint8_t *r_data,
+                     uint16_t r_len)
 {
   assert_param(handle != NULL);
 
+  /* Keep ongoing transfer, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
   do
   {
-    /* Check if w_data is NULL but requested write data */
-    if ((w_data == NULL) && (w_len > 0))
+    /* Check if a buffer is NULL but requested data */
+    if (((w_data == NULL) && (w_len > 0)) || ((r_data == NULL) && (r_len > 0)))
     {
       handle->error = OW_ERR_LEN;
       ow_stop(handle);
       break;
     }
 
-    /* Check if requested read/read length exceeds buffer */
-    if (w_len + r_len > OW_MAX_DATA_LEN)
+    /* Check if requested write/read length exceeds slot counters */
+    if ((uint32_t)w_len + (uint32_t)r_len > OW_XFER_BUF_MAX)
     {
       handle->error = OW_ERR_LEN;
       ow_stop(handle);
       break;
     }
+#if (OW_LANES > 1)
 
-    /* Validate ROM ID index */
-    if ((handle->rom_id_found == 0) || (rom_id >= handle->rom_id_found))
+    /* Responses of other lanes stay in handle */
+    if (r_len > OW_MAX_DATA_LEN)
     {
-      handle->error = OW_ERR_ROM_ID;
+      handle->error = OW_ERR_LEN;
       ow_stop(handle);
       break;
     }
+#endif
 
     /* Start 1-Wire communication */
     handle->error = ow_start(handle);
@@ -386,105 +947,2381 @@ ow_err_t ow_xfer_by_id(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, const uint8
 
     /* Prepare transfer buffer */
     handle->state = OW_STATE_XFER;
-    
-    /* Select device by ROM */
-    handle->buf.data[0] = OW_CMD_MATCH_ROM;
-    for (uint8_t idx = 0; idx < 8; idx++)
-    {
-      handle->buf.data[1 + idx] = handle->rom_id[rom_id].array[idx];
-    }
-    
-    /* Function command */
-    handle->buf.data[9] = fn_cmd;
 
-    /* Copy user data if provided */
-    if (w_data != NULL)
+    /* Skip ROM for single device, then function command */
+    handle->buf.data[0] = OW_CMD_SKIP_ROM;
+#if (OW_RESUME == 1)
+    handle->resume_id = OW_RESUME_NONE;
+#endif
+    handle->buf.data[1] = fn_cmd;
+    handle->buf.write_len = 2;
+
+    /* Caller data is shifted out and in directly by the ISR */
+    handle->buf.hdr_len = handle->buf.write_len;
+    handle->buf.w_ptr = w_data;
+    handle->buf.write_len += w_len;
+    handle->buf.r_ptr = r_data;
+    handle->buf.read_len = r_len;
+    if (r_len > 0)
     {
-      for (uint16_t idx = 0; idx < w_len; idx++)
-      {
-        handle->buf.data[10 + idx] = w_data[idx];
-      }
-      handle->buf.write_len = w_len + 10;
+      memset(r_data, 0, r_len);
     }
-    else
+#if (OW_RETRY == 1)
+    ow_retry_arm(handle, handle->buf.hdr_len - 1);
+#endif
+
+  } while (0);
+
+  return handle->error;
+}
+
+#if (OW_MAX_DEVICE > 1)
+/*************************************************************************************************/
+/**
+ * @brief Transfer a command and optional data to/from a specific 1-Wire device by ROM ID index.
+ * @param[in] handle Pointer to the 1-Wire handle structure.
+ * @param[in] rom_id Index of the target ROM ID in the handle's rom_id array.
+ * @param[in] fn_cmd Function or command byte to send.
+ * @param[in] w_data Pointer to the data buffer to write (can be NULL if w_len is 0).
+ * @param[in] w_len Number of bytes to write from w_data (can be 0).
+ * @param[in] r_len Number of bytes to read into the internal buffer (can be 0).
+ * @retval Error code (ow_err_t).
+ */
+ow_err_t ow_xfer_by_id(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len, uint16_t r_len)
+{
+  assert_param(handle != NULL);
+
+  /* Keep ongoing transfer, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
+  do
+  {
+    /* Check if w_data is NULL but requested write data */
+    if ((w_data == NULL) && (w_len > 0))
+    {
+      handle->error = OW_ERR_LEN;
+      ow_stop(handle);
+      break;
+    }
+
+    /* Check if requested read/read length exceeds buffer */
+    if (w_len + r_len > OW_MAX_DATA_LEN)
+    {
+      handle->error = OW_ERR_LEN;
+      ow_stop(handle);
+      break;
+    }
+
+    /* Lanes answer in lockstep, search and Match ROM need one lane */
+    if (OW_LANE_MULTI(handle))
+    {
+      handle->error = OW_ERR_LEN;
+      ow_stop(handle);
+      break;
+    }
+
+    /* Validate ROM ID index, departed devices leave an empty entry */
+    if ((handle->rom_id_found == 0) || (rom_id >= handle->rom_id_found) ||
+        (handle->rom_id[rom_id].rom_id_struct.family == 0))
+    {
+      handle->error = OW_ERR_ROM_ID;
+      ow_stop(handle);
+      break;
+    }
+
+    /* Start 1-Wire communication */
+    handle->error = ow_start(handle);
+    if (handle->error != OW_ERR_NONE)
+    {
+      ow_stop(handle);
+      break;
+    }
+
+    /* Prepare transfer buffer */
+    handle->state = OW_STATE_XFER;
+    
+    /* Select device by ROM, or Resume */
+    uint16_t hdr_len = ow_select(handle, rom_id);
+    
+    /* Function command */
+    handle->buf.data[hdr_len++] = fn_cmd;
+
+    /* Copy user data if provided */
+    if (w_data != NULL)
+    {
+      for (uint16_t idx = 0; idx < w_len; idx++)
+      {
+        handle->buf.data[hdr_len + idx] = w_data[idx];
+      }
+      handle->buf.write_len = w_len + hdr_len;
+    }
+    else
+    {
+      handle->buf.write_len = hdr_len;
+    }
+    
+    /* Set expected read length */
+    handle->buf.read_len  = r_len;
+#if (OW_RETRY == 1)
+    ow_retry_arm(handle, hdr_len - 1);
+#endif
+
+  } while (0);
+
+  return handle->error;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Transfer a command by ROM ID index, write and read data directly from/to caller buffers.
+ * @param[in] handle Pointer to the 1-Wire handle structure.
+ * @param[in] rom_id Index of the target ROM ID in the handle's rom_id array.
+ * @param[in] fn_cmd Function or command byte to send.
+ * @param[in] w_data Pointer to the data to write (can be NULL if w_len is 0), not copied.
+ * @param[in] w_len Number of bytes to write from w_data (can be 0).
+ * @param[out] r_data Pointer to the buffer for read data (can be NULL if r_len is 0).
+ * @param[in] r_len Number of bytes to read into r_data (can be 0).
+ * @retval Error code (ow_err_t).
+ *
+ * @details
+ * Both buffers must stay valid until the transfer is done. Lengths are not limited by
+ * OW_MAX_DATA_LEN, only by OW_XFER_BUF_MAX.
+ */
+ow_err_t ow_xfer_buf_by_id(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len,
+                           uint8_t *r_data, uint16_t r_len)
+{
+  assert_param(handle != NULL);
+
+  /* Keep ongoing transfer, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
+  do
+  {
+    /* Check if a buffer is NULL but requested data */
+    if (((w_data == NULL) && (w_len > 0)) || ((r_data == NULL) && (r_len > 0)))
+    {
+      handle->error = OW_ERR_LEN;
+      ow_stop(handle);
+      break;
+    }
+
+    /* Check if requested write/read length exceeds slot counters */
+    if ((uint32_t)w_len + (uint32_t)r_len > OW_XFER_BUF_MAX)
+    {
+      handle->error = OW_ERR_LEN;
+      ow_stop(handle);
+      break;
+    }
+
+    /* Lanes answer in lockstep, search and Match ROM need one lane */
+    if (OW_LANE_MULTI(handle))
+    {
+      handle->error = OW_ERR_LEN;
+      ow_stop(handle);
+      break;
+    }
+
+    /* Validate ROM ID index, departed devices leave an empty entry */
+    if ((handle->rom_id_found == 0) || (rom_id >= handle->rom_id_found) ||
+        (handle->rom_id[rom_id].rom_id_struct.family == 0))
+    {
+      handle->error = OW_ERR_ROM_ID;
+      ow_stop(handle);
+      break;
+    }
+
+    /* Start 1-Wire communication */
+    handle->error = ow_start(handle);
+    if (handle->error != OW_ERR_NONE)
+    {
+      ow_stop(handle);
+      break;
+    }
+
+    /* Prepare transfer buffer */
+    handle->state = OW_STATE_XFER;
+
+    /* Select device by ROM or Resume, then function command */
+    handle->buf.write_len = ow_select(handle, rom_id);
+    handle->buf.data[handle->buf.write_len++] = fn_cmd;
+
+    /* Caller data is shifted out and in directly by the ISR */
+    handle->buf.hdr_len = handle->buf.write_len;
+    handle->buf.w_ptr = w_data;
+    handle->buf.write_len += w_len;
+    handle->buf.r_ptr = r_data;
+    handle->buf.read_len = r_len;
+    if (r_len > 0)
+    {
+      memset(r_data, 0, r_len);
+    }
+#if (OW_RETRY == 1)
+    ow_retry_arm(handle, handle->buf.hdr_len - 1);
+#endif
+
+  } while (0);
+
+  return handle->error;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Get number of detected 1-Wire devices.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @retval Count of found devices, after ow_rescan() including empty entries of departed devices
+ */
+uint8_t ow_devices(ow_t *handle)
+{
+  assert_param(handle != NULL);
+  return handle->rom_id_found;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Search devices of one family only, other families are never traversed.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] family: Family code, 0 == all families.
+ * @retval Last error code (ow_err_t)
+ *
+ * @details
+ * Replaces the ROM ID list with the found devices.
+ */
+ow_err_t ow_search_family(ow_t *handle, uint8_t family)
+{
+  return ow_search_start(handle, OW_CMD_SEARCH_ROM, family, OW_SEARCH_LIST);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Search devices in alarm state by conditional search (0xEC).
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] family: Family code, 0 == all families.
+ * @retval Last error code (ow_err_t)
+ *
+ * @details
+ * Replaces the ROM ID list with the devices in alarm, ow_devices() is 0 if none.
+ */
+ow_err_t ow_search_alarm(ow_t *handle, uint8_t family)
+{
+  return ow_search_start(handle, OW_CMD_SEARCH_ALARM, family, OW_SEARCH_LIST);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Search bus and merge found devices into ROM ID list.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] cb: Called in ISR for each arrived and departed device, can be NULL.
+ * @retval Last error code (ow_err_t)
+ *
+ * @details
+ * The list stays valid during the search. Known devices keep their index, new devices take
+ * the first empty entry, departed devices leave an empty entry (family 0) at end of search.
+ * An empty bus reports all devices departed.
+ */
+ow_err_t ow_rescan(ow_t *handle, ow_change_cb_t cb)
+{
+  assert_param(handle != NULL);
+
+  /* Keep ongoing transfer, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+  handle->change_cb = cb;
+  return ow_search_start(handle, OW_CMD_SEARCH_ROM, handle->rom_id_filter, OW_SEARCH_MERGE);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Check if a known device is still on the bus, by one search pass along its ROM ID.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] rom_id: Index of the ROM ID to check.
+ * @retval Last error code (ow_err_t)
+ *
+ * @details
+ * When done, last error is OW_ERR_NONE if present, OW_ERR_ROM_ID or OW_ERR_RESET if not.
+ * The pass stops at the first bit where no device follows the ROM ID.
+ */
+ow_err_t ow_verify(ow_t *handle, uint8_t rom_id)
+{
+  assert_param(handle != NULL);
+
+  /* Keep ongoing transfer, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
+  do
+  {
+    /* Lanes answer in lockstep, search and Match ROM need one lane */
+    if (OW_LANE_MULTI(handle))
+    {
+      handle->error = OW_ERR_LEN;
+      ow_stop(handle);
+      break;
+    }
+
+    /* Validate ROM ID index */
+    if ((handle->rom_id_found == 0) || (rom_id >= handle->rom_id_found) ||
+        (handle->rom_id[rom_id].rom_id_struct.family == 0))
+    {
+      handle->error = OW_ERR_ROM_ID;
+      ow_stop(handle);
+      break;
+    }
+
+    if (ow_search_start(handle, OW_CMD_SEARCH_ROM, 0, OW_SEARCH_VERIFY) != OW_ERR_NONE)
+    {
+      break;
+    }
+
+    /* Whole ROM ID as previous path, discrepancy past bit 64 repeats it on every bit */
+    handle->search.target = rom_id;
+    memcpy(handle->search.rom_id, handle->rom_id[rom_id].array, 8);
+    handle->search.last_discrepancy = 65;
+#if (OW_SEARCH_RETRY > 0)
+    /* Repeated pass restores this path, not the empty one saved by ow_search_start() */
+    memcpy(handle->search.path, handle->search.rom_id, 8);
+#endif
+
+  } while (0);
+
+  return handle->error;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Store ROM ID list into a snapshot, e.g. in flash or backup RAM.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[out] snap: Snapshot buffer, OW_ROM_SNAP_LEN(ow_devices()) bytes.
+ * @param[in] snap_size: Size of snapshot buffer.
+ * @retval Snapshot length, 0 if buffer is too small or a search is running.
+ *
+ * @details
+ * Empty entries of departed devices are stored too, so indices are the same after restore.
+ */
+uint16_t ow_rom_export(ow_t *handle, uint8_t *snap, uint16_t snap_size)
+{
+  assert_param(handle != NULL);
+  assert_param(snap != NULL);
+
+  uint16_t len = OW_ROM_SNAP_LEN(handle->rom_id_found);
+  if ((handle->state == OW_STATE_SEARCH) || (snap_size < len))
+  {
+    return 0;
+  }
+
+  snap[0] = OW_ROM_SNAP_VER;
+  snap[1] = handle->rom_id_found;
+  memcpy(&snap[2], handle->rom_id, handle->rom_id_found * 8UL);
+  uint16_t crc = ow_crc16(snap, len - 2);
+  snap[len - 2] = (uint8_t)crc;
+  snap[len - 1] = (uint8_t)(crc >> 8);
+
+  return len;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Restore ROM ID list from a snapshot instead of a search.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] snap: Snapshot stored by ow_rom_export().
+ * @param[in] snap_len: Snapshot length.
+ * @retval OW_ERR_NONE, OW_ERR_LEN if version or length does not match, OW_ERR_CRC if snapshot or
+ *         a ROM ID is corrupted, OW_ERR_BUSY. ROM ID list is kept on error.
+ *
+ * @details
+ * Transfers by ROM ID index can start at once. ow_rescan() later keeps restored indices and
+ * reports devices that left or joined since the snapshot.
+ */
+ow_err_t ow_rom_import(ow_t *handle, const uint8_t *snap, uint16_t snap_len)
+{
+  assert_param(handle != NULL);
+  assert_param(snap != NULL);
+
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+  if ((snap_len < OW_ROM_SNAP_LEN(0)) || (snap[0] != OW_ROM_SNAP_VER) || (snap[1] > handle->rom_id_max) ||
+      (snap_len != OW_ROM_SNAP_LEN(snap[1])))
+  {
+    return OW_ERR_LEN;
+  }
+  if (ow_crc16(snap, snap_len - 2) != (uint16_t)(snap[snap_len - 2] | (snap[snap_len - 1] << 8)))
+  {
+    return OW_ERR_CRC;
+  }
+
+  /* Empty entries are all zero, CRC8 of them is zero too */
+  for (uint8_t idx = 0; idx < snap[1]; idx++)
+  {
+    if (ow_crc(&snap[2 + (idx * 8)], 8) != 0)
+    {
+      return OW_ERR_CRC;
+    }
+  }
+
+  memset(handle->rom_id, 0, handle->rom_id_max * sizeof(ow_id_t));
+  memcpy(handle->rom_id, &snap[2], snap[1] * 8UL);
+  handle->rom_id_found = snap[1];
+#if (OW_RESUME == 1)
+  handle->resume_id = OW_RESUME_NONE;
+#endif
+
+  return OW_ERR_NONE;
+}
+#endif
+
+/*************************************************************************************************/
+/**
+ * @brief Select the bus speed used by next transfers.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] speed: Bus speed. Standard speed reset returns all devices to standard speed.
+ * @retval Error code (ow_err_t).
+ */
+ow_err_t ow_set_speed(ow_t *handle, ow_speed_t speed)
+{
+  assert_param(handle != NULL);
+  assert_param(speed < OW_SPEED_MAX);
+
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+  handle->speed = speed;
+#if (OW_BACKEND == OW_BACKEND_TIM)
+  handle->tim = &handle->tim_table[speed];
+#endif
+
+  return OW_ERR_NONE;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Set done callback with handle and argument, e.g. to signal an RTOS object.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] cb: Callback, called in ISR after done_cb of ow_init_t, NULL to remove.
+ * @param[in] arg: Argument passed to cb.
+ * @retval Error code (ow_err_t).
+ */
+ow_err_t ow_set_done_cb(ow_t *handle, ow_done_cb_t cb, void *arg)
+{
+  assert_param(handle != NULL);
+
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+  handle->config.done_arg_cb = cb;
+  handle->config.done_arg = arg;
+
+  return OW_ERR_NONE;
+}
+
+#if (OW_BACKEND == OW_BACKEND_TIM)
+/*************************************************************************************************/
+/**
+ * @brief Replace the slot timing table of a bus speed, e.g. for long cables.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] speed: Bus speed of the table.
+ * @param[in] tim: Slot timing in timer ticks.
+ * @retval Error code (ow_err_t), OW_ERR_LEN if a field is 0 or a slot does not fit a 16-bit timer period.
+ */
+ow_err_t ow_set_timing(ow_t *handle, ow_speed_t speed, const ow_tim_t *tim)
+{
+  assert_param(handle != NULL);
+  assert_param(tim != NULL);
+  assert_param(speed < OW_SPEED_MAX);
+
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
+  /* A 0 phase programs ARR = 0xFFFF, reset (twice rst with OW_TIM_HW) and slots are one period */
+  if ((tim->rst == 0) || (tim->rst_det == 0) || (tim->write_high == 0) || (tim->write_low == 0) ||
+      (tim->read_low == 0) || (tim->read_sample == 0) || (tim->read_high == 0) ||
+      ((uint32_t)tim->rst * 2 > 0xFFFFUL) || ((uint32_t)tim->rst + tim->rst_det > 0xFFFFUL) ||
+      ((uint32_t)tim->write_high + tim->write_low > 0xFFFFUL) ||
+      ((uint32_t)tim->read_low + tim->read_sample + tim->read_high > 0xFFFFUL))
+  {
+    return OW_ERR_LEN;
+  }
+#if (OW_TIM_SHARED == 1)
+  /* Each phase is one deadline of the event list, within half the timer period */
+  if ((tim->rst > OW_TIM_SPAN) || (tim->rst_det > OW_TIM_SPAN) || (tim->write_high > OW_TIM_SPAN) ||
+      (tim->write_low > OW_TIM_SPAN) || (tim->read_low > OW_TIM_SPAN) || (tim->read_sample > OW_TIM_SPAN) ||
+      (tim->read_high > OW_TIM_SPAN))
+  {
+    return OW_ERR_LEN;
+  }
+#endif
+  handle->tim_table[speed] = *tim;
+
+  return OW_ERR_NONE;
+}
+#endif
+
+#if (OW_RETRY == 1)
+/*************************************************************************************************/
+/**
+ * @brief Set response check and retries of next ow_xfer() family transfers, queued ones included.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] check: CRC layout of response, a shorter response is not checked.
+ * @param[in] retry: Retries after missing presence pulse or CRC mismatch, 0 to only check.
+ * @param[in] backoff_us: Bus released before each retry (OW_BACKEND_TIM without OW_TIM_HW only).
+ * @retval Error code (ow_err_t).
+ *
+ * @details
+ * Retries run from ISR without the caller, done_cb reports only the final result,
+ * OW_ERR_CRC if the last attempt had a CRC mismatch. Searches and programs are not retried.
+ */
+ow_err_t ow_set_retry(ow_t *handle, ow_check_t check, uint8_t retry, uint16_t backoff_us)
+{
+  assert_param(handle != NULL);
+  assert_param(check <= OW_CHECK_CRC16);
+
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+  handle->retry_check = check;
+  handle->retry_max = retry;
+#if ((OW_BACKEND == OW_BACKEND_TIM) && (OW_TIM_HW == 0))
+  /* Backoff and presence detect delay form one timer period */
+  uint32_t ticks = (uint32_t)backoff_us * OW_TIM_TICK_PER_US;
+#if (OW_TIM_SHARED == 1)
+  uint32_t ticks_max = OW_TIM_SPAN;
+#else
+  uint32_t ticks_max = OW_TIM_SPAN - handle->tim_table[OW_SPEED_STD].rst_det;
+#endif
+  handle->retry_backoff = (uint16_t)((ticks > ticks_max) ? ticks_max : ticks);
+#else
+  (void)backoff_us;
+#endif
+
+  return OW_ERR_NONE;
+}
+#endif
+
+#if (OW_CALIB == 1)
+/*************************************************************************************************/
+/**
+ * @brief Measure edge offsets of ISR on this bus by a Read ROM transfer, compensate next slots.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @retval Error code (ow_err_t), result is applied when done_cb is called.
+ *
+ * @details
+ * Slot events are timer events, so a constant ISR latency moves all edges together and does
+ * not change slot timing. What changes it is the difference of latency and code path before
+ * each pin access: release edge behind pull-low edge shortens or stretches the low time,
+ * sample behind release edge moves the sample point. These differences are averaged over the
+ * transfer and subtracted from the event periods, slot length is kept.
+ * Read ROM only reads the ROM ID, with several devices the result is not used. done_cb may
+ * report OW_ERR_ROM_ID if offsets corrupted the reads, the compensation is applied anyway.
+ */
+ow_err_t ow_calibrate(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  /* Keep ongoing transfer, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
+  do
+  {
+    /* Start 1-Wire communication */
+    handle->error = ow_start(handle);
+    if (handle->error != OW_ERR_NONE)
+    {
+      ow_stop(handle);
+      break;
+    }
+
+    /* Read ROM: write and read slots, no device function */
+    handle->state = OW_STATE_XFER;
+#if (OW_RESUME == 1)
+    handle->resume_id = OW_RESUME_NONE;
+#endif
+    memset(handle->calib_sum, 0, sizeof(handle->calib_sum));
+    memset(handle->calib_cnt, 0, sizeof(handle->calib_cnt));
+    handle->calib.lat_max = 0;
+    handle->calib_run = true;
+    handle->buf.data[0] = OW_CMD_READ_ROM;
+    handle->buf.write_len = 1;
+    handle->buf.read_len = 8;
+
+  } while (0);
+
+  return handle->error;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Get edge offset compensation of bus.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[out] calib: Pointer to the copy.
+ */
+void ow_get_calib(ow_t *handle, ow_calib_t *calib)
+{
+  assert_param(handle != NULL);
+  assert_param(calib != NULL);
+
+  *calib = handle->calib;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Set edge offset compensation of bus, e.g. stored one, or zero to disable.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] calib: Pointer to the compensation.
+ * @retval Error code (ow_err_t).
+ */
+ow_err_t ow_set_calib(ow_t *handle, const ow_calib_t *calib)
+{
+  assert_param(handle != NULL);
+  assert_param(calib != NULL);
+
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+  handle->calib = *calib;
+
+  return OW_ERR_NONE;
+}
+#endif
+
+#if (OW_OVERDRIVE == 1)
+/*************************************************************************************************/
+/**
+ * @brief Switch all overdrive capable devices to overdrive speed by Overdrive Skip ROM.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @retval Error code (ow_err_t).
+ *
+ * @details
+ * The reset and command are sent at standard speed, next transfers run at overdrive
+ * until ow_set_speed(handle, OW_SPEED_STD) is called.
+ */
+ow_err_t ow_overdrive(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  /* Keep ongoing transfer, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
+  do
+  {
+    /* Overdrive ROM commands follow a standard speed reset */
+    handle->speed = OW_SPEED_STD;
+
+    /* Start 1-Wire communication */
+    handle->error = ow_start(handle);
+    if (handle->error != OW_ERR_NONE)
+    {
+      ow_stop(handle);
+      break;
+    }
+
+    /* Prepare transfer buffer */
+    handle->state = OW_STATE_XFER;
+
+    /* Overdrive Skip ROM, switch speed after command */
+    handle->buf.data[0] = OW_CMD_OD_SKIP_ROM;
+#if (OW_RESUME == 1)
+    handle->resume_id = OW_RESUME_NONE;
+#endif
+    handle->buf.write_len = 1;
+    handle->buf.od_idx = 1;
+
+  } while (0);
+
+  return handle->error;
+}
+
+#if (OW_MAX_DEVICE > 1)
+/*************************************************************************************************/
+/**
+ * @brief Switch a specific device to overdrive speed by Overdrive Match ROM.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] rom_id: Index of the target ROM ID in the handle's rom_id array.
+ * @retval Error code (ow_err_t).
+ *
+ * @details
+ * The reset and command are sent at standard speed, the ROM ID and next transfers
+ * at overdrive speed until ow_set_speed(handle, OW_SPEED_STD) is called.
+ */
+ow_err_t ow_overdrive_by_id(ow_t *handle, uint8_t rom_id)
+{
+  assert_param(handle != NULL);
+
+  /* Keep ongoing transfer, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
+  do
+  {
+    /* Lanes answer in lockstep, search and Match ROM need one lane */
+    if (OW_LANE_MULTI(handle))
+    {
+      handle->error = OW_ERR_LEN;
+      ow_stop(handle);
+      break;
+    }
+
+    /* Validate ROM ID index, departed devices leave an empty entry */
+    if ((handle->rom_id_found == 0) || (rom_id >= handle->rom_id_found) ||
+        (handle->rom_id[rom_id].rom_id_struct.family == 0))
+    {
+      handle->error = OW_ERR_ROM_ID;
+      ow_stop(handle);
+      break;
+    }
+
+    /* Overdrive ROM commands follow a standard speed reset */
+    handle->speed = OW_SPEED_STD;
+
+    /* Start 1-Wire communication */
+    handle->error = ow_start(handle);
+    if (handle->error != OW_ERR_NONE)
+    {
+      ow_stop(handle);
+      break;
+    }
+
+    /* Prepare transfer buffer */
+    handle->state = OW_STATE_XFER;
+
+    /* Overdrive Match ROM, ROM ID is always sent, at overdrive speed */
+#if (OW_RESUME == 1)
+    handle->resume_id = OW_RESUME_NONE;
+#endif
+    ow_select(handle, rom_id);
+    handle->buf.data[0] = OW_CMD_OD_MATCH_ROM;
+    handle->buf.write_len = 9;
+    handle->buf.od_idx = 1;
+
+  } while (0);
+
+  return handle->error;
+}
+#endif
+#endif
+
+#if (OW_PROG == 1)
+/*************************************************************************************************/
+/**
+ * @brief Run a transaction program: reset, ROM select, write, read and wait steps in one job.
+ * @param[in] handle Pointer to the 1-Wire handle structure.
+ * @param[in] prog Pointer to the program steps, not copied.
+ * @param[in] prog_cnt Number of steps.
+ * @retval Error code (ow_err_t).
+ *
+ * @details
+ * Steps run back-to-back from the ISR, a reset is sent only by OW_OP_RESET. Steps and their
+ * buffers must stay valid until the transfer is done, read data goes directly to r_data.
+ * ow_read_resp() returns the data of the last step if it is OW_OP_READ, else nothing.
+ * Waits are scheduled in chunks of up to 0xFFFF timer ticks, about 65 ms at 1 tick per us.
+ * OW_OP_READ_UNTIL_1/0 end with OW_ERR_TIMEOUT if the device stays busy for len slots.
+ */
+ow_err_t ow_xfer_prog(ow_t *handle, const ow_op_t *prog, uint8_t prog_cnt)
+{
+  ow_err_t ow_err = OW_ERR_NONE;
+  assert_param(handle != NULL);
+
+  /* Keep ongoing transfer, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
+  do
+  {
+    /* Check program before bus is touched */
+    if ((prog == NULL) || (prog_cnt == 0))
+    {
+      handle->error = OW_ERR_LEN;
+      ow_stop(handle);
+      break;
+    }
+    for (uint8_t idx = 0; idx < prog_cnt; idx++)
+    {
+      const ow_op_t *op = &prog[idx];
+      if ((op->op > OW_OP_READ_UNTIL_0) ||
+          ((op->op == OW_OP_WRITE) && (op->w_data == NULL)) ||
+          ((op->op == OW_OP_READ) && (op->r_data == NULL)) ||
+          ((op->len == 0) && (op->op >= OW_OP_WRITE)))
+      {
+        ow_err = OW_ERR_LEN;
+        break;
+      }
+#if (OW_MAX_DEVICE > 1)
+      if ((op->op == OW_OP_MATCH_ROM) && OW_LANE_MULTI(handle))
+      {
+        ow_err = OW_ERR_LEN;
+        break;
+      }
+      if ((op->op == OW_OP_MATCH_ROM) &&
+          ((handle->rom_id_found == 0) || (op->len >= handle->rom_id_found) ||
+           (handle->rom_id[op->len].rom_id_struct.family == 0)))
+      {
+        ow_err = OW_ERR_ROM_ID;
+        break;
+      }
+#endif
+      /* Dual pins: TX pin drives a transistor, strong pull-up needs its own circuit */
+      if ((op->op == OW_OP_PULLUP_MS) &&
+          ((handle->config.gpio_rx != handle->config.gpio) ||
+           ((handle->config.pin_set | handle->config.pin_reset) != (handle->config.pin_read | (handle->config.pin_read << 16UL)))))
+      {
+        ow_err = OW_ERR_BUS;
+        break;
+      }
+    }
+    if (ow_err != OW_ERR_NONE)
+    {
+      handle->error = ow_err;
+      ow_stop(handle);
+      break;
+    }
+
+    /* Start 1-Wire communication */
+    handle->error = ow_start(handle);
+    if (handle->error != OW_ERR_NONE)
+    {
+      ow_stop(handle);
+      break;
+    }
+
+    /* Raw ROM commands in program may change selection */
+    handle->state = OW_STATE_PROG;
+#if (OW_RESUME == 1)
+    handle->resume_id = OW_RESUME_NONE;
+#endif
+
+    /* First step starts at first timer event */
+    handle->prog = prog;
+    handle->prog_cnt = prog_cnt;
+    handle->prog_idx = 0;
+    ow_prog_next(handle);
+
+  } while (0);
+
+  return handle->error;
+}
+/*************************************************************************************************/
+/**
+ * @brief Send a command by Skip ROM, then poll read slots until the device sends 1.
+ * @param[in] handle Pointer to the 1-Wire handle structure.
+ * @param[in] fn_cmd Function command, e.g. DS18B20 Convert T (0x44).
+ * @param[in] interval_us Bus released between poll slots, 0 == back-to-back slots.
+ * @param[in] timeout_ms Poll time limit, ends with OW_ERR_TIMEOUT.
+ * @retval Error code (ow_err_t).
+ *
+ * @details
+ * The device keeps the bus low while busy, so the transfer is done within one poll
+ * period after it finished. At most 65535 poll slots are sent.
+ */
+ow_err_t ow_xfer_poll(ow_t *handle, uint8_t fn_cmd, uint16_t interval_us, uint16_t timeout_ms)
+{
+  assert_param(handle != NULL);
+
+  ow_op_t tail = ow_prog_poll_op(handle, interval_us, timeout_ms);
+
+  return ow_prog_cmd(handle, false, 0, fn_cmd, &tail);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Send a command by Skip ROM, then drive the bus high for parasite powered devices.
+ * @param[in] handle Pointer to the 1-Wire handle structure.
+ * @param[in] fn_cmd Function command, e.g. DS18B20 Convert T (0x44).
+ * @param[in] pullup_ms Strong pull-up time.
+ * @retval Error code (ow_err_t).
+ *
+ * @details
+ * The strong pull-up starts right after the last slot of the command.
+ */
+ow_err_t ow_xfer_pullup(ow_t *handle, uint8_t fn_cmd, uint16_t pullup_ms)
+{
+  ow_op_t tail = { OW_OP_PULLUP_MS, pullup_ms, NULL, NULL, 0 };
+
+  return ow_prog_cmd(handle, false, 0, fn_cmd, &tail);
+}
+
+#if (OW_MAX_DEVICE > 1)
+/*************************************************************************************************/
+/**
+ * @brief Send a command by ROM ID index, then poll read slots until the device sends 1.
+ * @param[in] handle Pointer to the 1-Wire handle structure.
+ * @param[in] rom_id Index of the target ROM ID.
+ * @param[in] fn_cmd Function command, e.g. DS18B20 Convert T (0x44).
+ * @param[in] interval_us Bus released between poll slots, 0 == back-to-back slots.
+ * @param[in] timeout_ms Poll time limit, ends with OW_ERR_TIMEOUT.
+ * @retval Error code (ow_err_t).
+ */
+ow_err_t ow_xfer_poll_by_id(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, uint16_t interval_us, uint16_t timeout_ms)
+{
+  assert_param(handle != NULL);
+
+  ow_op_t tail = ow_prog_poll_op(handle, interval_us, timeout_ms);
+
+  return ow_prog_cmd(handle, true, rom_id, fn_cmd, &tail);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Send a command by ROM ID index, then drive the bus high for parasite powered devices.
+ * @param[in] handle Pointer to the 1-Wire handle structure.
+ * @param[in] rom_id Index of the target ROM ID.
+ * @param[in] fn_cmd Function command, e.g. DS18B20 Convert T (0x44).
+ * @param[in] pullup_ms Strong pull-up time.
+ * @retval Error code (ow_err_t).
+ */
+ow_err_t ow_xfer_pullup_by_id(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, uint16_t pullup_ms)
+{
+  ow_op_t tail = { OW_OP_PULLUP_MS, pullup_ms, NULL, NULL, 0 };
+
+  return ow_prog_cmd(handle, true, rom_id, fn_cmd, &tail);
+}
+#endif
+#endif
+
+#if (OW_QUEUE_LEN > 0)
+/*************************************************************************************************/
+/**
+ * @brief Queue a transaction by Skip ROM, started as soon as the bus is free.
+ * @param[in] handle Pointer to the 1-Wire handle structure.
+ * @param[in] fn_cmd Function or command byte to send.
+ * @param[in] w_data Pointer to the data buffer to write, copied to the queue (can be NULL if w_len is 0).
+ * @param[in] w_len Number of bytes to write from w_data (can be 0).
+ * @param[in] r_len Number of bytes to read (can be 0).
+ * @param[in] cb Transaction done callback, can be NULL.
+ * @param[in] arg Argument passed to the callback.
+ * @retval Error code (ow_err_t), OW_ERR_BUSY if the queue is full.
+ *
+ * @details
+ * The next transaction starts from the ISR right after the previous one is done.
+ * Response data is valid inside the callback, read it by ow_read_resp().
+ */
+ow_err_t ow_queue_xfer(ow_t *handle, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len, uint16_t r_len,
+                       ow_job_cb_t cb, void *arg)
+{
+  return ow_queue_push(handle, OW_JOB_SKIP_ROM, fn_cmd, w_data, w_len, r_len, cb, arg);
+}
+
+#if (OW_MAX_DEVICE > 1)
+/*************************************************************************************************/
+/**
+ * @brief Queue a transaction by ROM ID index, started as soon as the bus is free.
+ * @param[in] handle Pointer to the 1-Wire handle structure.
+ * @param[in] rom_id Index of the target ROM ID, checked when the transaction starts.
+ * @param[in] fn_cmd Function or command byte to send.
+ * @param[in] w_data Pointer to the data buffer to write, copied to the queue (can be NULL if w_len is 0).
+ * @param[in] w_len Number of bytes to write from w_data (can be 0).
+ * @param[in] r_len Number of bytes to read (can be 0).
+ * @param[in] cb Transaction done callback, can be NULL.
+ * @param[in] arg Argument passed to the callback.
+ * @retval Error code (ow_err_t), OW_ERR_BUSY if the queue is full.
+ */
+ow_err_t ow_queue_xfer_by_id(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len,
+                             uint16_t r_len, ow_job_cb_t cb, void *arg)
+{
+  assert_param(rom_id != OW_JOB_SKIP_ROM);
+  return ow_queue_push(handle, rom_id, fn_cmd, w_data, w_len, r_len, cb, arg);
+}
+#endif
+
+/*************************************************************************************************/
+/**
+ * @brief Get number of queued transactions.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @retval Number of waiting transactions, running one not included.
+ */
+uint8_t ow_queue_count(ow_t *handle)
+{
+  assert_param(handle != NULL);
+  return handle->queue_cnt;
+}
+#endif
+
+/*************************************************************************************************/
+/**
+ * @brief Retrieve read response data from the 1-Wire buffer.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] data: Pointer to user buffer to store the response.
+ * @param[in] data_size: Size of the user buffer in bytes.
+ * @retval Number of bytes copied to the user buffer.
+ */
+uint16_t ow_read_resp(ow_t *handle, uint8_t *data, uint16_t data_size)
+{
+  assert_param(handle != NULL);
+  assert_param(data != NULL);
+
+  uint16_t len = handle->buf.read_len;
+
+  /* Adjust length if user buffer is smaller */
+  if (data_size < len)
+  {
+    len = data_size;
+  }
+
+  /* Defensive: ensure we do not read past internal buffer */
+  if ((handle->buf.r_ptr == NULL) &&
+      ((uint32_t)(handle->buf.write_len) + (uint32_t)len > sizeof(handle->buf.data)))
+  {
+    /* Truncate to available bytes */
+    if (handle->buf.write_len < sizeof(handle->buf.data))
+    {
+      len = (uint16_t)(sizeof(handle->buf.data) - (uint32_t)handle->buf.write_len);
+    }
+    else
+    {
+      return 0;
+    }
+  }
+
+  /* Copy response data from internal (or caller) buffer to user buffer */
+  for (uint16_t idx = 0; idx < len; ++idx)
+  {
+    data[idx] = *ow_buf_read(handle, idx);
+  }
+
+  return len;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Get CRC8 of last response data, computed while the bytes were received.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @retval CRC8 value, 0 when the response ends with its valid CRC8 byte.
+ */
+uint8_t ow_resp_crc(ow_t *handle)
+{
+  assert_param(handle != NULL);
+  return handle->buf.crc;
+}
+
+#if (OW_LANES > 1)
+/*************************************************************************************************/
+/**
+ * @brief Copy last response data of one lane to user buffer.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] lane: Lane index, in order of pins from lowest.
+ * @param[out] data: Pointer to user buffer.
+ * @param[in] data_size: Size of user buffer.
+ * @retval Number of bytes copied.
+ */
+uint16_t ow_read_resp_lane(ow_t *handle, uint8_t lane, uint8_t *data, uint16_t data_size)
+{
+  assert_param(handle != NULL);
+  assert_param(data != NULL);
+
+  if (lane >= handle->lane_cnt)
+  {
+    return 0;
+  }
+
+  /* Lane 0 response stays in transfer buffer */
+  if (lane == 0)
+  {
+    return ow_read_resp(handle, data, data_size);
+  }
+
+  uint16_t len = handle->buf.read_len;
+  if (data_size < len)
+  {
+    len = data_size;
+  }
+  memcpy(data, handle->lane_data[lane - 1], len);
+
+  return len;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Get last error of one lane.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] lane: Lane index, in order of pins from lowest.
+ * @retval OW_ERR_RESET if lane had no presence pulse, else last bus error.
+ */
+ow_err_t ow_lane_error(ow_t *handle, uint8_t lane)
+{
+  assert_param(handle != NULL);
+
+  if (lane >= handle->lane_cnt)
+  {
+    return OW_ERR_LEN;
+  }
+  if (handle->lane_absent & handle->lane_pin[lane])
+  {
+    return OW_ERR_RESET;
+  }
+  return handle->error;
+}
+#endif
+
+#if (OW_STATS == 1)
+/*************************************************************************************************/
+/**
+ * @brief Copy runtime counters of bus, optionally clear them.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[out] stats: Pointer to the copy, isr_cyc_avg is computed here.
+ * @param[in] clear: true to restart all counters.
+ *
+ * @details
+ * ISR cycles are counted from ow_callback() entry to its return, so done_cb and queued
+ * job callbacks called from ISR are included. ISR latency is in timer ticks from the
+ * programmed event to ow_callback() entry, 0 with OW_BACKEND_UART.
+ */
+void ow_stats(ow_t *handle, ow_stats_t *stats, bool clear)
+{
+  assert_param(handle != NULL);
+  assert_param(stats != NULL);
+
+  /* Counters are updated in ISR */
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  *stats = handle->stats;
+  if (clear)
+  {
+    memset(&handle->stats, 0, sizeof(ow_stats_t));
+  }
+  __set_PRIMASK(primask);
+
+  stats->isr_cyc_avg = (stats->isr_cnt > 0) ? (uint32_t)(stats->isr_cyc_sum / stats->isr_cnt) : 0;
+}
+#endif
+
+#if (OW_TRACE == 1)
+/*************************************************************************************************/
+/**
+ * @brief Copy timer events of trace ring, oldest first, and clear it.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[out] trace: Pointer to the copy.
+ * @param[in] trace_size: Entries of the copy, the newest events are copied if the ring holds more.
+ * @retval Number of copied events, 0 if bus is busy.
+ *
+ * @details
+ * One event per ow_callback() call, for transfers, programs and searches. After a failed
+ * transaction the ring stops recording, so its last events stay until they are read.
+ * Use ow_trace_decode() of ow_trace.h to rebuild slot timings.
+ */
+uint16_t ow_trace_read(ow_t *handle, ow_trace_t *trace, uint16_t trace_size)
+{
+  assert_param(handle != NULL);
+  assert_param(trace != NULL);
+
+  uint16_t cnt = 0;
+  if (handle->state == OW_STATE_IDLE)
+  {
+    cnt = (handle->trace_cnt < trace_size) ? handle->trace_cnt : trace_size;
+    uint16_t idx = (uint16_t)((handle->trace_head - cnt) & (OW_TRACE_LEN - 1));
+    for (uint16_t i = 0; i < cnt; i++)
+    {
+      trace[i] = handle->trace[idx];
+      idx = (idx + 1) & (OW_TRACE_LEN - 1);
+    }
+    handle->trace_cnt = 0;
+    handle->trace_hold = false;
+  }
+
+  return cnt;
+}
+#endif
+
+#if (OW_MARGIN == 1)
+/*************************************************************************************************/
+/**
+ * @brief Copy edge timing of last transaction, from input capture of each read slot.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[out] margin: Pointer to the copy.
+ * @retval Error code (ow_err_t).
+ *
+ * @details
+ * After ow_xfer_by_id() the read slots are all from one device, so they are its response and
+ * release times. The current safe window is rise_max .. hold_min around the sample point
+ * read_low + read_sample, a window that shrinks over time points to a drifting device or cable.
+ * The reset slot is captured on both edges, presence_start and presence_width are those of the
+ * last reset, 0 if no device answered.
+ */
+ow_err_t ow_margin(ow_t *handle, ow_margin_t *margin)
+{
+  assert_param(handle != NULL);
+  assert_param(margin != NULL);
+
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+  *margin = handle->margin;
+
+  return OW_ERR_NONE;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Move read sample point of current speed to earliest safe tick of last transaction.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] guard: Timer ticks kept to latest read 1 and earliest read 0.
+ * @retval OW_ERR_NONE, OW_ERR_BUSY, or OW_ERR_BUS if last transaction had no read 0 and read 1
+ *         slot or their edges are closer than 2 * guard.
+ *
+ * @details
+ * The sample point is only the decode threshold of captured edges, read_high takes the
+ * difference, so slot length and device timing stay the same.
+ */
+ow_err_t ow_margin_tune(ow_t *handle, uint16_t guard)
+{
+  assert_param(handle != NULL);
+
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
+  ow_margin_t *margin = &handle->margin;
+  uint32_t sample = (uint32_t)margin->rise_max + guard;
+  if ((margin->ones == 0) || (margin->zeros == 0) || (sample + guard > margin->hold_min))
+  {
+    return OW_ERR_BUS;
+  }
+
+  ow_tim_t *tim = &handle->tim_table[handle->speed];
+  uint32_t slot = tim->read_low + tim->read_sample + tim->read_high;
+  if ((sample <= tim->read_low) || (sample >= slot))
+  {
+    return OW_ERR_BUS;
+  }
+  tim->read_sample = (uint16_t)(sample - tim->read_low);
+  tim->read_high = (uint16_t)(slot - sample);
+
+  return OW_ERR_NONE;
+}
+#endif
+
+/*************************************************************************************************/
+/** Private Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief Set bus state idle, call done callbacks and start next queued transaction.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ */
+void ow_done(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  /* Set state to idle */
+  handle->state = OW_STATE_IDLE;
+
+#if (OW_RETRY == 1)
+  /* Failed attempt is not reported, transfer runs again */
+  if (handle->retry_on && ow_retry(handle))
+  {
+    return;
+  }
+#endif
+
+#if (OW_STATS == 1)
+  /* Counted before a callback starts the next transaction */
+  ow_stats_done(handle);
+  handle->stats.xfer++;
+  if (handle->error == OW_ERR_NONE)
+  {
+    handle->stats.bits_tx += handle->buf.write_len * 8UL;
+    handle->stats.bits_rx += handle->buf.read_len * 8UL;
+  }
+  else
+  {
+    handle->stats.xfer_err++;
+    if (handle->error == OW_ERR_RESET)
+    {
+      handle->stats.reset_err++;
+    }
+  }
+#endif
+
+#if (OW_TRACE == 1)
+  /* Keep events of failed transaction until read */
+  if (handle->error != OW_ERR_NONE)
+  {
+    handle->trace_hold = true;
+  }
+#endif
+
+#if (OW_MAX_DEVICE > 1)
+  /* Rescan done, report departed devices */
+  if (handle->search.mode == OW_SEARCH_MERGE)
+  {
+    ow_search_merge_end(handle);
+  }
+#endif
+
+#if (OW_RESUME == 1)
+  /* Failed transfer may have left another device selected */
+  if (handle->error != OW_ERR_NONE)
+  {
+    handle->resume_id = OW_RESUME_NONE;
+  }
+#endif
+
+#if (OW_CALIB == 1)
+  /* Calibration transfer done, use measured offsets */
+  if (handle->calib_run)
+  {
+    ow_calib_end(handle);
+  }
+#endif
+
+  /* Call user callbacks if registered */
+  if (handle->config.done_cb != NULL)
+  {
+    handle->config.done_cb(handle->error);
+  }
+  if (handle->config.done_arg_cb != NULL)
+  {
+    handle->config.done_arg_cb(handle, handle->error, handle->config.done_arg);
+  }
+
+#if (OW_QUEUE_LEN > 0)
+  /* Transaction callback, consumed before next transaction can set a new one */
+  if (handle->job_cb != NULL)
+  {
+    ow_job_cb_t cb = handle->job_cb;
+    handle->job_cb = NULL;
+    cb(handle, handle->error, handle->job_arg);
+  }
+
+  /* Chain next transaction without returning to caller */
+  if (handle->state == OW_STATE_IDLE)
+  {
+    ow_queue_next(handle);
+  }
+#endif
+}
+
+#if (OW_RETRY == 1)
+/*************************************************************************************************/
+/**
+ * @brief Keep prepared transfer for retry, if check or retry is set.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ * @param[in] fn_idx Index of function command in write bytes, after ROM command.
+ */
+__STATIC_FORCEINLINE void ow_retry_arm(ow_t *handle, uint16_t fn_idx)
+{
+  handle->retry_on = (handle->retry_max > 0) || (handle->retry_check != OW_CHECK_NONE);
+  if (handle->retry_on)
+  {
+    handle->retry_left = handle->retry_max;
+    handle->retry_fn_idx = fn_idx;
+    handle->retry_buf = handle->buf;
+  }
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Check response of finished transfer, start it again on missing presence or CRC mismatch.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ * @retval true if transfer runs again, false if it is reported.
+ */
+bool ow_retry(ow_t *handle)
+{
+  /* Response check, a shorter response has no CRC */
+  if (handle->error == OW_ERR_NONE)
+  {
+    if (((handle->retry_check == OW_CHECK_CRC8) && (handle->buf.read_len >= 1) && (handle->buf.crc != 0)) ||
+        ((handle->retry_check == OW_CHECK_CRC16) && (handle->buf.read_len >= 2) &&
+         (ow_retry_crc16(handle) != OW_CRC16_RESIDUAL)))
+    {
+      handle->error = OW_ERR_CRC;
+    }
+  }
+
+  if (((handle->error != OW_ERR_RESET) && (handle->error != OW_ERR_CRC)) || (handle->retry_left == 0))
+  {
+    handle->retry_on = false;
+    return false;
+  }
+
+  /* Bus stuck low, report it */
+#if (OW_STATS == 1)
+  uint32_t stats_t0 = handle->stats_t0;
+#endif
+  ow_err_t ow_err = ow_start(handle);
+#if (OW_STATS == 1)
+  handle->stats_t0 = stats_t0;
+#endif
+  if (ow_err != OW_ERR_NONE)
+  {
+    handle->error = ow_err;
+    handle->retry_on = false;
+    return false;
+  }
+
+  /* Same transfer, read data cleared by ow_start() or here */
+  handle->retry_left--;
+  handle->buf = handle->retry_buf;
+  if (handle->buf.r_ptr != NULL)
+  {
+    memset(handle->buf.r_ptr, 0, handle->buf.read_len);
+  }
+  handle->state = OW_STATE_XFER;
+  handle->error = OW_ERR_NONE;
+  OW_STATS_INC(handle, retry);
+
+#if ((OW_BACKEND == OW_BACKEND_TIM) && (OW_TIM_HW == 0))
+  /* Bus stays released for backoff before the reset pulse */
+  if (handle->retry_backoff > 0)
+  {
+#if (OW_TIM_SHARED == 1)
+    ow_tim_next(handle, handle->retry_backoff);
+    ow_tim_sched(handle);
+#else
+    ow_tim_next(handle, handle->tim->rst_det + handle->retry_backoff);
+#endif
+  }
+#endif
+
+  return true;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief CRC16 of function command, write and read bytes of transfer.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ * @retval CRC16, OW_CRC16_RESIDUAL if response ends with a valid inverted CRC16.
+ */
+__STATIC_FORCEINLINE uint16_t ow_retry_crc16(ow_t *handle)
+{
+  uint16_t crc = 0;
+
+  for (uint16_t idx = handle->retry_fn_idx; idx < handle->buf.write_len; idx++)
+  {
+    crc = ow_crc16_update(crc, ow_buf_write(handle, idx));
+  }
+  for (uint16_t idx = 0; idx < handle->buf.read_len; idx++)
+  {
+    crc = ow_crc16_update(crc, *ow_buf_read(handle, idx));
+  }
+  return crc;
+}
+#endif
+
+#if (OW_QUEUE_LEN > 0)
+/*************************************************************************************************/
+/**
+ * @brief Pop and start next queued transaction, called with bus idle in ISR or critical section.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ */
+void ow_queue_next(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  if (handle->queue_cnt == 0)
+  {
+    return;
+  }
+
+  /* Buffer is copied by ow_xfer() before slot can be reused */
+  ow_job_t *job = &handle->queue[handle->queue_head];
+  handle->queue_head = (handle->queue_head + 1) % OW_QUEUE_LEN;
+  handle->queue_cnt--;
+  handle->job_cb = job->cb;
+  handle->job_arg = job->arg;
+
+  /* Start failure calls ow_stop(), its callback reports the error and starts next one */
+#if (OW_MAX_DEVICE > 1)
+  if (job->rom_id != OW_JOB_SKIP_ROM)
+  {
+    ow_xfer_by_id(handle, job->rom_id, job->fn_cmd, job->w_data, job->w_len, job->r_len);
+    return;
+  }
+#endif
+  ow_xfer(handle, job->fn_cmd, job->w_data, job->w_len, job->r_len);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Add transaction to queue, start it if bus is free.
+ * @param[in] handle Pointer to the 1-Wire handle structure.
+ * @param[in] rom_id Index of the target ROM ID, or OW_JOB_SKIP_ROM.
+ * @param[in] fn_cmd Function or command byte to send.
+ * @param[in] w_data Pointer to the data buffer to write (can be NULL if w_len is 0).
+ * @param[in] w_len Number of bytes to write from w_data (can be 0).
+ * @param[in] r_len Number of bytes to read (can be 0).
+ * @param[in] cb Transaction done callback, can be NULL.
+ * @param[in] arg Argument passed to the callback.
+ * @retval Error code (ow_err_t).
+ */
+ow_err_t ow_queue_push(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len,
+                       uint16_t r_len, ow_job_cb_t cb, void *arg)
+{
+  ow_err_t ow_err = OW_ERR_NONE;
+  assert_param(handle != NULL);
+
+  do
+  {
+    /* Check if w_data is NULL but requested write data */
+    if ((w_data == NULL) && (w_len > 0))
+    {
+      ow_err = OW_ERR_LEN;
+      break;
+    }
+
+    /* Check if requested read/read length exceeds buffer */
+    if (w_len + r_len > OW_MAX_DATA_LEN)
+    {
+      ow_err = OW_ERR_LEN;
+      break;
+    }
+
+    /* Lanes answer in lockstep, Match ROM needs one lane */
+    if ((rom_id != OW_JOB_SKIP_ROM) && OW_LANE_MULTI(handle))
+    {
+      ow_err = OW_ERR_LEN;
+      break;
+    }
+
+    /* Queue is shared with ISR */
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (handle->queue_cnt == OW_QUEUE_LEN)
+    {
+      OW_STATS_INC(handle, busy);
+      __set_PRIMASK(primask);
+      ow_err = OW_ERR_BUSY;
+      break;
+    }
+
+    ow_job_t *job = &handle->queue[(handle->queue_head + handle->queue_cnt) % OW_QUEUE_LEN];
+    job->cb = cb;
+    job->arg = arg;
+    job->rom_id = rom_id;
+    job->fn_cmd = fn_cmd;
+    job->w_len = w_len;
+    job->r_len = r_len;
+    if (w_len > 0)
+    {
+      memcpy(job->w_data, w_data, w_len);
+    }
+    handle->queue_cnt++;
+
+    /* Bus is free, start now */
+    if (handle->state == OW_STATE_IDLE)
+    {
+      ow_queue_next(handle);
+    }
+
+    __set_PRIMASK(primask);
+
+  } while (0);
+
+  return ow_err;
+}
+#endif
+
+#if (OW_TIM_SHARED == 1)
+/*************************************************************************************************/
+/**
+ * @brief Move bus to its next deadline in the event list of its compare channel.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ *
+ * @details
+ * Buses of a channel are kept sorted by deadline, the channel compares with the earliest one.
+ * Deadlines are compared relative to now, so all of them must lie within half a timer period.
+ * Called with interrupts of the timer masked, from its ISR or ow_start().
+ */
+void ow_tim_sched(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  uint32_t cnt = __HAL_TIM_GET_COUNTER(handle->config.tim_handle);
+  int32_t until = ow_tim_until(handle, cnt, handle->tim_due);
+
+  /* Insert after all buses due earlier or at same time */
+  ow_tim_unlink(handle);
+  ow_t **link = &handle->config.tim_list->head;
+  while ((*link != NULL) && (ow_tim_until(handle, cnt, (*link)->tim_due) <= until))
+  {
+    link = &(*link)->tim_next;
+  }
+  handle->tim_next = *link;
+  *link = handle;
+  handle->tim_linked = true;
+
+  ow_tim_arm(handle);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Remove bus from the event list of its compare channel.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ */
+__STATIC_FORCEINLINE void ow_tim_unlink(ow_t *handle)
+{
+  ow_t **link = &handle->config.tim_list->head;
+  while (*link != NULL)
+  {
+    if (*link == handle)
+    {
+      *link = handle->tim_next;
+      break;
+    }
+    link = &(*link)->tim_next;
+  }
+  handle->tim_linked = false;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Program compare channel of bus to earliest deadline of its event list, stop it if empty.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ *
+ * @details
+ * A deadline already passed, e.g. while another bus of the channel was served, would only
+ * match after the counter wraps, so its compare event is generated at once.
+ */
+__STATIC_FORCEINLINE void ow_tim_arm(ow_t *handle)
+{
+  TIM_HandleTypeDef *tim_handle = handle->config.tim_handle;
+  ow_t *head = handle->config.tim_list->head;
+  if (head == NULL)
+  {
+    HAL_TIM_OC_Stop_IT(tim_handle, handle->config.tim_ch);
+    return;
+  }
+  __HAL_TIM_SET_COMPARE(tim_handle, handle->config.tim_ch, head->tim_due);
+  if (ow_tim_until(handle, __HAL_TIM_GET_COUNTER(tim_handle), head->tim_due) <= 0)
+  {
+    HAL_TIM_GenerateEvent(tim_handle, TIM_EVENTSOURCE_CC1 << (handle->config.tim_ch >> 2));
+  }
+}
+#endif
+
+#if ((OW_BACKEND == OW_BACKEND_TIM) && (OW_TIM_HW == 0))
+/*************************************************************************************************/
+/**
+ * @brief Start a 1-Wire transfer on the bus.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @retval OW_ERR_NONE on success, or error code (OW_ERR_BUSY, OW_ERR_BUS).
+ */
+ow_err_t ow_start(ow_t *handle)
+{
+  ow_err_t ow_err = OW_ERR_NONE;
+  assert_param(handle != NULL);
+
+  do
+  {
+    /* Ensure bus is idle before starting transfer */
+    if (handle->state != OW_STATE_IDLE)
+    {
+      ow_err = OW_ERR_BUSY;
+      break;
+    }
+
+    /* Pull bus high and check if line is idle, pins of handle (also of an ow.hpp binding) */
+    ow_write_bit(handle, true);
+    if (((handle->config.gpio_rx->IDR ^ handle->config.pin_inv) & handle->config.pin_read) != handle->config.pin_read)
+    {
+      ow_err = OW_ERR_BUS;
+      break;
+    }
+
+    /* Clear timer interrupt and reset internal buffer */
+#if (OW_TIM_SHARED == 0)
+    __HAL_TIM_CLEAR_IT(handle->config.tim_handle, 0xFFFFFFFFUL);
+#endif
+    memset(&handle->buf, 0, sizeof(ow_buf_t));
+#if (OW_STATS == 1)
+    handle->stats_t0 = OW_CYCLES();
+#endif
+#if (OW_LANES > 1)
+    memset(handle->lane_data, 0, sizeof(handle->lane_data));
+    handle->lane_absent = 0;
+#endif
+
+    /* Reset pulse at selected bus speed */
+    handle->tim = &handle->tim_table[handle->speed];
+
+    /* Configure timer for reset detection */
+#if (OW_TIM_SHARED == 1)
+    /* Timer counts free for all buses, first event from now, channel started by its first bus */
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool tim_start = (handle->config.tim_list->head == NULL);
+    if (tim_start)
+    {
+      __HAL_TIM_CLEAR_IT(handle->config.tim_handle, handle->config.tim_it);
+    }
+    handle->tim_due = __HAL_TIM_GET_COUNTER(handle->config.tim_handle);
+    ow_tim_next(handle, handle->tim->rst_det);
+    ow_tim_sched(handle);
+    if (tim_start)
+    {
+      HAL_TIM_OC_Start_IT(handle->config.tim_handle, handle->config.tim_ch);
+    }
+    __set_PRIMASK(primask);
+#else
+    __HAL_TIM_SET_COUNTER(handle->config.tim_handle, 0);
+    __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, handle->tim->rst_det - 1);
+    HAL_TIM_Base_Start_IT(handle->config.tim_handle);
+#endif
+#if (OW_TRACE == 1)
+    /* Trace times count from first event */
+    handle->trace_time = 0;
+#endif
+
+  } while (0);
+
+  return ow_err;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Stop 1-Wire transfer and release the bus.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ */
+void ow_stop(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  /* Stop timer interrupts */
+#if (OW_TIM_SHARED == 1)
+  /* Leave event list, channel runs on for other buses */
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (handle->tim_linked)
+  {
+    ow_tim_unlink(handle);
+    ow_tim_arm(handle);
+  }
+  __set_PRIMASK(primask);
+#else
+  HAL_TIM_Base_Stop_IT(handle->config.tim_handle);
+#endif
+
+  /* Release bus (set high) */
+  ow_write_bit(handle, true);
+
+  /* Set state to idle, report and start next queued transaction */
+  ow_done(handle);
+}
+
+#if (OW_PROG == 1)
+/*************************************************************************************************/
+/**
+ * @brief Build poll step, slot count from timeout and time of one poll period.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ * @param[in] interval_us Bus released between poll slots.
+ * @param[in] timeout_ms Poll time limit.
+ * @retval OW_OP_READ_UNTIL_1 step, at most 65535 slots.
+ */
+__STATIC_FORCEINLINE ow_op_t ow_prog_poll_op(ow_t *handle, uint16_t interval_us, uint16_t timeout_ms)
+{
+  const ow_tim_t *tim = &handle->tim_table[handle->speed];
+  uint32_t period = ((tim->read_low + tim->read_sample + tim->read_high) / OW_TIM_TICK_PER_US) + interval_us;
+  uint32_t slots = ((timeout_ms * 1000UL) / period) + 1;
+  ow_op_t op = { OW_OP_READ_UNTIL_1, (uint16_t)((slots > 0xFFFF) ? 0xFFFF : slots), NULL, NULL, interval_us };
+
+  return op;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Run reset, ROM select and function command, followed by one poll or pull-up step.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ * @param[in] by_id true to select ROM ID index, false for Skip ROM.
+ * @param[in] rom_id Index of the target ROM ID.
+ * @param[in] fn_cmd Function command.
+ * @param[in] tail Step after the command, copied.
+ * @retval Error code (ow_err_t).
+ */
+ow_err_t ow_prog_cmd(ow_t *handle, bool by_id, uint8_t rom_id, uint8_t fn_cmd, const ow_op_t *tail)
+{
+  assert_param(handle != NULL);
+
+  /* Keep ongoing transfer and its program, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
+
+  /* Program lives in handle, command byte is written from it */
+  handle->prog_cmd = fn_cmd;
+  memset(handle->prog_op, 0, sizeof(handle->prog_op));
+  handle->prog_op[0].op = OW_OP_RESET;
+  handle->prog_op[1].op = OW_OP_SKIP_ROM;
+#if (OW_MAX_DEVICE > 1)
+  if (by_id)
+  {
+    handle->prog_op[1].op = OW_OP_MATCH_ROM;
+    handle->prog_op[1].len = rom_id;
+  }
+#else
+  (void)by_id;
+  (void)rom_id;
+#endif
+  handle->prog_op[2].op = OW_OP_WRITE;
+  handle->prog_op[2].len = 1;
+  handle->prog_op[2].w_data = &handle->prog_cmd;
+  handle->prog_op[3] = *tail;
+
+  return ow_xfer_prog(handle, handle->prog_op, 4);
+}
+#endif
+
+#if (OW_CALIB == 1)
+/*************************************************************************************************/
+/**
+ * @brief Compute edge offset compensation from averaged offsets at end of calibration.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ *
+ * @details
+ * Each difference is limited to half of the shortest slot phase, so no period gets below one tick.
+ */
+void ow_calib_end(ow_t *handle)
+{
+  int32_t avg[5];
+  int32_t limit = 0xFFFF;
+
+  handle->calib_run = false;
+  for (uint8_t point = 0; point < 5; point++)
+  {
+    /* No presence pulse, keep last compensation */
+    if (handle->calib_cnt[point] == 0)
+    {
+      return;
+    }
+    avg[point] = (int32_t)((handle->calib_sum[point] + handle->calib_cnt[point] / 2) / handle->calib_cnt[point]);
+  }
+  for (uint8_t speed = 0; speed < OW_SPEED_MAX; speed++)
+  {
+    const ow_tim_t *tim = &handle->tim_table[speed];
+    uint16_t phase[4] = { tim->write_low, tim->read_low, tim->read_sample, tim->read_high };
+    for (uint8_t idx = 0; idx < 4; idx++)
+    {
+      if (((phase[idx] - 1) / 2) < limit)
+      {
+        limit = (phase[idx] - 1) / 2;
+      }
+    }
+  }
+
+  int32_t diff[3] = { avg[1] - avg[0], avg[3] - avg[2], avg[4] - avg[3] };
+  for (uint8_t idx = 0; idx < 3; idx++)
+  {
+    diff[idx] = (diff[idx] > limit) ? limit : ((diff[idx] < -limit) ? -limit : diff[idx]);
+  }
+  handle->calib.write_rel = (int16_t)diff[0];
+  handle->calib.read_rel = (int16_t)diff[1];
+  handle->calib.read_smp = (int16_t)diff[2];
+}
+#endif
+
+#elif (OW_BACKEND == OW_BACKEND_TIM)
+/*************************************************************************************************/
+/**
+ * @brief Start a 1-Wire transfer on the bus with the reset slot.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @retval OW_ERR_NONE on success, or error code (OW_ERR_BUSY, OW_ERR_BUS).
+ */
+ow_err_t ow_start(ow_t *handle)
+{
+  ow_err_t ow_err = OW_ERR_NONE;
+  assert_param(handle != NULL);
+
+  do
+  {
+    /* Ensure bus is idle before starting transfer */
+    if (handle->state != OW_STATE_IDLE)
+    {
+      ow_err = OW_ERR_BUSY;
+      break;
+    }
+
+    /* Check if line is idle */
+    if (!ow_read_bit(handle))
+    {
+      ow_err = OW_ERR_BUS;
+      break;
+    }
+
+    /* Reset internal buffer */
+    memset(&handle->buf, 0, sizeof(ow_buf_t));
+#if (OW_STATS == 1)
+    handle->stats_t0 = OW_CYCLES();
+#endif
+#if (OW_MARGIN == 1)
+    /* No edges yet, minimums start at top */
+    memset(&handle->margin, 0, sizeof(ow_margin_t));
+    handle->margin.rise_min = 0xFFFF;
+    handle->margin.hold_min = 0xFFFF;
+#endif
+
+    /* Reset pulse at selected bus speed */
+    handle->tim = &handle->tim_table[handle->speed];
+
+    /* Capture rising edges from before the reset slot, its last edge is the presence check (OW_MARGIN: both edges) */
+    HAL_TIM_IC_Start(handle->config.tim_handle, handle->config.tim_ch_in);
+    OW_MARGIN_RST(handle);
+
+    /* Reset slot starts now, released part of slot covers the presence pulse */
+    ow_tim_slot(handle, handle->tim->rst, handle->tim->rst * 2);
+    HAL_TIM_GenerateEvent(handle->config.tim_handle, TIM_EVENTSOURCE_UPDATE);
+    __HAL_TIM_CLEAR_IT(handle->config.tim_handle, 0xFFFFFFFFUL);
+
+    /* Presence check slot, bus stays released */
+    ow_tim_slot(handle, 0, handle->tim->rst_det);
+    HAL_TIM_Base_Start_IT(handle->config.tim_handle);
+
+  } while (0);
+
+  return ow_err;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Stop 1-Wire transfer and release the bus.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ */
+void ow_stop(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  /* Stop timer interrupts and edge capture */
+  HAL_TIM_Base_Stop_IT(handle->config.tim_handle);
+  ow_tim_cap_stop(handle);
+  HAL_TIM_IC_Stop(handle->config.tim_handle, handle->config.tim_ch_in);
+
+  /* Release bus (set high), zero compare keeps PWM output high */
+  ow_tim_slot(handle, 0, handle->tim->rst_det);
+  HAL_TIM_GenerateEvent(handle->config.tim_handle, TIM_EVENTSOURCE_UPDATE);
+  __HAL_TIM_CLEAR_IT(handle->config.tim_handle, 0xFFFFFFFFUL);
+
+  /* Set state to idle, report and start next queued transaction */
+  ow_done(handle);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief 1-Wire state machine: handle transfer phases (reset, write/read slots).
+ * @param[in] handle Pointer to the 1-Wire handle.
+ *
+ * @details
+ * Called once per slot at update event, when the preloaded slot has just started.
+ * Preloads the slot after it, so ISR latency up to one slot does not change bus timing.
+ */
+__STATIC_FORCEINLINE void ow_state_xfer(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  uint16_t slot_len = (handle->buf.write_len + handle->buf.read_len) * 8;
+
+  switch (handle->buf.bit_ph)
+  {
+    /************ Presence check slot: check reset slot, capture all bit slots ************/
+    case 0:
+      if (ow_tim_presence(handle) == false)
+      {
+        handle->error = OW_ERR_RESET;
+        ow_stop(handle);
+        break;
+      }
+      ow_tim_cap_start(handle, slot_len);
+      ow_tim_xfer_slot(handle, 0);
+      handle->buf.bit_ph++;
+      break;
+
+    /************ Write/read slot started: preload next slot ************/
+    case 1:
+      handle->buf.byte_idx++;
+#if (OW_OVERDRIVE == 1)
+      /* Overdrive ROM command sent, continue at overdrive speed */
+      if ((handle->buf.od_idx > 0) && (handle->buf.byte_idx == handle->buf.od_idx * 8))
+      {
+        handle->speed = OW_SPEED_OD;
+        handle->tim = &handle->tim_table[OW_SPEED_OD];
+      }
+#endif
+      if (handle->buf.byte_idx < slot_len)
+      {
+        ow_tim_xfer_slot(handle, handle->buf.byte_idx);
+      }
+      else
+      {
+        /* Last slot started, then release bus until decoded */
+        ow_tim_slot(handle, 0, handle->tim->read_high);
+        handle->buf.bit_ph++;
+      }
+      break;
+
+    /************ All slots done: decode read slots from captured edges ************/
+    case 2:
+      for (uint16_t idx = handle->buf.write_len * 8; idx < slot_len; idx++)
+      {
+        /* Bus released before sample point: read 1 */
+        bool one = (handle->cap[idx] < handle->tim->read_low + handle->tim->read_sample);
+        if (one)
+        {
+          *ow_buf_read(handle, idx / 8 - handle->buf.write_len) |= (1 << (idx % 8));
+        }
+        OW_MARGIN_SLOT(handle, handle->cap[idx], one);
+        /* Update response CRC as bytes complete */
+        if ((idx % 8) == 7)
+        {
+          handle->buf.crc = ow_crc_update(handle->buf.crc, *ow_buf_read(handle, idx / 8 - handle->buf.write_len));
+        }
+      }
+#if (OW_MAX_DEVICE == 1)
+      /* Single device: verify ROM ID if READ_ROM command */
+      if (handle->buf.data[0] == OW_CMD_READ_ROM)
+      {
+        if (handle->buf.crc == 0)
+        {
+          memcpy(handle->rom_id[0].array, &handle->buf.data[1], 8);
+          handle->error = OW_ERR_NONE;
+        }
+        else
+        {
+          handle->error = OW_ERR_ROM_ID;
+        }
+      }
+#endif
+      handle->state = OW_STATE_DONE;
+      ow_stop(handle);
+      break;
+
+    default:
+      break;
+  }
+}
+
+#if (OW_MAX_DEVICE > 1)
+/*************************************************************************************************/
+/**
+ * @brief  1-Wire ROM search state machine.
+ * @param  handle: Pointer to 1-Wire handle.
+ * @retval None
+ *
+ * @details
+ * Per ROM bit: read slot, complement read slot, released gap slot, selected bit write slot.
+ * The gap slot gives time to resolve the selected bit from the captured edges.
+ */
+__STATIC_FORCEINLINE void ow_state_search(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  uint16_t cap_idx = 8 + handle->buf.bit_idx * 3;
+
+  switch (handle->buf.bit_ph)
+  {
+  /************ Presence check slot: check reset slot, capture next slots ************/
+  case 0:
+    if (ow_tim_presence(handle) == false)
     {
-      handle->buf.write_len = 10;
+      handle->error = OW_ERR_RESET;
+      ow_stop(handle);
+      break;
     }
-    
-    /* Set expected read length */
-    handle->buf.read_len  = r_len;
+    ow_tim_cap_start(handle, 8 + 64 * 3);
+    handle->buf.byte_idx = 0;
+    ow_tim_slot(handle, (handle->buf.data[0] & 0x01) ? handle->tim->write_low : handle->tim->write_high,
+                handle->tim->write_low + handle->tim->write_high);
+    handle->buf.bit_ph++;
+    break;
 
-  } while (0);
+  /************ Command slot started: preload next command bit or first read slot ************/
+  case 1:
+    handle->buf.byte_idx++;
+    if (handle->buf.byte_idx < 8)
+    {
+      ow_tim_slot(handle, (handle->buf.data[0] & (1 << handle->buf.byte_idx)) ? handle->tim->write_low : handle->tim->write_high,
+                  handle->tim->write_low + handle->tim->write_high);
+    }
+    else
+    {
+      ow_tim_slot(handle, handle->tim->read_low, handle->tim->read_low + handle->tim->read_sample + handle->tim->read_high);
+      handle->buf.bit_ph++;
+    }
+    break;
 
-  return handle->error;
+  /************ Bit read slot started: preload complement read slot ************/
+  case 2:
+    ow_tim_slot(handle, handle->tim->read_low, handle->tim->read_low + handle->tim->read_sample + handle->tim->read_high);
+    handle->buf.bit_ph++;
+    break;
+
+  /************ Complement read slot started: preload gap slot ************/
+  case 3:
+    ow_tim_slot(handle, 0, handle->tim->read_high);
+    handle->buf.bit_ph++;
+    break;
+
+  /************ Gap slot started: resolve discrepancy, preload selected bit ************/
+  case 4:
+    handle->search.val = (handle->cap[cap_idx] < handle->tim->read_low + handle->tim->read_sample) ? OW_VAL_1 : OW_VAL_DIFF;
+    if (handle->cap[cap_idx + 1] < handle->tim->read_low + handle->tim->read_sample)
+    {
+      handle->search.val |= OW_VAL_0;
+    }
+    OW_MARGIN_SLOT(handle, handle->cap[cap_idx], (handle->search.val & OW_VAL_1) != 0);
+    OW_MARGIN_SLOT(handle, handle->cap[cap_idx + 1], (handle->search.val & OW_VAL_0) != 0);
+    if (ow_search_resolve(handle) == false)
+    {
+      /* Devices lost inside ROM ID, reset slot of same pass */
+      if ((handle->buf.bit_idx != 0) && ow_search_retry(handle))
+      {
+        ow_tim_slot(handle, handle->tim->rst, handle->tim->rst * 2);
+        handle->buf.bit_ph = 6;
+        break;
+      }
+      handle->error = OW_ERR_ROM_ID;
+      ow_stop(handle);
+      break;
+    }
+    ow_tim_slot(handle, (handle->search.val == OW_VAL_1) ? handle->tim->write_low : handle->tim->write_high,
+                handle->tim->write_low + handle->tim->write_high);
+    handle->buf.bit_ph++;
+    break;
+
+  /************ Selected bit slot started: store it, preload next bit or next search ************/
+  case 5:
+    if (ow_search_advance(handle) == false)
+    {
+      ow_tim_slot(handle, handle->tim->read_low, handle->tim->read_low + handle->tim->read_sample + handle->tim->read_high);
+      handle->buf.bit_ph = 2;
+    }
+    else if (handle->state == OW_STATE_DONE)
+    {
+      /* Stopped on next update */
+      ow_tim_slot(handle, 0, handle->tim->read_high);
+    }
+    else
+    {
+      /* Reset slot of next search */
+      ow_tim_slot(handle, handle->tim->rst, handle->tim->rst * 2);
+      handle->buf.bit_ph = 6;
+    }
+    break;
+
+  /************ Reset slot started: capture its edges, preload presence check slot ************/
+  case 6:
+    ow_tim_cap_stop(handle);
+    OW_MARGIN_RST(handle);
+    ow_tim_slot(handle, 0, handle->tim->rst_det);
+    handle->buf.bit_ph = 0;
+    break;
+
+  default:
+    break;
+  }
 }
+#endif
 
 /*************************************************************************************************/
 /**
- * @brief Get number of detected 1-Wire devices.
+ * @brief Preload next slot, loaded by hardware at the update event ending current slot.
  * @param[in] handle: Pointer to 1-Wire handle.
- * @retval Count of found devices
+ * @param[in] low: Bus low time in timer ticks, 0 keeps the bus released.
+ * @param[in] period: Slot length in timer ticks.
  */
-uint8_t ow_devices(ow_t *handle)
+__STATIC_FORCEINLINE void ow_tim_slot(ow_t *handle, uint16_t low, uint16_t period)
 {
   assert_param(handle != NULL);
-  return handle->rom_id_found;
+
+  __HAL_TIM_SET_COMPARE(handle->config.tim_handle, handle->config.tim_ch_out, low);
+  __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, period - 1);
 }
-#endif
 
 /*************************************************************************************************/
 /**
- * @brief Retrieve read response data from the 1-Wire buffer.
- * @param[in] handle: Pointer to the 1-Wire handle.
- * @param[in] data: Pointer to user buffer to store the response.
- * @param[in] data_size: Size of the user buffer in bytes.
- * @retval Number of bytes copied to the user buffer.
+ * @brief Preload write or read slot of transfer.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @param[in] slot_idx: Slot index, bit slot_idx % 8 of byte slot_idx / 8 in transfer buffer.
  */
-uint16_t ow_read_resp(ow_t *handle, uint8_t *data, uint16_t data_size)
+__STATIC_FORCEINLINE void ow_tim_xfer_slot(ow_t *handle, uint16_t slot_idx)
 {
   assert_param(handle != NULL);
-  assert_param(data != NULL);
-
-  uint16_t len = handle->buf.read_len;
 
-  /* Adjust length if user buffer is smaller */
-  if (data_size < len)
+  if (slot_idx >= handle->buf.write_len * 8)
   {
-    len = data_size;
+    ow_tim_slot(handle, handle->tim->read_low, handle->tim->read_low + handle->tim->read_sample + handle->tim->read_high);
+  }
+  else if (ow_buf_write(handle, slot_idx / 8) & (1 << (slot_idx % 8)))
+  {
+    ow_tim_slot(handle, handle->tim->write_low, handle->tim->write_low + handle->tim->write_high);
   }
+  else
+  {
+    ow_tim_slot(handle, handle->tim->write_high, handle->tim->write_low + handle->tim->write_high);
+  }
+}
 
-  /* Defensive: ensure we do not read past internal buffer */
-  if ((uint32_t)(handle->buf.write_len) + (uint32_t)len > sizeof(handle->buf.data))
+/*************************************************************************************************/
+/**
+ * @brief Check presence pulse from captured edges of reset slot.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @retval true if a device answered, false otherwise.
+ *
+ * @details
+ * With OW_MARGIN both edges of the reset slot are in the capture buffer, capture is set back
+ * to rising edges before the first bit slot.
+ */
+__STATIC_FORCEINLINE bool ow_tim_presence(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+#if (OW_MARGIN == 1)
+  TIM_HandleTypeDef *htim = handle->config.tim_handle;
+  uint16_t cnt = OW_MARGIN_RST_EDGES - (uint16_t)__HAL_DMA_GET_COUNTER(handle->config.tim_dma);
+  ow_tim_cap_stop(handle);
+  __HAL_TIM_SET_CAPTUREPOLARITY(htim, handle->config.tim_ch_in, TIM_ICPOLARITY_RISING);
+
+  /* Skip master low, if captured at all, up to its release at rst: then presence start and end */
+  uint16_t idx = 0;
+  while ((idx < cnt) && (handle->cap[idx] < handle->tim->rst))
   {
-    /* Truncate to available bytes */
-    if (handle->buf.write_len < sizeof(handle->buf.data))
-    {
-      len = (uint16_t)(sizeof(handle->buf.data) - (uint32_t)handle->buf.write_len);
-    }
-    else
-    {
-      return 0;
-    }
+    idx++;
   }
+  bool present = ((idx + 3 <= cnt) && (handle->cap[idx + 2] > handle->tim->rst + handle->tim->rst_det / 2)) ? true : false;
+  handle->margin.presence_start = present ? (uint16_t)(handle->cap[idx + 1] - handle->tim->rst) : 0;
+  handle->margin.presence_width = present ? (uint16_t)(handle->cap[idx + 2] - handle->cap[idx + 1]) : 0;
 
-  /* Copy response data from internal buffer to user buffer */
-  for (uint16_t idx = 0; idx < len; ++idx)
+  return present;
+#else
+  /* No edge in reset slot: bus held low, capture register is from an older slot */
+  if (!__HAL_TIM_GET_FLAG(handle->config.tim_handle, TIM_FLAG_CC1 << (handle->config.tim_ch_in >> 2)))
   {
-    data[idx] = handle->buf.data[handle->buf.write_len + idx];
+    return false;
   }
 
-  return len;
+  /* Master releases at rst, a presence pulse ends clearly after that */
+  uint32_t edge = HAL_TIM_ReadCapturedValue(handle->config.tim_handle, handle->config.tim_ch_in);
+  return (edge > handle->tim->rst + handle->tim->rst_det / 2) ? true : false;
+#endif
 }
 
 /*************************************************************************************************/
-/** Private Function Implementations **/
+/**
+ * @brief Start DMA of captured edges into capture buffer, one halfword per rising edge.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @param[in] len: Number of edges.
+ *
+ * @details
+ * Capture runs since ow_start(), only the DMA request is added, so no edge of the first
+ * slot is lost. HAL_TIM_IC_Start_DMA() would stop and start the channel for that.
+ */
+__STATIC_FORCEINLINE void ow_tim_cap_start(ow_t *handle, uint16_t len)
+{
+  assert_param(handle != NULL);
+
+  TIM_HandleTypeDef *htim = handle->config.tim_handle;
+  HAL_DMA_Start(handle->config.tim_dma, (uint32_t)(uintptr_t)(&htim->Instance->CCR1 + (handle->config.tim_ch_in >> 2)),
+                (uint32_t)(uintptr_t)handle->cap, len);
+  __HAL_TIM_ENABLE_DMA(htim, TIM_DMA_CC1 << (handle->config.tim_ch_in >> 2));
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Stop DMA of captured edges, capture keeps running for the next reset slot.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ */
+__STATIC_FORCEINLINE void ow_tim_cap_stop(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  __HAL_TIM_DISABLE_DMA(handle->config.tim_handle, TIM_DMA_CC1 << (handle->config.tim_ch_in >> 2));
+  HAL_DMA_Abort(handle->config.tim_dma);
+
+  /* Edges of older slots are not taken as presence check */
+  __HAL_TIM_CLEAR_FLAG(handle->config.tim_handle, TIM_FLAG_CC1 << (handle->config.tim_ch_in >> 2));
+}
+
+#if (OW_MARGIN == 1)
+/*************************************************************************************************/
+/**
+ * @brief Store captured rising edge of one read slot in margin of transaction.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @param[in] edge: Rising edge from slot start in timer ticks.
+ * @param[in] one: true if decoded as 1.
+ */
+__STATIC_FORCEINLINE void ow_margin_slot(ow_t *handle, uint16_t edge, bool one)
+{
+  ow_margin_t *margin = &handle->margin;
+
+  if (one)
+  {
+    margin->rise_min = (edge < margin->rise_min) ? edge : margin->rise_min;
+    margin->rise_max = (edge > margin->rise_max) ? edge : margin->rise_max;
+    margin->ones++;
+  }
+  else
+  {
+    margin->hold_min = (edge < margin->hold_min) ? edge : margin->hold_min;
+    margin->hold_max = (edge > margin->hold_max) ? edge : margin->hold_max;
+    margin->zeros++;
+  }
+}
+
 /*************************************************************************************************/
+/**
+ * @brief Capture both edges of the reset slot by DMA, for start and width of the presence pulse.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ *
+ * @details
+ * Needs a capture channel with both edge polarity (CCxNP), ow_tim_presence() sets it back to
+ * rising edges. Started at the update of the reset slot the master low may be missed, the
+ * presence check skips edges before the release anyway.
+ */
+__STATIC_FORCEINLINE void ow_margin_rst(ow_t *handle)
+{
+  assert_param(handle != NULL);
 
+  __HAL_TIM_SET_CAPTUREPOLARITY(handle->config.tim_handle, handle->config.tim_ch_in, TIM_ICPOLARITY_BOTHEDGE);
+  ow_tim_cap_start(handle, OW_MARGIN_RST_EDGES);
+}
+#endif
+#else
 /*************************************************************************************************/
 /**
- * @brief Start a 1-Wire transfer on the bus.
+ * @brief Start a 1-Wire transfer on the bus by sending the reset slot.
  * @param[in] handle: Pointer to the 1-Wire handle.
- * @retval OW_ERR_NONE on success, or error code (OW_ERR_BUSY, OW_ERR_BUS).
+ * @retval OW_ERR_NONE on success, or error code (OW_ERR_BUSY).
  */
 ow_err_t ow_start(ow_t *handle)
 {
@@ -500,22 +3337,15 @@ ow_err_t ow_start(ow_t *handle)
       break;
     }
 
-    /* Pull bus high and check if line is idle */
-    ow_write_bit(handle, true);
-    if (!ow_read_bit(handle))
-    {
-      ow_err = OW_ERR_BUS;
-      break;
-    }
-
-    /* Clear timer interrupt and reset internal buffer */
-    __HAL_TIM_CLEAR_IT(handle->config.tim_handle, 0xFFFFFFFFUL);
+    /* Reset internal buffer */
     memset(&handle->buf, 0, sizeof(ow_buf_t));
+#if (OW_STATS == 1)
+    handle->stats_t0 = OW_CYCLES();
+#endif
 
-    /* Configure timer for reset detection */
-    __HAL_TIM_SET_COUNTER(handle->config.tim_handle, 0);
-    __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_RST_DET - 1);
-    HAL_TIM_Base_Start_IT(handle->config.tim_handle);
+    /* Reset slot at selected bus speed, echo is checked in RX complete callback */
+    handle->slot[0] = ow_uart_rst[handle->speed];
+    ow_uart_xmit(handle, handle->config.brr_rst[handle->speed], 0, 1);
 
   } while (0);
 
@@ -531,157 +3361,95 @@ void ow_stop(ow_t *handle)
 {
   assert_param(handle != NULL);
 
-  /* Stop timer interrupts */
-  HAL_TIM_Base_Stop_IT(handle->config.tim_handle);
-
-  /* Release bus (set high) */
-  ow_write_bit(handle, true);
-
-  /* Set state to idle */
-  handle->state = OW_STATE_IDLE;
+  /* Stop DMA transfers, TX line returns to idle (high) */
+  HAL_UART_Abort(handle->config.uart_handle);
 
-  /* Call user callback if registered */
-  if (handle->config.done_cb != NULL)
-  {
-    handle->config.done_cb(handle->error);
-  }
+  /* Set state to idle, report and start next queued transaction */
+  ow_done(handle);
 }
 
 /*************************************************************************************************/
 /**
- * @brief 1-Wire state machine: handle transfer phases (reset, write, read).
+ * @brief 1-Wire state machine: handle transfer phases (reset, write/read slots).
  * @param[in] handle Pointer to the 1-Wire handle.
+ *
+ * @details
+ * Called once for the reset echo and once per DMA block of slots. All write and read slots
+ * of a transfer are sent in one block, split where the bus switches to overdrive and where
+ * caller data is longer than the slot buffer.
  */
 __STATIC_FORCEINLINE void ow_state_xfer(ow_t *handle)
 {
   assert_param(handle != NULL);
 
+  uint16_t slot_len = (handle->buf.write_len + handle->buf.read_len) * 8;
+
   switch (handle->buf.bit_ph)
   {
-    /************ Reset phase: pull bus low ************/
+    /************ Reset phase: check presence pulse, send first block of slots ************/
     case 0:
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_RST - 1);
-      ow_write_bit(handle, false);
-      handle->buf.bit_ph++;
-      break;
-
-    /************ Reset phase: release bus (high) ************/
-    case 1:
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_RST_DET - 1);
-      ow_write_bit(handle, true);
-      handle->buf.bit_ph++;
-      break;
-
-    /************ Reset phase: check presence pulse ************/
-    case 2:
-      if (ow_read_bit(handle) != 0)
+      if (ow_uart_presence(handle) == false)
       {
-        handle->error = OW_ERR_RESET;
         ow_stop(handle);
+        break;
       }
-      else
-      {
-        __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_RST - 1);
-        handle->buf.bit_ph++;
-      }
-      break;
-
-    /************ Writing, phase 1: pull low ************/
-    case 3:
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle,
-        (handle->buf.data[handle->buf.byte_idx] & (1 << handle->buf.bit_idx)) ? OW_TIM_WRITE_LOW - 1 : OW_TIM_WRITE_HIGH - 1);
-      ow_write_bit(handle, false);
+      handle->buf.byte_idx = 0;
+      ow_uart_xfer_block(handle);
       handle->buf.bit_ph++;
       break;
 
-    /************ Writing, phase 2: release bus ************/
-    case 4:
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle,
-        (handle->buf.data[handle->buf.byte_idx] & (1 << handle->buf.bit_idx)) ? OW_TIM_WRITE_HIGH - 1 : OW_TIM_WRITE_LOW - 1);
-      ow_write_bit(handle, true);
-      handle->buf.bit_idx++;
-
-      /* Move to next byte or reading phase */
-      if (handle->buf.bit_idx == 8)
+    /************ Block sent: decode read echo, send next block ************/
+    case 1:
+      for (uint16_t idx = handle->buf.slot_idx; idx < handle->buf.byte_idx; idx += 8)
       {
-        handle->buf.bit_idx = 0;
-        handle->buf.byte_idx++;
-        if (handle->buf.byte_idx == handle->buf.write_len)
+        if (idx < handle->buf.write_len * 8)
         {
-          if (handle->buf.read_len > 0)
-          {
-            /* Start reading phase */
-            handle->buf.bit_ph = 5;
-            handle->buf.byte_idx = 0;
-          }
-          else
-          {
-            /* Writing complete, no reading */
-            handle->state = OW_STATE_DONE;
-          }
+          continue;
         }
-        else
+        const uint8_t *slot = &handle->slot[idx - handle->buf.slot_idx];
+        uint8_t data = 0;
+        for (uint8_t bit = 0; bit < 8; bit++)
         {
-          /* Continue writing next byte */
-          handle->buf.bit_ph = 3;
+          /* Device holds the line low on read 0 */
+          if (slot[bit] == 0xFF)
+          {
+            data |= (1 << bit);
+          }
         }
+        *ow_buf_read(handle, idx / 8 - handle->buf.write_len) = data;
+
+        /* Update response CRC as bytes are decoded */
+        handle->buf.crc = ow_crc_update(handle->buf.crc, data);
       }
-      else
+#if (OW_OVERDRIVE == 1)
+      /* Overdrive ROM command sent, continue at overdrive speed */
+      if ((handle->buf.od_idx > 0) && (handle->buf.byte_idx == handle->buf.od_idx * 8))
       {
-        /* Continue writing next bit */
-        handle->buf.bit_ph = 3;
+        handle->speed = OW_SPEED_OD;
       }
-      break;
-
-    /************ Reading, phase 1: pull low ************/
-    case 5:
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_READ_LOW - 1);
-      ow_write_bit(handle, false);
-      handle->buf.bit_ph++;
-      break;
-
-    /************ Reading, phase 2: release bus ************/
-    case 6:
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_READ_SAMPLE - 1);
-      ow_write_bit(handle, true);
-      handle->buf.bit_ph++;
-      break;
-
-    /************ Reading, phase 3: sample bus ************/
-    case 7:
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_READ_HIGH - 1);
-      if (ow_read_bit(handle))
+#endif
+      if (handle->buf.byte_idx < slot_len)
       {
-        handle->buf.data[handle->buf.write_len + handle->buf.byte_idx] |= (1 << handle->buf.bit_idx);
+        ow_uart_xfer_block(handle);
+        break;
       }
-
-      /* Update bit/byte counters */
-      handle->buf.bit_ph = 5;
-      handle->buf.bit_idx++;
-      if (handle->buf.bit_idx == 8)
+#if (OW_MAX_DEVICE == 1)
+      /* Single device: verify ROM ID if READ_ROM command */
+      if (handle->buf.data[0] == OW_CMD_READ_ROM)
       {
-        handle->buf.bit_idx = 0;
-        handle->buf.byte_idx++;
-        if (handle->buf.byte_idx == handle->buf.read_len)
+        if (handle->buf.crc == 0)
         {
-#if (OW_MAX_DEVICE == 1)
-          /* Single device: verify ROM ID if READ_ROM command */
-          if (handle->buf.data[0] == OW_CMD_READ_ROM)
-          {
-            if (ow_crc(&handle->buf.data[1], 7) == handle->buf.data[7])
-            {
-              memcpy(handle->rom_id[0].array, &handle->buf.data[1], 8);
-              handle->error = OW_ERR_NONE;
-            }
-            else
-            {
-              handle->error = OW_ERR_ROM_ID;
-            }
-          }
-#endif
-          handle->state = OW_STATE_DONE;
+          memcpy(handle->rom_id[0].array, &handle->buf.data[1], 8);
+          handle->error = OW_ERR_NONE;
+        }
+        else
+        {
+          handle->error = OW_ERR_ROM_ID;
         }
       }
+#endif
+      handle->state = OW_STATE_DONE;
+      ow_stop(handle);
       break;
 
     default:
@@ -697,243 +3465,387 @@ __STATIC_FORCEINLINE void ow_state_xfer(ow_t *handle)
  * @retval None
  *
  * @details
- * Implements non-blocking search, handles reset, read/write bits,
- * resolves discrepancies, stores found ROMs, and sets state done.
+ * Sends the search command with the first bit and complement read slots, then one block of
+ * three slots per ROM bit: the selected bit, and the next bit and complement.
  */
 __STATIC_FORCEINLINE void ow_state_search(ow_t *handle)
 {
   assert_param(handle != NULL);
 
+  uint16_t read_idx = 8;
+
   switch (handle->buf.bit_ph)
   {
-  /************ Reset phase: pull bus low ************/
+  /************ Reset phase: check presence pulse, send command ************/
   case 0:
-    __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_RST - 1);
-    ow_write_bit(handle, false);
-    handle->buf.bit_ph++;
-    break;
-
-    /************ Reset phase: release bus (high) ************/
-  case 1:
-    __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_RST_DET - 1);
-    ow_write_bit(handle, true);
-    handle->buf.bit_ph++;
-    break;
-
-  /************ Reset phase: check presence pulse ************/
-  case 2:
-    if (ow_read_bit(handle) != 0)
+    if (ow_uart_presence(handle) == false)
     {
-      handle->error = OW_ERR_RESET;
       ow_stop(handle);
+      break;
     }
-    else
-    {
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_RST - 1);
-      handle->buf.bit_ph++;
-    }
-    break;
-
-  /************ Writing, phase 1: pull low ************/
-  case 3:
-    if (handle->buf.data[0] & (1 << handle->buf.bit_idx))
-    {
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_WRITE_LOW - 1);
-    }
-    else
+    for (uint8_t idx = 0; idx < 8; idx++)
     {
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_WRITE_HIGH - 1);
+      handle->slot[idx] = (handle->buf.data[0] & (1 << idx)) ? 0xFF : 0x00;
     }
-    ow_write_bit(handle, false);
+    handle->slot[8] = 0xFF;
+    handle->slot[9] = 0xFF;
+    ow_uart_xmit(handle, handle->config.brr_data[handle->speed], 0, 10);
     handle->buf.bit_ph++;
     break;
 
-  /************ Writing, phase 2: release bus ************/
-  case 4:
-    if (handle->buf.data[0] & (1 << handle->buf.bit_idx))
-    {
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_WRITE_HIGH - 1);
-    }
-    else
+  /************ Selected bit sent: store it, start next search if ROM ID complete ************/
+  case 2:
+    if (ow_search_advance(handle) != false)
     {
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_WRITE_LOW - 1);
+      if (handle->state == OW_STATE_DONE)
+      {
+        ow_stop(handle);
+      }
+      else
+      {
+        handle->slot[0] = ow_uart_rst[handle->speed];
+        ow_uart_xmit(handle, handle->config.brr_rst[handle->speed], 0, 1);
+      }
+      break;
     }
-    ow_write_bit(handle, true);
-    handle->buf.bit_idx++;
+    /* Next bit and complement follow the selected bit */
+    read_idx = 1;
+    /* fall through */
 
-    /* command complete */
-    if (handle->buf.bit_idx == 8)
+  /************ Bit and complement read: resolve and send selected bit ************/
+  case 1:
+    handle->search.val = (handle->slot[read_idx] == 0xFF) ? OW_VAL_1 : OW_VAL_DIFF;
+    if (handle->slot[read_idx + 1] == 0xFF)
     {
-      handle->buf.bit_idx = 0;
-      /* Start reading phase */
-      handle->buf.bit_ph = 5;
+      handle->search.val |= OW_VAL_0;
     }
-    else
+    if (ow_search_resolve(handle) == false)
     {
-      /* Writing next command bit */
-      handle->buf.bit_ph = 3;
+      /* Devices lost inside ROM ID, reset of same pass */
+      if ((handle->buf.bit_idx != 0) && ow_search_retry(handle))
+      {
+        handle->slot[0] = ow_uart_rst[handle->speed];
+        ow_uart_xmit(handle, handle->config.brr_rst[handle->speed], 0, 1);
+        break;
+      }
+      handle->error = OW_ERR_ROM_ID;
+      ow_stop(handle);
+      break;
     }
-    break;
 
-  /************ Reading, phase 1: pull low ************/
-  case 5:
-    __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_READ_LOW - 1);
-    ow_write_bit(handle, false);
-    handle->buf.bit_ph++;
+    /* Selected bit, then read slots of next bit unless this is the last one */
+    handle->slot[0] = (handle->search.val == OW_VAL_1) ? 0xFF : 0x00;
+    handle->slot[1] = 0xFF;
+    handle->slot[2] = 0xFF;
+    ow_uart_xmit(handle, handle->config.brr_data[handle->speed], 0, (handle->buf.bit_idx == 63) ? 1 : 3);
+    handle->buf.bit_ph = 2;
     break;
 
-  /************ reading bit, phase 2 ************/
-  case 6:
-    __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_READ_SAMPLE - 1);
-    ow_write_bit(handle, true);
-    handle->buf.bit_ph++;
+  default:
     break;
+  }
+}
+#endif
+
+/*************************************************************************************************/
+/**
+ * @brief Send bit slots by DMA, the echo of each slot is received in place.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @param[in] brr: Cached baud rate register value.
+ * @param[in] slot_idx: First slot in handle slot buffer.
+ * @param[in] slot_len: Number of slots.
+ */
+__STATIC_FORCEINLINE void ow_uart_xmit(ow_t *handle, uint32_t brr, uint16_t slot_idx, uint16_t slot_len)
+{
+  assert_param(handle != NULL);
+
+  UART_HandleTypeDef *huart = handle->config.uart_handle;
+
+  /* Last echo can arrive before TX complete, return both directions to ready */
+  HAL_UART_Abort(huart);
+
+  /* Baud rate can be changed only while UART is disabled */
+  __HAL_UART_DISABLE(huart);
+  huart->Instance->BRR = brr;
+  __HAL_UART_ENABLE(huart);
+
+  /* Each slot is received after it is sent, so TX and RX can share one buffer */
+  HAL_UART_Receive_DMA(huart, &handle->slot[slot_idx], slot_len);
+  HAL_UART_Transmit_DMA(huart, &handle->slot[slot_idx], slot_len);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Encode and send next block of transfer slots, from slot byte_idx on.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ *
+ * @details
+ * A block ends at the end of the transfer, at the end of the slot buffer, or where the bus
+ * switches to overdrive. Blocks are whole bytes, so each read byte is decoded in one block.
+ */
+__STATIC_FORCEINLINE void ow_uart_xfer_block(ow_t *handle)
+{
+  assert_param(handle != NULL);
 
-  /************ reading bit, phase 3 ************/
-  case 7:
-    __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_READ_HIGH - 1);
-    if (ow_read_bit(handle))
+  uint16_t slot_len = (handle->buf.write_len + handle->buf.read_len) * 8;
+  uint16_t start = handle->buf.byte_idx;
+  uint16_t end = slot_len;
+
+  if ((uint32_t)(end - start) > sizeof(handle->slot))
+  {
+    end = start + sizeof(handle->slot);
+  }
+#if (OW_OVERDRIVE == 1)
+  if ((handle->buf.od_idx > 0) && (start < handle->buf.od_idx * 8) && (end > handle->buf.od_idx * 8))
+  {
+    end = handle->buf.od_idx * 8;
+  }
+#endif
+
+  /* Write slots from data bytes, read slots are released high */
+  for (uint16_t idx = start; idx < end; idx++)
+  {
+    if (idx < handle->buf.write_len * 8)
     {
-      handle->search.val = OW_VAL_1;
+      handle->slot[idx - start] = (ow_buf_write(handle, idx / 8) & (1 << (idx % 8))) ? 0xFF : 0x00;
     }
     else
     {
-      handle->search.val = OW_VAL_DIFF;
+      handle->slot[idx - start] = 0xFF;
     }
-    handle->buf.bit_ph++;
-    break;
+  }
+  handle->buf.slot_idx = start;
+  handle->buf.byte_idx = end;
+  ow_uart_xmit(handle, handle->config.brr_data[handle->speed], 0, end - start);
+}
 
-  /************ reading complement bit, phase 1 ************/
-  case 8:
-    __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_READ_LOW - 1);
-    ow_write_bit(handle, false);
-    handle->buf.bit_ph++;
-    break;
+/*************************************************************************************************/
+/**
+ * @brief Check reset slot echo for presence pulse and shorted bus.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @retval true if a device answered, false otherwise (handle->error is set).
+ */
+__STATIC_FORCEINLINE bool ow_uart_presence(ow_t *handle)
+{
+  assert_param(handle != NULL);
 
-  /************ Reading, phase 2: release bus ************/
-  case 9:
-    __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_READ_SAMPLE - 1);
-    ow_write_bit(handle, true);
-    handle->buf.bit_ph++;
-    break;
+  /* Unchanged echo: no presence pulse */
+  if (handle->slot[0] == ow_uart_rst[handle->speed])
+  {
+    handle->error = OW_ERR_RESET;
+    return false;
+  }
+
+  /* All low: bus is shorted */
+  if (handle->slot[0] == 0x00)
+  {
+    handle->error = OW_ERR_BUS;
+    return false;
+  }
+
+  return true;
+}
+#endif
+
+#if (OW_MAX_DEVICE > 1)
+/*************************************************************************************************/
+/**
+ * @brief Start ROM search, optionally preset to the branch of one family.
+ * @param[in] handle: Pointer to the 1-Wire handle.
+ * @param[in] cmd: OW_CMD_SEARCH_ROM or OW_CMD_SEARCH_ALARM.
+ * @param[in] family: Family code, 0 == all families.
+ * @param[in] mode: Replace or merge into ROM ID list, or verify one ROM ID.
+ * @retval Last error code (ow_err_t)
+ *
+ * @details
+ * A family search starts with the family code as previous path and last discrepancy at
+ * bit 64, so the first pass finds the lowest ROM ID of that family. Search ends when the
+ * next discrepancy is inside the family code or the family is not on the bus.
+ */
+ow_err_t ow_search_start(ow_t *handle, uint8_t cmd, uint8_t family, ow_search_mode_t mode)
+{
+  assert_param(handle != NULL);
+
+  /* Keep ongoing transfer, only report busy */
+  if (handle->state != OW_STATE_IDLE)
+  {
+    OW_STATS_INC(handle, busy);
+    return OW_ERR_BUSY;
+  }
 
-  /************ Reading, phase 3: sample bus ************/
-  case 10:
-    __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_READ_HIGH - 1);
-    if (ow_read_bit(handle))
+  do
+  {
+    /* Lanes answer in lockstep, search and Match ROM need one lane */
+    if (OW_LANE_MULTI(handle))
     {
-      handle->search.val |= OW_VAL_0;
+      handle->error = OW_ERR_LEN;
+      ow_stop(handle);
+      break;
     }
-    handle->buf.bit_ph++;
 
-    /* resolve discrepancy */
-    /* Dallas counts bits 1..64 */
-    uint8_t bit_number = handle->buf.bit_idx + 1;
-    if (handle->search.val == OW_VAL_DIFF)
+    /* Start 1-Wire communication */
+    handle->error = ow_start(handle);
+    if (handle->error != OW_ERR_NONE)
     {
-      uint8_t bit_choice = 0;
-      if (bit_number < handle->search.last_discrepancy)
-      {
-        /* repeat previous path */
-        bit_choice = (handle->search.rom_id[handle->buf.bit_idx / 8] >> (handle->buf.bit_idx % 8)) & 0x01;
-      }
-      else if (bit_number == handle->search.last_discrepancy)
-      {
-        /* this time choose 1 */
-        bit_choice = 1;
-      }
-      else
-      {
-        /* choose 0 and remember as last zero */
-        bit_choice = 0;
-        handle->search.last_zero = bit_number;
-      }
-      handle->search.val = bit_choice ? OW_VAL_1 : OW_VAL_0;
+      /* Stop bus if start failed */
+      ow_stop(handle);
+      break;
     }
-    else if (handle->search.val == OW_VAL_ERR)
+
+    /* Prepare for ROM search */
+    handle->state = OW_STATE_SEARCH;
+    handle->buf.data[0] = cmd;
+#if (OW_RESUME == 1)
+    handle->resume_id = OW_RESUME_NONE;
+#endif
+
+    /* Clear previous search, ROM ID list is kept while merging or verifying */
+    memset(&handle->search, 0, sizeof(ow_search_t));
+    handle->search.mode = mode;
+    if (mode == OW_SEARCH_LIST)
     {
-      handle->error = OW_ERR_ROM_ID;
-      ow_stop(handle);
+      handle->rom_id_found = 0;
+      memset(handle->rom_id, 0, handle->rom_id_max * sizeof(ow_id_t));
     }
-    break;
 
-  /************ Writing selected bit, phase 1: pull low ************/
-  case 11:
-    if (handle->search.val == OW_VAL_1)
+    /* Target family as previous path */
+    if (family != 0)
     {
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_WRITE_LOW - 1);
-      handle->search.rom_id[handle->buf.bit_idx / 8] |= (1 << (handle->buf.bit_idx % 8));
+      handle->search.family = family;
+      handle->search.rom_id[0] = family;
+      handle->search.last_discrepancy = 64;
     }
-    else
+#if (OW_SEARCH_RETRY > 0)
+    memcpy(handle->search.path, handle->search.rom_id, 8);
+    handle->search.retry = OW_SEARCH_RETRY;
+#endif
+
+  } while (0);
+
+  return handle->error;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Write ROM select header of device to transfer buffer.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @param[in] rom_id: Index of the target ROM ID.
+ * @retval Header length: 9 for Match ROM, 1 for Resume.
+ *
+ * @details
+ * With OW_RESUME, a device of OW_RESUME_FAMILY stays selected after its transfer, so the
+ * next transfer to it sends Resume instead of the 64-bit ROM ID.
+ */
+uint16_t ow_select(ow_t *handle, uint8_t rom_id)
+{
+#if (OW_RESUME == 1)
+  if (handle->resume_id == rom_id)
+  {
+    handle->buf.data[0] = OW_CMD_RESUME;
+    return 1;
+  }
+
+  /* Match ROM selects this device, others are released */
+  handle->resume_id = OW_RESUME_NONE;
+  for (uint8_t idx = 0; idx < sizeof(ow_resume_family); idx++)
+  {
+    if (handle->rom_id[rom_id].rom_id_struct.family == ow_resume_family[idx])
     {
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_WRITE_HIGH - 1);
+      handle->resume_id = rom_id;
+      break;
     }
-    ow_write_bit(handle, false);
-    handle->buf.bit_ph++;
-    break;
+  }
+#endif
+
+  handle->buf.data[0] = OW_CMD_MATCH_ROM;
+  memcpy(&handle->buf.data[1], handle->rom_id[rom_id].array, 8);
+  return 9;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Merge found ROM ID into ROM ID list, new device takes first empty entry.
+ * @param  handle: Pointer to 1-Wire handle.
+ */
+void ow_search_merge(ow_t *handle)
+{
+  uint8_t free_idx = handle->rom_id_found;
 
-  /************ Writing selected bit, phase 2: release bus ************/
-  case 12:
-    if (handle->search.val == OW_VAL_1)
+  for (uint8_t idx = 0; idx < handle->rom_id_found; idx++)
+  {
+    if (memcmp(handle->rom_id[idx].array, handle->search.rom_id, 8) == 0)
     {
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_WRITE_HIGH - 1);
+      /* Known device, keeps its index */
+      handle->search.seen[idx / 8] |= (1 << (idx % 8));
+      return;
     }
-    else
+    if ((handle->rom_id[idx].rom_id_struct.family == 0) && (free_idx == handle->rom_id_found))
     {
-      __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, OW_TIM_WRITE_LOW - 1);
+      free_idx = idx;
     }
-    ow_write_bit(handle, true);
-    handle->buf.bit_idx++;
-    if (handle->buf.bit_idx == 64)
+  }
+
+  /* New device, dropped if list is full */
+  if (free_idx == handle->rom_id_max)
+  {
+    return;
+  }
+  if (free_idx == handle->rom_id_found)
+  {
+    handle->rom_id_found++;
+  }
+  memcpy(handle->rom_id[free_idx].array, handle->search.rom_id, 8);
+  handle->search.seen[free_idx / 8] |= (1 << (free_idx % 8));
+  if (handle->change_cb != NULL)
+  {
+    handle->change_cb(handle, free_idx, true);
+  }
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  End of rescan: report known devices not found as departed.
+ * @param  handle: Pointer to 1-Wire handle.
+ */
+void ow_search_merge_end(ow_t *handle)
+{
+  handle->search.mode = OW_SEARCH_LIST;
+
+  /* No presence pulse before any device found: bus is empty */
+  if (handle->error == OW_ERR_RESET)
+  {
+    bool seen = false;
+    for (uint8_t idx = 0; idx < sizeof(handle->search.seen); idx++)
     {
-      /* full ROM read */
-      handle->buf.bit_idx = 0;
-      handle->buf.bit_ph = 0;
-      if (ow_crc(handle->search.rom_id, 7) == handle->search.rom_id[7])
-      {
-        /* ROM ID Filter not enabled */
-        if (handle->rom_id_filter == 0)
-        {
-          memcpy(&handle->rom_id[handle->rom_id_found], handle->search.rom_id, 8);
-          handle->rom_id_found++;
-        }
-        /* Selected ROM ID Filter */
-        else if (handle->rom_id_filter == handle->search.rom_id[0])
-        {
-          memcpy(&handle->rom_id[handle->rom_id_found], handle->search.rom_id, 8);
-          handle->rom_id_found++;
-        }
-      }
-      memset(handle->search.rom_id, 0, 8);
+      seen |= (handle->search.seen[idx] != 0);
+    }
+    if (!seen)
+    {
+      handle->error = OW_ERR_NONE;
+    }
+  }
 
-      /* update discrepancy */
-      handle->search.last_discrepancy = handle->search.last_zero;
-      handle->search.last_zero = 0;
-      if (handle->search.last_discrepancy == 0 || handle->rom_id_found == OW_MAX_DEVICE)
-      {
-        handle->search.last_device_flag = 1;
-        handle->state = OW_STATE_DONE;
-      }
-      else
+  /* Failed search keeps ROM ID list */
+  if (handle->error != OW_ERR_NONE)
+  {
+    return;
+  }
+  for (uint8_t idx = 0; idx < handle->rom_id_found; idx++)
+  {
+    if ((handle->rom_id[idx].rom_id_struct.family != 0) && ((handle->search.seen[idx / 8] & (1 << (idx % 8))) == 0))
+    {
+      /* ROM ID still readable inside callback */
+      if (handle->change_cb != NULL)
       {
-        /* prepare next search */
-        handle->buf.data[0] = OW_CMD_SEARCH_ROM;
-        handle->buf.bit_idx = 0;
-        handle->buf.bit_ph = 0;
+        handle->change_cb(handle, idx, false);
       }
+      memset(handle->rom_id[idx].array, 0, 8);
     }
-    else
-    {
-      /* next search bit */
-      handle->buf.bit_ph = 5;
-    }
-    break;
-  default:
-    break;
   }
 }
 #endif
 
+#if (OW_BACKEND == OW_BACKEND_TIM)
 /*************************************************************************************************/
 /**
  * @brief Set 1-Wire bus pin high or low.
@@ -951,13 +3863,15 @@ __STATIC_FORCEINLINE void ow_write_bit(ow_t *handle, bool high)
 /**
  * @brief Read current level of 1-Wire bus pin.
  * @param[in] handle: Pointer to 1-Wire handle.
- * @retval 1 if high, 0 if low
+ * @retval 1 if high (all lanes high if OW_LANES > 1), 0 if low
  */
 __STATIC_FORCEINLINE uint8_t ow_read_bit(ow_t *handle)
 {
   assert_param(handle != NULL);
 
-#if (OW_DUAL_PINS == 0)
+#if (OW_LANES > 1)
+  return (((handle->config.gpio->IDR & handle->config.pin_read) == handle->config.pin_read) ? 1 : 0);
+#elif (OW_DUAL_PINS == 0)
   return ((handle->config.gpio->IDR & handle->config.pin_read) ? 1 : 0);
 #else
 #if (OW_INVERT_RX == 0)
@@ -967,6 +3881,42 @@ __STATIC_FORCEINLINE uint8_t ow_read_bit(ow_t *handle)
 #endif
 #endif
 }
+#endif
+
+#if (OW_STATS == 1)
+/*************************************************************************************************/
+/**
+ * @brief Store ISR calls, cycles and duration of finished transaction.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ *
+ * @details
+ * Called from ISR, the running ow_callback() is counted until now, so done_cb and the
+ * start of a queued transaction are not part of it.
+ */
+__STATIC_FORCEINLINE void ow_stats_done(ow_t *handle)
+{
+  uint32_t now = OW_CYCLES();
+
+  if (handle->stats_in_isr)
+  {
+    handle->stats_in_isr = false;
+    handle->stats_cyc += now - handle->stats_isr_t0;
+    handle->stats_isr++;
+  }
+  handle->stats.last_isr = handle->stats_isr;
+  handle->stats.last_isr_cyc = handle->stats_cyc;
+  handle->stats.last_dur_cyc = (handle->stats_t0 != 0) ? (now - handle->stats_t0) : 0;
+  handle->stats_t0 = 0;
+  handle->stats_isr = 0;
+  handle->stats_cyc = 0;
+}
+#endif
+
+/*************************************************************************************************/
+/** Slot ISR **/
+/*************************************************************************************************/
+
+#include "ow_isr_impl.h"
 
 /*************************************************************************************************/
 /** End of File **/
@@ -31,8 +31,65 @@ extern "C" {
 
 #include <stdbool.h>
 #include "main.h"
-#include "tim.h"
 #include "ow_config.h"
+#if (OW_BACKEND == OW_BACKEND_UART)
+#include "usart.h"
+#else
+#include "tim.h"
+#endif
+
+/*************************************************************************************************/
+/** Defines **/
+/*************************************************************************************************/
+
+/* Internal buffer size: ROM command, ROM ID, function command and data */
+#if (OW_MAX_DEVICE > 1)
+#define OW_BUF_LEN                (1 + 8 + 1 + OW_MAX_DATA_LEN)
+#else
+#define OW_BUF_LEN                (1 + 1 + OW_MAX_DATA_LEN)
+#endif
+
+#if (OW_TIM_HW == 1)
+/* Captured slots: transfer bits, or search command and three slots per ROM bit */
+#if ((OW_MAX_DEVICE > 1) && (OW_BUF_LEN * 8 < 8 + 64 * 3))
+#define OW_CAP_LEN                (8 + 64 * 3)
+#else
+#define OW_CAP_LEN                (OW_BUF_LEN * 8)
+#endif
+#endif
+
+/* Max write + read length of ow_xfer_buf(), data stays in caller buffers */
+#if (OW_TIM_HW == 1)
+#define OW_XFER_BUF_MAX           ((OW_CAP_LEN / 8) - (OW_BUF_LEN - OW_MAX_DATA_LEN))
+#else
+#define OW_XFER_BUF_MAX           ((0xFFFFUL / 8) - (OW_BUF_LEN - OW_MAX_DATA_LEN))
+#endif
+
+#if (OW_BACKEND == OW_BACKEND_TIM)
+/* Longest time to next timer event in ticks, with OW_TIM_SHARED half the 16-bit period,
+   so a deadline just passed is told apart from one far ahead */
+#if (OW_TIM_SHARED == 1)
+#define OW_TIM_SPAN               0x7FFFUL
+#else
+#define OW_TIM_SPAN               0xFFFFUL
+#endif
+#endif
+
+#if (OW_MAX_DEVICE > 1)
+/* ROM ID snapshot: version, count, ROM IDs and CRC16 of them */
+#define OW_ROM_SNAP_VER           0x01
+#define OW_ROM_SNAP_LEN(cnt)      (2 + (8 * (cnt)) + 2)
+#endif
+
+#if (OW_RESUME == 1)
+/* No device left selected for Resume */
+#define OW_RESUME_NONE            0xFF
+#endif
+
+#if (OW_QUEUE_LEN > 0)
+/* Queued transaction without ROM ID, sent by Skip ROM */
+#define OW_JOB_SKIP_ROM           0xFF
+#endif
 
 /*************************************************************************************************/
 /** Typedef/Struct/Enum **/
@@ -48,6 +105,8 @@ typedef enum
   OW_ERR_RESET,                    /* Reset failed */
   OW_ERR_LEN,                      /* Invalid data length */
   OW_ERR_ROM_ID,                   /* ROM ID error */
+  OW_ERR_TIMEOUT,                  /* Device did not release bus in time */
+  OW_ERR_CRC,                      /* Response CRC mismatch */
 
 } ow_err_t;
 
@@ -58,6 +117,7 @@ typedef enum
   OW_STATE_IDLE             = 0,   /* No activity */
   OW_STATE_XFER,                   /* Data transfer ongoing */
   OW_STATE_SEARCH,                 /* Searching devices on bus */
+  OW_STATE_PROG,                   /* Transaction program ongoing */
   OW_STATE_DONE,                   /* Operation completed */
 
 } ow_state_t;
@@ -82,9 +142,63 @@ typedef enum
   OW_CMD_SKIP_ROM           = 0xCC,
   OW_CMD_SEARCH_ROM         = 0xF0,
   OW_CMD_SEARCH_ALARM       = 0xEC,
+  OW_CMD_OD_SKIP_ROM        = 0x3C,
+  OW_CMD_OD_MATCH_ROM       = 0x69,
+  OW_CMD_RESUME             = 0xA5,
 
 } ow_cmd_t;
 
+/*************************************************************************************************/
+/* Bus speed, selects the slot timing table */
+typedef enum
+{
+  OW_SPEED_STD              = 0,   /* Standard speed */
+#if (OW_OVERDRIVE == 1)
+  OW_SPEED_OD,                     /* Overdrive speed */
+#endif
+  OW_SPEED_MAX,
+
+} ow_speed_t;
+
+/*************************************************************************************************/
+/* Slot timing table in timer ticks */
+typedef struct
+{
+  uint16_t                  rst;                           /* Reset low time */
+  uint16_t                  rst_det;                       /* Presence detect delay */
+  uint16_t                  write_high;                    /* Write 0 low, write 1 high time */
+  uint16_t                  write_low;                     /* Write 1 low, write 0 recovery time */
+  uint16_t                  read_low;                      /* Read slot low time */
+  uint16_t                  read_sample;                   /* Read slot sample delay */
+  uint16_t                  read_high;                     /* Read slot recovery time */
+
+} ow_tim_t;
+
+#if (OW_CALIB == 1)
+/*************************************************************************************************/
+/* Edge offset compensation of one bus in timer ticks, measured by ow_calibrate() */
+typedef struct
+{
+  int16_t                   write_rel;             /* Write release edge offset minus pull-low edge offset */
+  int16_t                   read_rel;              /* Read release edge offset minus pull-low edge offset */
+  int16_t                   read_smp;              /* Read sample offset minus release edge offset */
+  uint16_t                  lat_max;               /* Max ticks from timer event to pin access */
+
+} ow_calib_t;
+#endif
+
+#if (OW_RETRY == 1)
+/*************************************************************************************************/
+/* Response check of transfers with retry */
+typedef enum
+{
+  OW_CHECK_NONE             = 0,   /* Retry on missing presence pulse only */
+  OW_CHECK_CRC8,                   /* Last read byte is CRC8 of read bytes */
+  OW_CHECK_CRC16,                  /* Last two read bytes are inverted CRC16 of function command, write and read bytes */
+
+} ow_check_t;
+#endif
+
 /*************************************************************************************************/
 /* Union representing 64-bit ROM ID (family, serial, crc) */
 typedef union
@@ -100,25 +214,109 @@ typedef union
 
 } ow_id_t;
 
+#if (OW_PROG == 1)
+/*************************************************************************************************/
+/* Operation of a transaction program */
+typedef enum
+{
+  OW_OP_RESET               = 0,   /* Reset and presence detect */
+  OW_OP_SKIP_ROM,                  /* Write Skip ROM command */
+#if (OW_MAX_DEVICE > 1)
+  OW_OP_MATCH_ROM,                 /* Write Match ROM (or Resume) of ROM ID index len */
+#endif
+  OW_OP_WRITE,                     /* Write len bytes from w_data */
+  OW_OP_READ,                      /* Read len bytes into r_data */
+  OW_OP_WAIT_US,                   /* Keep bus released for len microseconds */
+  OW_OP_PULLUP_MS,                 /* Drive bus high (strong pull-up) for len milliseconds */
+  OW_OP_READ_UNTIL_1,              /* Read slots every interval until device sends 1, at most len slots */
+  OW_OP_READ_UNTIL_0,              /* Read slots every interval until device sends 0 (busy bridge), at most len slots */
+
+} ow_op_code_t;
+
+/*************************************************************************************************/
+/* One step of a transaction program, all steps run from ISR without reset in between */
+typedef struct
+{
+  ow_op_code_t              op;                    /* Operation */
+  uint16_t                  len;                   /* Bytes, microseconds, milliseconds or slots */
+  const uint8_t             *w_data;               /* Write data of OW_OP_WRITE */
+  uint8_t                   *r_data;               /* Read buffer of OW_OP_READ */
+  uint16_t                  interval;              /* Bus released between OW_OP_READ_UNTIL_x slots, in us */
+
+} ow_op_t;
+#endif
+
+#if ((OW_BACKEND == OW_BACKEND_TIM) && (OW_TIM_HW == 0))
+/*************************************************************************************************/
+/* Pin operations of one bus, set by a bus binding of ow.hpp */
+typedef struct
+{
+  GPIO_TypeDef              *gpio;                 /* GPIO TX port */
+  uint32_t                  pin_set;               /* BSRR value releasing the bus */
+  uint32_t                  pin_reset;             /* BSRR value pulling the bus low */
+  GPIO_TypeDef              *gpio_rx;              /* GPIO RX port, gpio if one pin */
+  uint32_t                  pin_read;              /* GPIO RX pin, or pins of all lanes */
+  uint32_t                  pin_inv;               /* RX pins inverted in hardware, 0 == none */
+
+} ow_pins_t;
+#endif
+
+struct ow_s;
+/*************************************************************************************************/
+/* Done callback with handle and user argument, e.g. an RTOS object to signal */
+typedef void (*ow_done_cb_t)(struct ow_s *handle, ow_err_t error, void *arg);
+
+#if (OW_TIM_SHARED == 1)
+/*************************************************************************************************/
+/* Event list of a shared compare channel, its buses sorted by next deadline */
+typedef struct
+{
+  struct ow_s               *head;                         /* Bus of earliest deadline, NULL == channel stopped */
+
+} ow_tim_list_t;
+#endif
+
 /*************************************************************************************************/
 /* Used to configure OneWire handle at startup */
 typedef struct
 {
+#if (OW_BACKEND == OW_BACKEND_UART)
+  UART_HandleTypeDef        *uart_handle;                  /* Half-duplex UART handle with TX/RX DMA */
+  void                      (*uart_cb)(UART_HandleTypeDef*); /* UART RX complete/error callback */
+#else
   TIM_HandleTypeDef         *tim_handle;                   /* Timer handle */
   void                      (*tim_cb)(TIM_HandleTypeDef*); /* Timer callback */
+#endif
   void                      (*done_cb)(ow_err_t);          /* Done callback */
+  ow_done_cb_t              done_arg_cb;                   /* Done callback with handle and argument, can be NULL */
+  void                      *done_arg;                     /* Argument of done_arg_cb */
 #if (OW_MAX_DEVICE > 1)
   uint8_t                   rom_id_filter;                 /* ROM ID Filter , 0 == Accept All */
 #endif
+#if (OW_ROM_TABLE == 1)
+  ow_id_t                   *rom_id_table;                 /* ROM ID table of this bus, cleared by ow_init() */
+  uint8_t                   rom_id_max;                    /* Entries of rom_id_table, 1 to OW_MAX_DEVICE */
+#endif
+#if (OW_BACKEND == OW_BACKEND_TIM)
 #if (OW_DUAL_PINS == 0)
   GPIO_TypeDef              *gpio;                         /* GPIO TX/RX port */
-  uint16_t                  pin;                           /* GPIO TX/RX pin */
+  uint16_t                  pin;                           /* GPIO TX/RX pin, or pins of all lanes if OW_LANES > 1 */
 #else
   GPIO_TypeDef              *gpio_tx;                      /* GPIO TX port */
   uint16_t                  pin_tx;                        /* GPIO TX pin */
   GPIO_TypeDef              *gpio_rx;                      /* GPIO RX port */
   uint16_t                  pin_rx;                        /* GPIO RX pin */
 #endif
+#if (OW_TIM_HW == 1)
+  uint32_t                  tim_ch;                        /* Timer PWM channel on pin, paired channel captures */
+#else
+#if (OW_TIM_SHARED == 1)
+  uint32_t                  tim_ch;                        /* Timer compare channel of this bus */
+  ow_tim_list_t             *tim_list;                     /* Event list shared by buses of tim_ch, NULL == tim_ch alone */
+#endif
+  const ow_pins_t           *pins;                         /* Pins of an ow.hpp binding, NULL == pins above */
+#endif
+#endif
 
 } ow_init_t;
 
@@ -126,21 +324,37 @@ typedef struct
 /* Internal buffer used for read/write operations */
 typedef struct
 {
-#if (OW_MAX_DEVICE > 1)
-  uint8_t                   data[1 + 8 + 1 + OW_MAX_DATA_LEN];
-#else
-  uint8_t                   data[1 + 1 + OW_MAX_DATA_LEN];
-#endif
+  uint8_t                   data[OW_BUF_LEN];
   uint8_t                   bit_ph;
   uint8_t                   bit_idx;
   uint16_t                  byte_idx;
   uint16_t                  write_len;
   uint16_t                  read_len;
+  uint8_t                   crc;                   /* CRC8 of received bytes */
+  const uint8_t             *w_ptr;                /* Caller write data after header, NULL == in data */
+  uint8_t                   *r_ptr;                /* Caller read buffer, NULL == in data */
+  uint16_t                  hdr_len;               /* Header length in data, before caller write data */
+#if (OW_BACKEND == OW_BACKEND_UART)
+  uint16_t                  slot_idx;              /* Transfer slot at start of slot buffer */
+#endif
+#if (OW_OVERDRIVE == 1)
+  uint16_t                  od_idx;                /* Switch to overdrive from this byte, 0 == none */
+#endif
 
 } ow_buf_t;
 
 /*************************************************************************************************/
 #if (OW_MAX_DEVICE > 1)
+/* What a search does with found ROM IDs */
+typedef enum
+{
+  OW_SEARCH_LIST            = 0,   /* Replace ROM ID list */
+  OW_SEARCH_MERGE,                 /* Merge into ROM ID list, indices of known devices kept */
+  OW_SEARCH_VERIFY,                /* Check one known ROM ID */
+
+} ow_search_mode_t;
+
+/*************************************************************************************************/
 /* Maintains state for ROM search algorithm */
 typedef struct __PACKED
 {
@@ -148,7 +362,16 @@ typedef struct __PACKED
   uint8_t                   last_discrepancy;
   uint8_t                   last_zero;
   uint8_t                   last_device_flag;
+  uint8_t                   crc;
+  uint8_t                   family;                /* Target family, 0 == all */
+  uint8_t                   mode;                  /* ow_search_mode_t */
+  uint8_t                   target;                /* ROM ID index checked by OW_SEARCH_VERIFY */
+  uint8_t                   seen[(OW_MAX_DEVICE + 7) / 8]; /* ROM IDs found by OW_SEARCH_MERGE */
   uint8_t                   rom_id[8];
+#if (OW_SEARCH_RETRY > 0)
+  uint8_t                   path[8];               /* Path of running pass, walked again after a failed pass */
+  uint8_t                   retry;                 /* Repeats of running pass left */
+#endif
 
 } ow_search_t;
 #endif
@@ -157,31 +380,219 @@ typedef struct __PACKED
 /* Precomputed pin operations for faster bit manipulation */
 typedef struct
 {
+#if (OW_BACKEND == OW_BACKEND_UART)
+  UART_HandleTypeDef        *uart_handle;
+  void                      (*done_cb)(ow_err_t);
+  ow_done_cb_t              done_arg_cb;
+  void                      *done_arg;
+  uint32_t                  brr_rst[OW_SPEED_MAX];         /* Baud rate register for reset slot */
+  uint32_t                  brr_data[OW_SPEED_MAX];        /* Baud rate register for bit slots */
+#else
   TIM_HandleTypeDef         *tim_handle;
   void                      (*done_cb)(ow_err_t);
+  ow_done_cb_t              done_arg_cb;
+  void                      *done_arg;
   GPIO_TypeDef              *gpio;
   uint32_t                  pin_set;
   uint32_t                  pin_reset;
   uint32_t                  pin_read;
-#if (OW_DUAL_PINS == 1)
-  GPIO_TypeDef              *gpio_rx;
+  GPIO_TypeDef              *gpio_rx;                      /* GPIO RX port, gpio if one pin */
+  uint32_t                  pin_inv;                       /* RX pins inverted, 0 == none */
+#if (OW_TIM_HW == 1)
+  uint32_t                  tim_ch_out;                    /* PWM channel driving the bus */
+  uint32_t                  tim_ch_in;                     /* Paired input capture channel */
+  DMA_HandleTypeDef         *tim_dma;                      /* DMA of input capture channel, halfword */
+#endif
+#if (OW_TIM_SHARED == 1)
+  uint32_t                  tim_ch;                        /* Compare channel scheduling this bus */
+  uint32_t                  tim_active;                    /* HAL active channel of tim_ch */
+  uint32_t                  tim_it;                        /* Compare interrupt of tim_ch */
+  ow_tim_list_t             *tim_list;                     /* Event list of tim_ch, own or shared */
+#endif
 #endif
 
 } ow_config_t;
 
+#if (OW_MAX_DEVICE > 1)
 /*************************************************************************************************/
-/* Main driver handle containing state, config and buffers */
+/* Rescan callback, device at ROM ID index arrived or departed */
+typedef void (*ow_change_cb_t)(struct ow_s *handle, uint8_t rom_id, bool arrived);
+#endif
+
+#if (OW_QUEUE_LEN > 0)
+/*************************************************************************************************/
+/* Transaction done callback, response can be read by ow_read_resp() inside it */
+typedef void (*ow_job_cb_t)(struct ow_s *handle, ow_err_t error, void *arg);
+
+/*************************************************************************************************/
+/* Queued transaction */
+typedef struct
+{
+  ow_job_cb_t               cb;                    /* Done callback, can be NULL */
+  void                      *arg;                  /* Callback argument */
+  uint8_t                   rom_id;                /* ROM ID index, or OW_JOB_SKIP_ROM */
+  uint8_t                   fn_cmd;                /* Function command */
+  uint16_t                  w_len;                 /* Write data length */
+  uint16_t                  r_len;                 /* Read data length */
+  uint8_t                   w_data[OW_MAX_DATA_LEN]; /* Write data */
+
+} ow_job_t;
+#endif
+
+#if (OW_STATS == 1)
+/*************************************************************************************************/
+/* Runtime counters and ISR cost of one bus */
+typedef struct
+{
+  uint32_t                  xfer;                  /* Finished transactions, including searches */
+  uint32_t                  xfer_err;              /* Transactions finished with error */
+  uint32_t                  bits_tx;               /* Written bits of successful transactions */
+  uint32_t                  bits_rx;               /* Read bits of successful transactions */
+  uint32_t                  reset_err;             /* Resets without presence pulse */
+  uint32_t                  search_crc_err;        /* Search passes with bad ROM ID CRC */
+  uint32_t                  search_pass;           /* Search passes, one per ROM ID walked */
+  uint32_t                  search_retry;          /* Search passes walked again by OW_SEARCH_RETRY */
+  uint32_t                  busy;                  /* Calls rejected with OW_ERR_BUSY */
+  uint32_t                  retry;                 /* Transfers run again by OW_RETRY */
+  uint32_t                  isr_cnt;               /* Measured ow_callback() calls */
+  uint32_t                  isr_cyc_min;           /* Min CPU cycles in ow_callback() */
+  uint32_t                  isr_cyc_max;           /* Max CPU cycles in ow_callback() */
+  uint32_t                  isr_cyc_avg;           /* Average CPU cycles, set by ow_stats() */
+  uint64_t                  isr_cyc_sum;           /* Sum of CPU cycles */
+  uint16_t                  isr_lat_min;           /* Min timer ticks from event to ISR entry */
+  uint16_t                  isr_lat_max;           /* Max timer ticks from event to ISR entry */
+  uint32_t                  last_isr;              /* ow_callback() calls of last transaction */
+  uint32_t                  last_isr_cyc;          /* CPU cycles in ow_callback() of last transaction, until done */
+  uint32_t                  last_dur_cyc;          /* CPU cycles from start to done of last transaction */
+
+} ow_stats_t;
+#endif
+
+#if (OW_TRACE == 1)
+/*************************************************************************************************/
+/* One timer event of trace ring, recorded at ow_callback() entry */
+typedef struct
+{
+  uint16_t                  time;                  /* Programmed event time in timer ticks, since first event of transaction */
+  uint16_t                  lat;                   /* Timer ticks from programmed event to ISR entry */
+  uint8_t                   state;                 /* ow_state_t at entry */
+  uint8_t                   phase;                 /* Bit phase at entry, i.e. phase handled by this event */
+  uint8_t                   bit_idx;               /* Bit index at entry */
+  uint8_t                   level;                 /* Bus level at entry, the read bit in sample phases */
+
+} ow_trace_t;
+#endif
+
+#if (OW_MARGIN == 1)
+/*************************************************************************************************/
+/* Captured edges of last transaction in timer ticks, read slots from slot start */
 typedef struct
+{
+  uint16_t                  presence_start;        /* Start of presence pulse after reset release, last reset */
+  uint16_t                  presence_width;        /* Length of presence pulse, last reset */
+  uint16_t                  rise_min;              /* Earliest read 1, master release plus rise time */
+  uint16_t                  rise_max;              /* Latest read 1 */
+  uint16_t                  hold_min;              /* Earliest read 0, device releases the bus */
+  uint16_t                  hold_max;              /* Latest read 0 */
+  uint16_t                  ones;                  /* Read 1 slots */
+  uint16_t                  zeros;                 /* Read 0 slots */
+
+} ow_margin_t;
+#endif
+
+/*************************************************************************************************/
+/* Main driver handle containing state, config and buffers */
+typedef struct ow_s
 {
   ow_config_t               config;                /* Static configuration */
   ow_buf_t                  buf;                   /* Transfer buffer */
   ow_state_t                state;                 /* Current state */
   ow_err_t                  error;                 /* Last error */
+  ow_speed_t                speed;                 /* Selected bus speed */
+#if (OW_BACKEND == OW_BACKEND_UART)
+  uint8_t                   slot[OW_BUF_LEN * 8];  /* One UART byte per bit slot, TX and RX echo */
+#else
+  const ow_tim_t            *tim;                  /* Active slot timing */
+  ow_tim_t                  tim_table[OW_SPEED_MAX]; /* Slot timing per speed */
+#if (OW_TIM_HW == 1)
+  uint16_t                  cap[OW_CAP_LEN];       /* Rising edge time in each slot, by DMA */
+#endif
+#if (OW_TIM_SHARED == 1)
+  ow_tim_list_t             tim_own;               /* Event list of a compare channel not shared */
+  struct ow_s               *tim_next;             /* Bus of next deadline on compare channel */
+  uint32_t                  tim_due;               /* Counter value of next event */
+  bool                      tim_linked;            /* In event list of compare channel */
+#endif
+#endif
   uint8_t                   rom_id_filter;         /* Filter of ROM ID */
+#if (OW_ROM_TABLE == 1)
+  ow_id_t                   *rom_id;               /* List of ROM IDs, table of caller */
+#else
   ow_id_t                   rom_id[OW_MAX_DEVICE]; /* List of ROM IDs */
+#endif
 #if (OW_MAX_DEVICE > 1)
+  uint8_t                   rom_id_max;            /* Entries of ROM ID list */
   uint8_t                   rom_id_found;          /* Number of devices found */
   ow_search_t               search;                /* Search state */
+  ow_change_cb_t            change_cb;             /* Rescan callback, can be NULL */
+#endif
+#if (OW_RESUME == 1)
+  uint8_t                   resume_id;             /* ROM ID index still selected, or OW_RESUME_NONE */
+#endif
+#if (OW_PROG == 1)
+  const ow_op_t             *prog;                 /* Running transaction program */
+  uint8_t                   prog_cnt;              /* Number of steps */
+  uint8_t                   prog_idx;              /* Next step */
+  uint32_t                  prog_wait;             /* Remaining microseconds of wait */
+  uint16_t                  prog_poll;             /* Remaining slots of OW_OP_READ_UNTIL_x */
+  uint8_t                   prog_cmd;              /* Function command of ow_xfer_poll/pullup() */
+  ow_op_t                   prog_op[4];            /* Program of ow_xfer_poll/pullup() */
+#endif
+#if (OW_LANES > 1)
+  uint8_t                   lane_cnt;              /* Number of lanes driven in lockstep */
+  uint16_t                  lane_pin[OW_LANES];    /* Pin of each lane */
+  uint16_t                  lane_absent;           /* Pins without presence pulse in last reset */
+  uint8_t                   lane_data[OW_LANES - 1][OW_MAX_DATA_LEN]; /* Response of lanes 1..n, lane 0 in buf */
+#endif
+#if (OW_QUEUE_LEN > 0)
+  ow_job_t                  queue[OW_QUEUE_LEN];   /* Ring of queued transactions */
+  volatile uint8_t          queue_head;            /* Next transaction to start */
+  volatile uint8_t          queue_cnt;             /* Number of queued transactions */
+  ow_job_cb_t               job_cb;                /* Done callback of running transaction */
+  void                      *job_arg;              /* Callback argument of running transaction */
+#endif
+#if (OW_STATS == 1)
+  ow_stats_t                stats;                 /* Runtime counters */
+  uint32_t                  stats_t0;              /* Cycle count at start of transaction, 0 if not started */
+  uint32_t                  stats_isr_t0;          /* Cycle count at entry of running ow_callback() */
+  uint32_t                  stats_isr;             /* ow_callback() calls of running transaction */
+  uint32_t                  stats_cyc;             /* CPU cycles in ow_callback() of running transaction */
+  bool                      stats_in_isr;          /* Running ow_callback() is not yet counted */
+#endif
+#if (OW_TRACE == 1)
+  ow_trace_t                trace[OW_TRACE_LEN];   /* Ring of last timer events */
+  uint16_t                  trace_head;            /* Next entry to write */
+  uint16_t                  trace_cnt;             /* Valid entries */
+  uint32_t                  trace_time;            /* Time of next programmed event in timer ticks */
+  bool                      trace_hold;            /* Transaction failed, ring kept until read */
+#endif
+#if (OW_MARGIN == 1)
+  ow_margin_t               margin;                /* Edge timing of running or last transaction */
+#endif
+#if (OW_RETRY == 1)
+  ow_check_t                retry_check;           /* Response check of next transfers */
+  uint8_t                   retry_max;             /* Retries of next transfers */
+  uint16_t                  retry_backoff;         /* Bus idle time before retry, in timer ticks */
+  bool                      retry_on;              /* Running transfer is checked and retried */
+  uint8_t                   retry_left;            /* Retries left of running transfer */
+  uint16_t                  retry_fn_idx;          /* Function command index in write bytes */
+  ow_buf_t                  retry_buf;             /* Transfer buffer as prepared, restored on retry */
+#endif
+#if (OW_CALIB == 1)
+  ow_calib_t                calib;                 /* Edge offset compensation */
+  bool                      calib_run;             /* Calibration transfer ongoing */
+  uint32_t                  calib_sum[5];          /* Sum of edge offsets per measure point */
+  uint16_t                  calib_cnt[5];          /* Samples per measure point */
 #endif
 
 } ow_t;
@@ -193,35 +604,173 @@ typedef struct
 /* Initialize OneWire driver */
 void      ow_init(ow_t *handle, const ow_init_t *init);
 
-/* Must be called in timer ISR to handle timing */
+/* Must be called in timer ISR (or UART RX complete/error callback) to handle timing */
 void      ow_callback(ow_t *handle);
 
 /* Calculate CRC8 for given data */
 uint8_t   ow_crc(const uint8_t *data, uint16_t len);
 
+/* Update CRC8 with one byte */
+uint8_t   ow_crc_update(uint8_t crc, uint8_t data);
+
+/* Calculate CRC16 for given data */
+uint16_t  ow_crc16(const uint8_t *data, uint16_t len);
+
+/* Update CRC16 with one byte */
+uint16_t  ow_crc16_update(uint16_t crc, uint8_t data);
+
 /* Check if driver is busy */
 bool      ow_is_busy(ow_t *handle);
 
 /* Get last error code */
 ow_err_t  ow_last_error(ow_t *handle);
 
+/* Stop running transfer or search, e.g. after a wait timed out */
+void      ow_abort(ow_t *handle);
+
 /* Update device ROM ID(s) on bus */
 ow_err_t  ow_update_rom_id(ow_t *handle);
 
 /* Transfer a command and optional data to/from a specific 1-Wire device by SKIP ROM */
 ow_err_t  ow_xfer(ow_t *handle, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len, uint16_t r_len);
 
+/* Transfer by SKIP ROM directly from/to caller buffers, valid until transfer is done */
+ow_err_t  ow_xfer_buf(ow_t *handle, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len, uint8_t *r_data,
+                      uint16_t r_len);
+
 #if (OW_MAX_DEVICE > 1)
 /* Transfer a command and optional data to/from a specific 1-Wire device by ROM ID index */
 ow_err_t  ow_xfer_by_id(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len, uint16_t r_len);
 
+/* Transfer by ROM ID index directly from/to caller buffers, valid until transfer is done */
+ow_err_t  ow_xfer_buf_by_id(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len,
+                            uint8_t *r_data, uint16_t r_len);
+
 /* Return number of devices found */
 uint8_t   ow_devices(ow_t *handle);
+
+/* Search devices of one family only, replaces ROM ID list */
+ow_err_t  ow_search_family(ow_t *handle, uint8_t family);
+
+/* Search devices in alarm state (conditional search), replaces ROM ID list */
+ow_err_t  ow_search_alarm(ow_t *handle, uint8_t family);
+
+/* Search and merge into ROM ID list, report arrived and departed devices */
+ow_err_t  ow_rescan(ow_t *handle, ow_change_cb_t cb);
+
+/* Check if a known device is still on the bus */
+ow_err_t  ow_verify(ow_t *handle, uint8_t rom_id);
+
+/* Store ROM ID list into a snapshot, e.g. in flash or backup RAM */
+uint16_t  ow_rom_export(ow_t *handle, uint8_t *snap, uint16_t snap_size);
+
+/* Restore ROM ID list from a snapshot instead of a search */
+ow_err_t  ow_rom_import(ow_t *handle, const uint8_t *snap, uint16_t snap_len);
+#endif
+
+/* Select bus speed for next transfers */
+ow_err_t  ow_set_speed(ow_t *handle, ow_speed_t speed);
+
+/* Set done callback with handle and argument */
+ow_err_t  ow_set_done_cb(ow_t *handle, ow_done_cb_t cb, void *arg);
+
+#if (OW_BACKEND == OW_BACKEND_TIM)
+/* Replace slot timing table of a bus speed */
+ow_err_t  ow_set_timing(ow_t *handle, ow_speed_t speed, const ow_tim_t *tim);
+#endif
+
+#if (OW_RETRY == 1)
+/* Set response check and retries of next transfers */
+ow_err_t  ow_set_retry(ow_t *handle, ow_check_t check, uint8_t retry, uint16_t backoff_us);
+#endif
+
+#if (OW_CALIB == 1)
+/* Measure edge offsets of ISR on this bus by a Read ROM transfer, compensate next slots */
+ow_err_t  ow_calibrate(ow_t *handle);
+
+/* Get edge offset compensation, e.g. to store it */
+void      ow_get_calib(ow_t *handle, ow_calib_t *calib);
+
+/* Set edge offset compensation, e.g. stored one or zero to disable */
+ow_err_t  ow_set_calib(ow_t *handle, const ow_calib_t *calib);
+#endif
+
+#if (OW_OVERDRIVE == 1)
+/* Switch all overdrive capable devices to overdrive by Overdrive Skip ROM */
+ow_err_t  ow_overdrive(ow_t *handle);
+
+#if (OW_MAX_DEVICE > 1)
+/* Switch a specific device to overdrive by Overdrive Match ROM */
+ow_err_t  ow_overdrive_by_id(ow_t *handle, uint8_t rom_id);
+#endif
+#endif
+
+#if (OW_PROG == 1)
+/* Run a transaction program, buffers and steps valid until transfer is done */
+ow_err_t  ow_xfer_prog(ow_t *handle, const ow_op_t *prog, uint8_t prog_cnt);
+
+/* Send command by SKIP ROM, then poll read slots until device is done */
+ow_err_t  ow_xfer_poll(ow_t *handle, uint8_t fn_cmd, uint16_t interval_us, uint16_t timeout_ms);
+
+/* Send command by SKIP ROM, then hold strong pull-up for parasite powered devices */
+ow_err_t  ow_xfer_pullup(ow_t *handle, uint8_t fn_cmd, uint16_t pullup_ms);
+
+#if (OW_MAX_DEVICE > 1)
+/* Send command by ROM ID index, then poll read slots until device is done */
+ow_err_t  ow_xfer_poll_by_id(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, uint16_t interval_us, uint16_t timeout_ms);
+
+/* Send command by ROM ID index, then hold strong pull-up for parasite powered devices */
+ow_err_t  ow_xfer_pullup_by_id(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, uint16_t pullup_ms);
+#endif
+#endif
+
+#if (OW_QUEUE_LEN > 0)
+/* Queue a transaction by SKIP ROM, started when bus is free */
+ow_err_t  ow_queue_xfer(ow_t *handle, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len, uint16_t r_len,
+                        ow_job_cb_t cb, void *arg);
+
+#if (OW_MAX_DEVICE > 1)
+/* Queue a transaction by ROM ID index, started when bus is free */
+ow_err_t  ow_queue_xfer_by_id(ow_t *handle, uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len,
+                              uint16_t r_len, ow_job_cb_t cb, void *arg);
+#endif
+
+/* Return number of queued transactions, running one not included */
+uint8_t   ow_queue_count(ow_t *handle);
 #endif
 
 /* Retrieve last response data */
 uint16_t  ow_read_resp(ow_t *handle, uint8_t *data, uint16_t data_size);
 
+/* Get CRC8 of last response data */
+uint8_t   ow_resp_crc(ow_t *handle);
+
+#if (OW_LANES > 1)
+/* Retrieve last response data of one lane */
+uint16_t  ow_read_resp_lane(ow_t *handle, uint8_t lane, uint8_t *data, uint16_t data_size);
+
+/* Get last error of one lane */
+ow_err_t  ow_lane_error(ow_t *handle, uint8_t lane);
+#endif
+
+#if (OW_STATS == 1)
+/* Copy runtime counters of bus, optionally clear them */
+void      ow_stats(ow_t *handle, ow_stats_t *stats, bool clear);
+#endif
+
+#if (OW_TRACE == 1)
+/* Copy timer events of trace ring, oldest first, and clear it */
+uint16_t  ow_trace_read(ow_t *handle, ow_trace_t *trace, uint16_t trace_size);
+#endif
+
+#if (OW_MARGIN == 1)
+/* Copy edge timing of last transaction */
+ow_err_t  ow_margin(ow_t *handle, ow_margin_t *margin);
+
+/* Move read sample point to earliest safe tick of last transaction, slot length kept */
+ow_err_t  ow_margin_tune(ow_t *handle, uint16_t guard);
+#endif
+
 /*************************************************************************************************/
 /** End of File **/
 /*************************************************************************************************/
@@ -0,0 +1,439 @@
+
+/*
+ * @file        ow.hpp
+ * @brief       OneWire C++ front end with compile-time bus bindings
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+#ifndef _OW_HPP_
+#define _OW_HPP_
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ow.h"
+#include "ow_isr.h"
+
+#if (__cplusplus < 201703L)
+#error  ow.hpp needs C++17 or newer!
+#endif
+
+namespace ow
+{
+
+/*************************************************************************************************/
+/** Bus Base **/
+/*************************************************************************************************/
+
+/**
+ * @brief Calls shared by all bus bindings, one handle per binding.
+ * @tparam Bind: Binding type, each binding owns its own handle and callback().
+ */
+template <typename Bind>
+class BusBase
+{
+public:
+  /* Handle of this bus, for API functions not wrapped here */
+  static ow_t *handle() { return &handle_; }
+
+  static bool is_busy() { return ow_is_busy(&handle_); }
+  static ow_err_t last_error() { return ow_last_error(&handle_); }
+  static ow_err_t update_rom_id() { return ow_update_rom_id(&handle_); }
+
+  static ow_err_t xfer(uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len, uint16_t r_len)
+  {
+    return ow_xfer(&handle_, fn_cmd, w_data, w_len, r_len);
+  }
+
+  static ow_err_t xfer_buf(uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len, uint8_t *r_data, uint16_t r_len)
+  {
+    return ow_xfer_buf(&handle_, fn_cmd, w_data, w_len, r_data, r_len);
+  }
+
+#if (OW_MAX_DEVICE > 1)
+  static uint8_t devices() { return ow_devices(&handle_); }
+
+  static ow_err_t xfer_by_id(uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len, uint16_t r_len)
+  {
+    return ow_xfer_by_id(&handle_, rom_id, fn_cmd, w_data, w_len, r_len);
+  }
+
+  static ow_err_t xfer_buf_by_id(uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len,
+                                 uint8_t *r_data, uint16_t r_len)
+  {
+    return ow_xfer_buf_by_id(&handle_, rom_id, fn_cmd, w_data, w_len, r_data, r_len);
+  }
+#endif
+
+  static uint16_t read_resp(uint8_t *data, uint16_t data_size) { return ow_read_resp(&handle_, data, data_size); }
+  static uint8_t resp_crc() { return ow_resp_crc(&handle_); }
+
+#if (OW_ROM_TABLE == 1)
+  /* ROM ID table of this bus, set before init() */
+  template <size_t N>
+  static void rom_table(ow_id_t (&rom_id)[N])
+  {
+    static_assert((N > 0) && (N <= OW_MAX_DEVICE), "ROM ID table needs 1 to OW_MAX_DEVICE entries");
+    rom_id_table_ = rom_id;
+    rom_id_max_ = N;
+  }
+#endif
+
+protected:
+  /* Init with bindings of derived class, select bus speed */
+  static void start(ow_init_t init, ow_speed_t speed)
+  {
+#if (OW_ROM_TABLE == 1)
+    init.rom_id_table = rom_id_table_;
+    init.rom_id_max = rom_id_max_;
+#endif
+    ow_init(&handle_, &init);
+    if (speed != OW_SPEED_STD)
+    {
+      ow_set_speed(&handle_, speed);
+    }
+  }
+
+  static inline ow_t handle_;
+#if (OW_ROM_TABLE == 1)
+  static inline ow_id_t *rom_id_table_;
+  static inline uint8_t rom_id_max_;
+#endif
+};
+
+/*************************************************************************************************/
+/** Pin Bindings **/
+/*************************************************************************************************/
+
+#if (OW_BACKEND == OW_BACKEND_TIM)
+/**
+ * @brief Pin access of one bus, ports and BSRR/IDR masks fixed at compile time.
+ * @tparam TxBase: GPIO port base address driving the bus.
+ * @tparam PinSet: BSRR value releasing the bus.
+ * @tparam PinReset: BSRR value pulling the bus low.
+ * @tparam RxBase: GPIO port base address reading the bus.
+ * @tparam PinRead: IDR mask of bus level (pins of all lanes if OW_LANES > 1).
+ * @tparam PinInv: IDR bits inverted in hardware, 0 == none.
+ */
+template <uintptr_t TxBase, uint32_t PinSet, uint32_t PinReset, uintptr_t RxBase, uint32_t PinRead, uint32_t PinInv>
+struct PinBase
+{
+  static constexpr uintptr_t tx_base = TxBase;
+  static constexpr uint32_t  pin_set = PinSet;
+  static constexpr uint32_t  pin_reset = PinReset;
+  static constexpr uintptr_t rx_base = RxBase;
+  static constexpr uint32_t  pin_read = PinRead;
+  static constexpr uint32_t  pin_inv = PinInv;
+
+  /* Release (true) or pull low (false) the bus, one store of a constant */
+  __STATIC_FORCEINLINE void write(bool high)
+  {
+    reinterpret_cast<GPIO_TypeDef *>(TxBase)->BSRR = high ? PinSet : PinReset;
+  }
+
+  /* Bus level, 1 == high (all lanes high if OW_LANES > 1) */
+  __STATIC_FORCEINLINE uint8_t read()
+  {
+    return (((reinterpret_cast<GPIO_TypeDef *>(RxBase)->IDR ^ PinInv) & PinRead) == PinRead) ? 1 : 0;
+  }
+
+#if (OW_TIM_HW == 0)
+  /* Pin operations as stored in the handle, for the functions of ow.c */
+  static ow_pins_t pins()
+  {
+    ow_pins_t pins = { reinterpret_cast<GPIO_TypeDef *>(TxBase), PinSet, PinReset,
+                       reinterpret_cast<GPIO_TypeDef *>(RxBase), PinRead, PinInv };
+    return pins;
+  }
+#endif
+};
+
+/**
+ * @brief Open-drain pin, bus driven and read on the same GPIO pin.
+ * @tparam PortBase: GPIO port base address, e.g. GPIOC_BASE.
+ * @tparam Pin: GPIO pin mask, e.g. GPIO_PIN_8 (pins of all lanes if OW_LANES > 1).
+ */
+template <uintptr_t PortBase, uint16_t Pin>
+struct OpenDrain : PinBase<PortBase, Pin, static_cast<uint32_t>(Pin) << 16, PortBase, Pin, 0>
+{
+  static_assert(Pin != 0, "Pin must select at least one GPIO pin");
+  static_assert((OW_LANES > 1) || ((Pin & (Pin - 1)) == 0), "Pin must be one GPIO pin without OW_LANES");
+
+  static constexpr uint16_t tx_pin = Pin;
+  static constexpr bool     dual = false;
+};
+
+#if (OW_LANES == 1)
+/**
+ * @brief Dual pins (isolated TX/RX), TX drives a transistor pulling the bus low.
+ * @tparam TxBase: GPIO port base address of TX pin.
+ * @tparam TxPin: GPIO TX pin mask.
+ * @tparam RxBase: GPIO port base address of RX pin.
+ * @tparam RxPin: GPIO RX pin mask.
+ * @tparam InvertTx: false == TX high pulls the bus low, true == TX low pulls it low.
+ * @tparam InvertRx: true if RX reads the inverted bus level.
+ */
+template <uintptr_t TxBase, uint16_t TxPin, uintptr_t RxBase, uint16_t RxPin, bool InvertTx = false, bool InvertRx = false>
+struct DualPin : PinBase<TxBase,
+                         InvertTx ? static_cast<uint32_t>(TxPin) : static_cast<uint32_t>(TxPin) << 16,
+                         InvertTx ? static_cast<uint32_t>(TxPin) << 16 : static_cast<uint32_t>(TxPin),
+                         RxBase, RxPin, InvertRx ? RxPin : 0>
+{
+  static_assert((TxPin != 0) && ((TxPin & (TxPin - 1)) == 0), "TxPin must be one GPIO pin");
+  static_assert((RxPin != 0) && ((RxPin & (RxPin - 1)) == 0), "RxPin must be one GPIO pin");
+
+  static constexpr uint16_t tx_pin = TxPin;
+  static constexpr bool     dual = true;
+};
+#endif
+
+#if (OW_TIM_HW == 0)
+/*************************************************************************************************/
+/** Slot ISR **/
+/*************************************************************************************************/
+
+/**
+ * @brief Slot ISR of ow_isr_impl.h built for one pin binding and slot timing.
+ * @tparam Pins: Pin binding, e.g. OpenDrain<GPIOC_BASE, GPIO_PIN_8>.
+ * @tparam Timing: Slot timing per bus speed (OW_SPEED_MAX entries), nullptr == timing of handle.
+ *
+ * @details
+ * Pin writes are one store of a constant BSRR value to a constant address and pin reads
+ * need no handle field, so each bus may use its own pin mode in one image. Buses with the
+ * same Pins and Timing share one ISR.
+ */
+template <typename Pins, const ow_tim_t *Timing>
+struct Isr
+{
+  /* Slot timing at current bus speed */
+  __STATIC_FORCEINLINE const ow_tim_t *ow_slot_tim(ow_t *handle)
+  {
+    if constexpr (Timing != nullptr)
+    {
+      return &Timing[(OW_OVERDRIVE == 1) ? handle->speed : OW_SPEED_STD];
+    }
+    else
+    {
+      return handle->tim;
+    }
+  }
+
+#define OW_PIN_WRITE(handle, high)      Pins::write(high)
+#define OW_PIN_READ(handle)             Pins::read()
+#define OW_SLOT(handle, field)          (ow_slot_tim(handle)->field)
+#include "ow_isr_impl.h"
+#undef OW_PIN_WRITE
+#undef OW_PIN_READ
+#undef OW_SLOT
+};
+#endif
+
+/*************************************************************************************************/
+/** Bus Bindings **/
+/*************************************************************************************************/
+
+#if (OW_TIM_SHARED == 1)
+/**
+ * @brief Bindings of one shared timer, one trampoline calls the ISR of each binding.
+ * @tparam Tim: Timer handle, e.g. htim1.
+ *
+ * @details
+ * HAL keeps one compare callback per timer, so every binding registers the same trampoline
+ * and appends itself to the chain. ow_isr() of a bus returns at once on events of another
+ * channel or bus. Bindings on one channel share its event list.
+ */
+template <TIM_HandleTypeDef &Tim>
+struct TimShare
+{
+  /* One binding in the chain of the timer */
+  struct Node
+  {
+    void                    (*callback)();
+    Node                    *next;
+  };
+
+  /* Append binding once, init() may run again; the ISR sees the chain before or after the last store */
+  static void add(Node *node)
+  {
+    Node **tail = &head_;
+    while (*tail != nullptr)
+    {
+      if (*tail == node)
+      {
+        return;
+      }
+      tail = &(*tail)->next;
+    }
+    node->next = nullptr;
+    *tail = node;
+  }
+
+  /* Timer callback of all bindings on Tim */
+  static void trampoline(TIM_HandleTypeDef *)
+  {
+    for (Node *node = head_; node != nullptr; node = node->next)
+    {
+      node->callback();
+    }
+  }
+
+  /* Event list of each compare channel, index TIM_CHANNEL_x >> 2 */
+  static ow_tim_list_t *list(uint32_t tim_ch) { return &list_[tim_ch >> 2]; }
+
+private:
+  static inline Node *head_;
+  static inline ow_tim_list_t list_[4];
+};
+#else
+/* Timer callback of a binding, calls callback() of its own bus */
+template <typename Bind>
+void tim_trampoline(TIM_HandleTypeDef *)
+{
+  Bind::callback();
+}
+#endif
+
+/**
+ * @brief Timer driven bus, pins, timer, speed and slot timing fixed at compile time.
+ * @tparam Pins: Pin binding, OpenDrain<> or DualPin<> (OpenDrain<> only if OW_TIM_HW).
+ * @tparam Tim: Timer handle, e.g. htim1.
+ * @tparam TimCh: Timer channel (OW_TIM_HW or OW_TIM_SHARED only).
+ * @tparam Speed: Bus speed selected at init.
+ * @tparam Timing: Slot timing per bus speed (OW_SPEED_MAX entries), nullptr == default timing.
+ *
+ * @details
+ * Pin mode is part of the binding, OW_DUAL_PINS and OW_INVERT_TX/RX only set the init fields
+ * of the C API. Timing is loaded by init() with ow_set_timing(), without OW_TIM_HW the slot
+ * ISR reads it at compile time, so a later ow_set_timing() does not change the slots of the bus.
+ * With OW_TIM_SHARED, bindings of one Tim are called by one trampoline (TimShare<>), bindings
+ * of one TimCh take turns by deadline.
+ *
+ * @code
+ * using Ds18 = ow::Bus<ow::OpenDrain<GPIOC_BASE, GPIO_PIN_8>, htim1>;
+ * using Iso  = ow::Bus<ow::DualPin<GPIOB_BASE, GPIO_PIN_0, GPIOB_BASE, GPIO_PIN_1>, htim2>;
+ * Ds18::init(ds18_done_cb);
+ * Iso::init();
+ * Ds18::xfer(0x44, NULL, 0, 0);
+ * @endcode
+ */
+template <typename Pins, TIM_HandleTypeDef &Tim, uint32_t TimCh = 0, ow_speed_t Speed = OW_SPEED_STD,
+          const ow_tim_t *Timing = nullptr>
+class Bus : public BusBase<Bus<Pins, Tim, TimCh, Speed, Timing>>
+{
+  static_assert((OW_OVERDRIVE == 1) || (Speed == OW_SPEED_STD), "Speed needs OW_OVERDRIVE");
+  static_assert((OW_TIM_HW == 0) || (Pins::dual == false), "OW_TIM_HW needs an OpenDrain pin");
+
+public:
+  /* Timer callback, registered by init() */
+  static void callback()
+  {
+#if (OW_TIM_HW == 0)
+    Isr<Pins, Timing>::ow_isr(BusBase<Bus>::handle());
+#else
+    ow_callback(BusBase<Bus>::handle());
+#endif
+  }
+
+  static void init(void (*done_cb)(ow_err_t) = nullptr)
+  {
+    ow_init_t init = {};
+    init.tim_handle = &Tim;
+#if (OW_TIM_SHARED == 1)
+    TimShare<Tim>::add(&node_);
+    init.tim_cb = &TimShare<Tim>::trampoline;
+    init.tim_list = TimShare<Tim>::list(TimCh);
+#else
+    init.tim_cb = &tim_trampoline<Bus>;
+#endif
+    init.done_cb = done_cb;
+#if (OW_DUAL_PINS == 0)
+    init.gpio = reinterpret_cast<GPIO_TypeDef *>(Pins::tx_base);
+    init.pin = Pins::tx_pin;
+#else
+    init.gpio_tx = reinterpret_cast<GPIO_TypeDef *>(Pins::tx_base);
+    init.pin_tx = Pins::tx_pin;
+    init.gpio_rx = reinterpret_cast<GPIO_TypeDef *>(Pins::rx_base);
+    init.pin_rx = static_cast<uint16_t>(Pins::pin_read);
+#endif
+#if ((OW_TIM_HW == 1) || (OW_TIM_SHARED == 1))
+    init.tim_ch = TimCh;
+#endif
+#if (OW_TIM_HW == 0)
+    /* Pin mode of binding, copied by ow_init() */
+    ow_pins_t pins = Pins::pins();
+    init.pins = &pins;
+#endif
+    BusBase<Bus>::start(init, Speed);
+
+    /* Slot timing of binding also in handle, for ow_start() and poll slots of ow_xfer_poll() */
+    for (uint8_t idx = 0; (Timing != nullptr) && (idx < OW_SPEED_MAX); idx++)
+    {
+      /* Rejected table (0 field or 16-bit overflow) would still drive the slots of the ISR */
+      ow_err_t err = ow_set_timing(BusBase<Bus>::handle(), static_cast<ow_speed_t>(idx), &Timing[idx]);
+      assert_param(err == OW_ERR_NONE);
+      (void)err;
+    }
+  }
+
+#if (OW_TIM_SHARED == 1)
+private:
+  /* Place of this binding in the chain of Tim */
+  static inline typename TimShare<Tim>::Node node_ = { &callback, nullptr };
+#endif
+};
+#else
+/* UART callback of a binding, calls callback() of its own bus */
+template <typename Bind>
+void uart_trampoline(UART_HandleTypeDef *)
+{
+  Bind::callback();
+}
+
+/**
+ * @brief Half-duplex UART bus, UART and speed fixed at compile time.
+ * @tparam Uart: UART handle, e.g. huart2.
+ * @tparam Speed: Bus speed selected at init.
+ */
+template <UART_HandleTypeDef &Uart, ow_speed_t Speed = OW_SPEED_STD>
+class Bus : public BusBase<Bus<Uart, Speed>>
+{
+  static_assert((OW_OVERDRIVE == 1) || (Speed == OW_SPEED_STD), "Speed needs OW_OVERDRIVE");
+
+public:
+  /* UART callback, registered by init() */
+  static void callback() { ow_callback(BusBase<Bus>::handle()); }
+
+  static void init(void (*done_cb)(ow_err_t) = nullptr)
+  {
+    ow_init_t init = {};
+    init.uart_handle = &Uart;
+    init.uart_cb = &uart_trampoline<Bus>;
+    init.done_cb = done_cb;
+    BusBase<Bus>::start(init, Speed);
+  }
+};
+#endif
+
+} // namespace ow
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#endif /* _OW_HPP_ */
@@ -29,15 +29,46 @@
 
 /* USER CODE END OW_INCLUDES */
 
+/*************************************************************************************************/
+/** Backends **/
+/*************************************************************************************************/
+
+#define OW_BACKEND_TIM      0     /* Timer interrupt per slot phase, any GPIO pin */
+#define OW_BACKEND_UART     1     /* Half-duplex UART with DMA, one UART byte per slot */
+
 /*************************************************************************************************/
 /** Configurations **/
 /*************************************************************************************************/
 
 /* USER CODE BEGIN OW_CONFIGURATION */
 
+#define OW_BACKEND          OW_BACKEND_TIM
 #define OW_MAX_DATA_LEN     16
 #define OW_MAX_DEVICE       5
+#define OW_ROM_TABLE        0
 #define OW_DUAL_PINS        0
+#define OW_TIM_HW           0
+#define OW_TIM_SHARED       0
+#define OW_LANES            1
+#define OW_CRC_TABLE        256
+#define OW_QUEUE_LEN        0
+#define OW_RESUME           0
+#define OW_PROG             0
+#define OW_STATS            0
+#define OW_TRACE            0
+#define OW_MARGIN           0
+#define OW_CALIB            0
+#define OW_RETRY            0
+#define OW_SEARCH_RETRY     2
+#if (OW_STATS == 1)
+#define OW_CYCLES()         (DWT->CYCCNT)
+#endif
+#if (OW_TRACE == 1)
+#define OW_TRACE_LEN        128
+#endif
+#if (OW_RESUME == 1)
+#define OW_RESUME_FAMILY    { 0x19, 0x1C, 0x29, 0x2D, 0x37, 0x3A, 0x43 }
+#endif
 #if (OW_DUAL_PINS == 1)
 #define OW_INVERT_RX        0
 #define OW_INVERT_TX        0
@@ -51,6 +82,18 @@
 #define OW_TIM_READ_SAMPLE  10
 #define OW_TIM_READ_HIGH    60
 
+#define OW_TIM_TICK_PER_US  1
+#define OW_OVERDRIVE        0
+#if (OW_OVERDRIVE == 1)
+#define OW_TIM_OD_RST          70
+#define OW_TIM_OD_RST_DET      8
+#define OW_TIM_OD_WRITE_HIGH   8
+#define OW_TIM_OD_WRITE_LOW    1
+#define OW_TIM_OD_READ_LOW     1
+#define OW_TIM_OD_READ_SAMPLE  1
+#define OW_TIM_OD_READ_HIGH    8
+#endif
+
 /* USER CODE END OW_CONFIGURATION */
 
 #if (OW_MAX_DATA_LEN < 8)
@@ -61,6 +104,86 @@
 #error  OW_MAX_DEVICE should be btween 1 and 255!
 #endif
 
+#if ((OW_BACKEND != OW_BACKEND_TIM) && (OW_BACKEND != OW_BACKEND_UART))
+#error  OW_BACKEND should be OW_BACKEND_TIM or OW_BACKEND_UART!
+#endif
+
+#if ((OW_BACKEND == OW_BACKEND_UART) && (OW_DUAL_PINS == 1))
+#error  OW_DUAL_PINS is not supported by OW_BACKEND_UART!
+#endif
+
+#if ((OW_TIM_HW == 1) && ((OW_BACKEND != OW_BACKEND_TIM) || (OW_DUAL_PINS == 1)))
+#error  OW_TIM_HW needs OW_BACKEND_TIM with single pin!
+#endif
+
+#if ((OW_TIM_SHARED == 1) && ((OW_BACKEND != OW_BACKEND_TIM) || (OW_TIM_HW == 1)))
+#error  OW_TIM_SHARED needs OW_BACKEND_TIM without OW_TIM_HW!
+#endif
+
+#if ((OW_LANES < 1) || (OW_LANES > 16))
+#error  OW_LANES should be between 1 and 16!
+#endif
+
+#if ((OW_LANES > 1) && ((OW_BACKEND != OW_BACKEND_TIM) || (OW_TIM_HW == 1) || (OW_DUAL_PINS == 1)))
+#error  OW_LANES needs OW_BACKEND_TIM without OW_TIM_HW and single pin!
+#endif
+
+#if ((OW_ROM_TABLE == 1) && (OW_MAX_DEVICE == 1))
+#error  OW_ROM_TABLE needs OW_MAX_DEVICE > 1!
+#endif
+
+#if ((OW_RESUME == 1) && (OW_MAX_DEVICE == 1))
+#error  OW_RESUME needs OW_MAX_DEVICE > 1!
+#endif
+
+#if ((OW_PROG == 1) && ((OW_BACKEND != OW_BACKEND_TIM) || (OW_TIM_HW == 1) || (OW_LANES > 1)))
+#error  OW_PROG needs OW_BACKEND_TIM without OW_TIM_HW and OW_LANES!
+#endif
+
+#if ((OW_CALIB == 1) && ((OW_BACKEND != OW_BACKEND_TIM) || (OW_TIM_HW == 1) || (OW_TIM_SHARED == 1)))
+#error  OW_CALIB needs OW_BACKEND_TIM without OW_TIM_HW and OW_TIM_SHARED!
+#endif
+
+#if ((OW_RETRY == 1) && (OW_LANES > 1))
+#error  OW_RETRY is not supported with OW_LANES!
+#endif
+
+#if ((OW_SEARCH_RETRY < 0) || (OW_SEARCH_RETRY > 255))
+#error  OW_SEARCH_RETRY should be between 0 and 255!
+#endif
+
+#if ((OW_STATS == 1) && !defined(OW_CYCLES))
+#error  OW_STATS needs OW_CYCLES(), a free running CPU cycle counter!
+#endif
+
+#if ((OW_TRACE == 1) && ((OW_BACKEND != OW_BACKEND_TIM) || (OW_TIM_HW == 1)))
+#error  OW_TRACE needs OW_BACKEND_TIM without OW_TIM_HW!
+#endif
+
+#if ((OW_TRACE == 1) && ((OW_TRACE_LEN < 2) || (OW_TRACE_LEN > 32768) || ((OW_TRACE_LEN & (OW_TRACE_LEN - 1)) != 0)))
+#error  OW_TRACE_LEN should be a power of 2 between 2 and 32768!
+#endif
+
+#if ((OW_MARGIN == 1) && (OW_TIM_HW == 0))
+#error  OW_MARGIN needs OW_TIM_HW!
+#endif
+
+#if ((OW_QUEUE_LEN < 0) || (OW_QUEUE_LEN > 255))
+#error  OW_QUEUE_LEN should be between 0 and 255!
+#endif
+
+#if ((OW_CRC_TABLE != 16) && (OW_CRC_TABLE != 256))
+#error  OW_CRC_TABLE should be 16 or 256!
+#endif
+
+#if ((OW_BACKEND == OW_BACKEND_TIM) && (OW_OVERDRIVE == 1) && (OW_TIM_TICK_PER_US < 2))
+#error  OW_TIM_TICK_PER_US should be at least 2 in overdrive mode!
+#endif
+
+#if ((OW_BACKEND == OW_BACKEND_TIM) && ((OW_TIM_RST * 2 * OW_TIM_TICK_PER_US) > 0xFFFF))
+#error  OW_TIM_RST * 2 in timer ticks should fit a 16-bit timer period!
+#endif
+
 /*************************************************************************************************/
 /** End of File **/
 /*************************************************************************************************/
@@ -0,0 +1,301 @@
+
+/*
+ * @file        ow_ds18b20.c
+ * @brief       DS18B20 bus-wide acquisition on top of OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed. 
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "ow_ds18b20.h"
+
+/*************************************************************************************************/
+/** Private Defines **/
+/*************************************************************************************************/
+
+/* Running step is the broadcast convert, not a scratchpad read */
+#define OW_DS18B20_STEP_CONVERT   0xFF
+
+/*************************************************************************************************/
+/** Private Function prototype **/
+/*************************************************************************************************/
+
+/* Start scratchpad read of next pending device, or finish snapshot */
+static void ow_ds18b20_next(ow_ds18b20_t *ds18);
+
+/* Check family of ROM ID index, returns true for DS18B20 compatible devices */
+static bool ow_ds18b20_family(ow_ds18b20_t *ds18, uint8_t idx);
+
+/* Decode scratchpad of device into temperature */
+static void ow_ds18b20_decode(ow_ds18b20_t *ds18, uint8_t idx);
+
+/*************************************************************************************************/
+/** Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Initialize bus-wide DS18B20 acquisition.
+ * @param[out] ds18: Pointer to the acquisition state.
+ * @param[in]  handle: Pointer to the initialized 1-Wire handle.
+ * @param[in]  parasite: true to hold strong pull-up during conversion instead of polling.
+ * @param[in]  done_cb: Called in ISR when the snapshot is done, can be NULL.
+ */
+void ow_ds18b20_init(ow_ds18b20_t *ds18, ow_t *handle, bool parasite, ow_ds18b20_cb_t done_cb)
+{
+  assert_param(ds18 != NULL);
+  assert_param(handle != NULL);
+
+  ds18->handle = handle;
+  ds18->done_cb = done_cb;
+  ds18->parasite = parasite;
+  ds18->val = NULL;
+  ds18->val_cnt = 0;
+  ds18->busy = false;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Start bus snapshot: Convert T to all devices, wait for conversion, read each scratchpad.
+ * @param[in]  ds18: Pointer to the acquisition state.
+ * @param[out] val: Caller array, entry i is device of ROM ID index i, valid until done.
+ * @param[in]  val_cnt: Number of entries.
+ * @retval Error code of convert start (ow_err_t).
+ *
+ * @details
+ * All steps run back-to-back from the ISR, chained by ow_ds18b20_callback(). Each entry gets
+ * OW_ERR_NONE, OW_ERR_CRC, OW_ERR_ROM_ID (no DS18B20 at this index) or the bus error.
+ */
+ow_err_t ow_ds18b20_sample(ow_ds18b20_t *ds18, ow_ds18b20_val_t *val, uint8_t val_cnt)
+{
+  ow_err_t ow_err;
+  assert_param(ds18 != NULL);
+
+  if (ds18->busy)
+  {
+    return OW_ERR_BUSY;
+  }
+  if ((val == NULL) || (val_cnt == 0) || (val_cnt > OW_MAX_DEVICE))
+  {
+    return OW_ERR_LEN;
+  }
+
+  /* Entries wait as busy, other families are never read */
+  for (uint8_t idx = 0; idx < val_cnt; idx++)
+  {
+    val[idx].temp = 0;
+    val[idx].error = ow_ds18b20_family(ds18, idx) ? OW_ERR_BUSY : OW_ERR_ROM_ID;
+  }
+  ds18->val = val;
+  ds18->val_cnt = val_cnt;
+  ds18->idx = OW_DS18B20_STEP_CONVERT;
+  ds18->busy = true;
+
+  /* Convert of all devices at once, done when the last one releases the bus */
+  if (ds18->parasite)
+  {
+    ow_err = ow_xfer_pullup(ds18->handle, OW_DS18B20_CMD_CONVERT, OW_DS18B20_PULLUP_MS);
+  }
+  else
+  {
+    ow_err = ow_xfer_poll(ds18->handle, OW_DS18B20_CMD_CONVERT, OW_DS18B20_POLL_US, OW_DS18B20_TIMEOUT_MS);
+  }
+
+  /* Bus taken by another transfer, no callback follows */
+  if (ow_err == OW_ERR_BUSY)
+  {
+    ds18->busy = false;
+  }
+
+  return ow_err;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Step acquisition after each transfer, call it in the done callback of the 1-Wire bus.
+ * @param[in]  ds18: Pointer to the acquisition state.
+ * @param[in]  error: Error of the finished transfer.
+ */
+void ow_ds18b20_callback(ow_ds18b20_t *ds18, ow_err_t error)
+{
+  assert_param(ds18 != NULL);
+
+  /* Transfer of someone else */
+  if (!ds18->busy)
+  {
+    return;
+  }
+
+  if (ds18->idx == OW_DS18B20_STEP_CONVERT)
+  {
+    /* No conversion, nothing valid to read */
+    if (error != OW_ERR_NONE)
+    {
+      for (uint8_t idx = 0; idx < ds18->val_cnt; idx++)
+      {
+        if (ds18->val[idx].error == OW_ERR_BUSY)
+        {
+          ds18->val[idx].error = error;
+        }
+      }
+      ds18->idx = ds18->val_cnt;
+    }
+    else
+    {
+      ds18->idx = 0;
+    }
+  }
+  else
+  {
+    /* Scratchpad of running device */
+    if (error == OW_ERR_NONE)
+    {
+      ow_ds18b20_decode(ds18, ds18->idx);
+    }
+    else
+    {
+      ds18->val[ds18->idx].error = error;
+    }
+    ds18->idx++;
+  }
+
+  ow_ds18b20_next(ds18);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Check if bus snapshot is running.
+ * @param[in]  ds18: Pointer to the acquisition state.
+ * @retval true if running, false if done.
+ */
+bool ow_ds18b20_is_busy(ow_ds18b20_t *ds18)
+{
+  assert_param(ds18 != NULL);
+  return ds18->busy;
+}
+
+/*************************************************************************************************/
+/** Private Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Start scratchpad read of next pending device, or finish snapshot.
+ * @param[in]  ds18: Pointer to the acquisition state.
+ */
+static void ow_ds18b20_next(ow_ds18b20_t *ds18)
+{
+  ow_err_t ow_err;
+
+  for (; ds18->idx < ds18->val_cnt; ds18->idx++)
+  {
+    if (ds18->val[ds18->idx].error != OW_ERR_BUSY)
+    {
+      continue;
+    }
+
+    /* Read directly into state, not limited by OW_MAX_DATA_LEN */
+#if (OW_MAX_DEVICE > 1)
+    ow_err = ow_xfer_buf_by_id(ds18->handle, ds18->idx, OW_DS18B20_CMD_READ_SP, NULL, 0, ds18->sp,
+                               OW_DS18B20_SP_LEN);
+#else
+    ow_err = ow_xfer_buf(ds18->handle, OW_DS18B20_CMD_READ_SP, NULL, 0, ds18->sp, OW_DS18B20_SP_LEN);
+#endif
+
+    /* Started, or failed and already stepped by the callback */
+    if (ow_err != OW_ERR_BUSY)
+    {
+      return;
+    }
+  }
+
+  /* All devices done */
+  ds18->busy = false;
+  if (ds18->done_cb != NULL)
+  {
+    ds18->done_cb(ds18);
+  }
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Check family of ROM ID index.
+ * @param[in]  ds18: Pointer to the acquisition state.
+ * @param[in]  idx: ROM ID index.
+ * @retval true for DS18B20, DS18S20, DS1822 and DS1825, or unknown single device.
+ */
+static bool ow_ds18b20_family(ow_ds18b20_t *ds18, uint8_t idx)
+{
+#if (OW_MAX_DEVICE > 1)
+  if (idx >= ow_devices(ds18->handle))
+  {
+    return false;
+  }
+#endif
+
+  switch (ds18->handle->rom_id[idx].rom_id_struct.family)
+  {
+#if (OW_MAX_DEVICE == 1)
+    /* ROM ID not read, Skip ROM reaches the only device */
+    case 0x00:
+#endif
+    case 0x10:
+    case 0x22:
+    case 0x28:
+    case 0x3B:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Check scratchpad CRC and decode temperature, undefined bits of lower resolutions cleared.
+ * @param[in]  ds18: Pointer to the acquisition state.
+ * @param[in]  idx: ROM ID index of the scratchpad.
+ */
+static void ow_ds18b20_decode(ow_ds18b20_t *ds18, uint8_t idx)
+{
+  /* CRC over all bytes including CRC is zero, all zero bytes mean nobody answered */
+  if ((ow_crc(ds18->sp, OW_DS18B20_SP_LEN) != 0) || ((ds18->sp[4] == 0) && (ds18->sp[7] == 0)))
+  {
+    ds18->val[idx].error = OW_ERR_CRC;
+    return;
+  }
+
+  int16_t raw = (int16_t)((uint16_t)ds18->sp[0] | ((uint16_t)ds18->sp[1] << 8));
+  if (ds18->handle->rom_id[idx].rom_id_struct.family == 0x10)
+  {
+    /* DS18S20: 0.5 degree steps */
+    raw = (int16_t)(raw * 8);
+  }
+  else
+  {
+    /* Configuration register R1:R0, 9 bits leaves 3 undefined bits */
+    uint8_t undef = 3 - ((ds18->sp[4] >> 5) & 0x03);
+    raw = (int16_t)(raw & ~((1 << undef) - 1));
+  }
+  ds18->val[idx].temp = raw;
+  ds18->val[idx].error = OW_ERR_NONE;
+}
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
@@ -0,0 +1,108 @@
+
+/*
+ * @file        ow_ds18b20.h
+ * @brief       DS18B20 bus-wide acquisition on top of OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed. 
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+#ifndef _OW_DS18B20_H_
+#define _OW_DS18B20_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "ow.h"
+
+#if (OW_PROG == 0)
+#error  ow_ds18b20 needs OW_PROG for the conversion wait!
+#endif
+
+/*************************************************************************************************/
+/** Defines **/
+/*************************************************************************************************/
+
+/* Function commands */
+#define OW_DS18B20_CMD_CONVERT    0x44
+#define OW_DS18B20_CMD_READ_SP    0xBE
+
+/* Scratchpad length, last byte is CRC8 */
+#define OW_DS18B20_SP_LEN         9
+
+/* Conversion wait: poll period, poll timeout and strong pull-up time of 12-bit resolution */
+#define OW_DS18B20_POLL_US        1000
+#define OW_DS18B20_TIMEOUT_MS     1000
+#define OW_DS18B20_PULLUP_MS      750
+
+/*************************************************************************************************/
+/** Typedef/Struct/Enum **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/* Temperature of one device, index of ROM ID list */
+typedef struct
+{
+  int16_t                   temp;                  /* Temperature in 1/16 degree Celsius */
+  ow_err_t                  error;                 /* OW_ERR_NONE if temp is valid */
+
+} ow_ds18b20_val_t;
+
+/*************************************************************************************************/
+/* Bus-wide acquisition state */
+struct ow_ds18b20_s;
+typedef void (*ow_ds18b20_cb_t)(struct ow_ds18b20_s *ds18);
+
+typedef struct ow_ds18b20_s
+{
+  ow_t                      *handle;               /* 1-Wire bus */
+  ow_ds18b20_cb_t           done_cb;               /* Snapshot done callback, can be NULL */
+  bool                      parasite;              /* Strong pull-up instead of polling conversion */
+  ow_ds18b20_val_t          *val;                  /* Caller array, one entry per ROM ID */
+  uint8_t                   val_cnt;               /* Entries of val */
+  uint8_t                   idx;                   /* Device of running scratchpad read */
+  volatile bool             busy;                  /* Snapshot running */
+  uint8_t                   sp[OW_DS18B20_SP_LEN]; /* Scratchpad of running read */
+
+} ow_ds18b20_t;
+
+/*************************************************************************************************/
+/** API Functions **/
+/*************************************************************************************************/
+
+/* Initialize acquisition on a 1-Wire bus */
+void      ow_ds18b20_init(ow_ds18b20_t *ds18, ow_t *handle, bool parasite, ow_ds18b20_cb_t done_cb);
+
+/* Start bus snapshot: broadcast convert, wait, read all scratchpads */
+ow_err_t  ow_ds18b20_sample(ow_ds18b20_t *ds18, ow_ds18b20_val_t *val, uint8_t val_cnt);
+
+/* Must be called in done callback of the 1-Wire bus */
+void      ow_ds18b20_callback(ow_ds18b20_t *ds18, ow_err_t error);
+
+/* Check if snapshot is running */
+bool      ow_ds18b20_is_busy(ow_ds18b20_t *ds18);
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _OW_DS18B20_H_ */
@@ -0,0 +1,365 @@
+
+/*
+ * @file        ow_ds2431.c
+ * @brief       DS2431 EEPROM streaming read and row write pipeline on top of OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed. 
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include <string.h>
+#include "ow_ds2431.h"
+
+/*************************************************************************************************/
+/** Private Defines **/
+/*************************************************************************************************/
+
+/* Running step */
+#define OW_DS2431_STEP_READ       0
+#define OW_DS2431_STEP_SP         1
+#define OW_DS2431_STEP_COPY       2
+
+/*************************************************************************************************/
+/** Private Function prototype **/
+/*************************************************************************************************/
+
+/* Start write and read back of scratchpad for running row */
+static ow_err_t ow_ds2431_sp(ow_ds2431_t *ds24);
+
+/* Start copy scratchpad of running row */
+static ow_err_t ow_ds2431_copy(ow_ds2431_t *ds24);
+
+/* Add Reset and ROM select steps to program */
+static uint8_t ow_ds2431_select(ow_ds2431_t *ds24, uint8_t cnt);
+
+/* Check scratchpad read back against written row */
+static ow_err_t ow_ds2431_verify(ow_ds2431_t *ds24);
+
+/* Finish read or write */
+static void ow_ds2431_done(ow_ds2431_t *ds24, ow_err_t error);
+
+/*************************************************************************************************/
+/** Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Initialize DS2431 memory access.
+ * @param[out] ds24: Pointer to the memory access state.
+ * @param[in]  handle: Pointer to the initialized 1-Wire handle.
+ * @param[in]  rom_id: ROM ID index of device, ignored if OW_MAX_DEVICE is 1.
+ * @param[in]  done_cb: Called in ISR when read or write is done, can be NULL.
+ */
+void ow_ds2431_init(ow_ds2431_t *ds24, ow_t *handle, uint8_t rom_id, ow_ds2431_cb_t done_cb)
+{
+  assert_param(ds24 != NULL);
+  assert_param(handle != NULL);
+
+  ds24->handle = handle;
+  ds24->rom_id = rom_id;
+  ds24->done_cb = done_cb;
+  ds24->data = NULL;
+  ds24->busy = false;
+  ds24->error = OW_ERR_NONE;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Stream memory into caller buffer with Read Memory, one transaction for any length.
+ * @param[in]  ds24: Pointer to the memory access state.
+ * @param[in]  addr: First memory address.
+ * @param[out] data: Caller buffer, valid until done, not limited by OW_MAX_DATA_LEN.
+ * @param[in]  len: Bytes to read, addr + len up to OW_DS2431_MEM_LEN.
+ * @retval Error code of transfer start (ow_err_t).
+ */
+ow_err_t ow_ds2431_read(ow_ds2431_t *ds24, uint16_t addr, uint8_t *data, uint16_t len)
+{
+  ow_err_t ow_err;
+  assert_param(ds24 != NULL);
+
+  if (ds24->busy)
+  {
+    return OW_ERR_BUSY;
+  }
+  if ((data == NULL) || (len == 0) || (addr + len > OW_DS2431_MEM_LEN))
+  {
+    return OW_ERR_LEN;
+  }
+
+  ds24->ta[0] = (uint8_t)(addr & 0xFF);
+  ds24->ta[1] = (uint8_t)(addr >> 8);
+  ds24->step = OW_DS2431_STEP_READ;
+  ds24->error = OW_ERR_BUSY;
+  ds24->busy = true;
+#if (OW_MAX_DEVICE > 1)
+  ow_err = ow_xfer_buf_by_id(ds24->handle, ds24->rom_id, OW_DS2431_CMD_READ_MEM, ds24->ta, 2, data, len);
+#else
+  ow_err = ow_xfer_buf(ds24->handle, OW_DS2431_CMD_READ_MEM, ds24->ta, 2, data, len);
+#endif
+
+  /* Bus taken by another transfer, no callback follows */
+  if (ow_err == OW_ERR_BUSY)
+  {
+    ds24->busy = false;
+  }
+
+  return ow_err;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Write whole rows of memory.
+ * @param[in]  ds24: Pointer to the memory access state.
+ * @param[in]  addr: First memory address, multiple of OW_DS2431_ROW_LEN.
+ * @param[in]  data: Caller data, valid until done.
+ * @param[in]  len: Bytes to write, multiple of OW_DS2431_ROW_LEN, addr + len up to OW_DS2431_MEM_LEN.
+ * @retval Error code of first row start (ow_err_t).
+ *
+ * @details
+ * Each row is two programs run from the ISR: Write Scratchpad with CRC16 and Read Scratchpad,
+ * then, if address, E/S, data and both CRC16 match, Copy Scratchpad, programming wait and
+ * copy status. Next row starts from ow_ds2431_callback(). Write stops at the first failed row,
+ * ds24->addr is that row: OW_ERR_CRC for a CRC16 mismatch, OW_ERR_BUS for a verify or copy
+ * failure (e.g. a protected row) or the bus error.
+ */
+ow_err_t ow_ds2431_write(ow_ds2431_t *ds24, uint16_t addr, const uint8_t *data, uint16_t len)
+{
+  ow_err_t ow_err;
+  assert_param(ds24 != NULL);
+
+  if (ds24->busy)
+  {
+    return OW_ERR_BUSY;
+  }
+  if ((data == NULL) || (len == 0) || ((addr % OW_DS2431_ROW_LEN) != 0) || ((len % OW_DS2431_ROW_LEN) != 0) ||
+      (addr + len > OW_DS2431_MEM_LEN))
+  {
+    return OW_ERR_LEN;
+  }
+
+  ds24->data = data;
+  ds24->addr = addr;
+  ds24->end = addr + len;
+  ds24->error = OW_ERR_BUSY;
+  ds24->busy = true;
+  ow_err = ow_ds2431_sp(ds24);
+
+  /* Bus taken by another transfer, no callback follows */
+  if (ow_err == OW_ERR_BUSY)
+  {
+    ds24->busy = false;
+  }
+
+  return ow_err;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Step read or write after each transfer, call it in the done callback of the 1-Wire bus.
+ * @param[in]  ds24: Pointer to the memory access state.
+ * @param[in]  error: Error of the finished transfer.
+ */
+void ow_ds2431_callback(ow_ds2431_t *ds24, ow_err_t error)
+{
+  assert_param(ds24 != NULL);
+
+  /* Transfer of someone else */
+  if (!ds24->busy)
+  {
+    return;
+  }
+
+  if ((error != OW_ERR_NONE) || (ds24->step == OW_DS2431_STEP_READ))
+  {
+    ow_ds2431_done(ds24, error);
+    return;
+  }
+
+  if (ds24->step == OW_DS2431_STEP_SP)
+  {
+    /* Copy only a row known to be right in scratchpad */
+    error = ow_ds2431_verify(ds24);
+    if (error != OW_ERR_NONE)
+    {
+      ow_ds2431_done(ds24, error);
+      return;
+    }
+    error = ow_ds2431_copy(ds24);
+  }
+  else if (ds24->status != OW_DS2431_COPY_DONE)
+  {
+    ow_ds2431_done(ds24, OW_ERR_BUS);
+    return;
+  }
+  else
+  {
+    ds24->addr += OW_DS2431_ROW_LEN;
+    ds24->data += OW_DS2431_ROW_LEN;
+    if (ds24->addr == ds24->end)
+    {
+      ow_ds2431_done(ds24, OW_ERR_NONE);
+      return;
+    }
+    error = ow_ds2431_sp(ds24);
+  }
+
+  /* Started, or failed and already stepped by the callback */
+  if (error == OW_ERR_BUSY)
+  {
+    ow_ds2431_done(ds24, error);
+  }
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Check if read or write is running.
+ * @param[in]  ds24: Pointer to the memory access state.
+ * @retval true if running, false if done.
+ */
+bool ow_ds2431_is_busy(ow_ds2431_t *ds24)
+{
+  assert_param(ds24 != NULL);
+  return ds24->busy;
+}
+
+/*************************************************************************************************/
+/** Private Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Start Write Scratchpad and Read Scratchpad of running row.
+ * @param[in]  ds24: Pointer to the memory access state.
+ * @retval Error code of program start (ow_err_t).
+ */
+static ow_err_t ow_ds2431_sp(ow_ds2431_t *ds24)
+{
+  uint8_t cnt = 0;
+
+  ds24->step = OW_DS2431_STEP_SP;
+  ds24->w_sp[0] = OW_DS2431_CMD_WRITE_SP;
+  ds24->w_sp[1] = (uint8_t)(ds24->addr & 0xFF);
+  ds24->w_sp[2] = (uint8_t)(ds24->addr >> 8);
+  memcpy(&ds24->w_sp[3], ds24->data, OW_DS2431_ROW_LEN);
+  ds24->r_cmd = OW_DS2431_CMD_READ_SP;
+
+  cnt = ow_ds2431_select(ds24, cnt);
+  ds24->prog[cnt++] = (ow_op_t){ .op = OW_OP_WRITE, .len = sizeof(ds24->w_sp), .w_data = ds24->w_sp };
+  ds24->prog[cnt++] = (ow_op_t){ .op = OW_OP_READ, .len = sizeof(ds24->w_crc), .r_data = ds24->w_crc };
+  cnt = ow_ds2431_select(ds24, cnt);
+  ds24->prog[cnt++] = (ow_op_t){ .op = OW_OP_WRITE, .len = 1, .w_data = &ds24->r_cmd };
+  ds24->prog[cnt++] = (ow_op_t){ .op = OW_OP_READ, .len = sizeof(ds24->r_sp), .r_data = ds24->r_sp };
+
+  return ow_xfer_prog(ds24->handle, ds24->prog, cnt);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Start Copy Scratchpad of running row, wait for programming and read copy status.
+ * @param[in]  ds24: Pointer to the memory access state.
+ * @retval Error code of program start (ow_err_t).
+ */
+static ow_err_t ow_ds2431_copy(ow_ds2431_t *ds24)
+{
+  uint8_t cnt = 0;
+
+  /* Authorization is address and E/S read back */
+  ds24->step = OW_DS2431_STEP_COPY;
+  ds24->copy[0] = OW_DS2431_CMD_COPY_SP;
+  memcpy(&ds24->copy[1], ds24->r_sp, 3);
+  ds24->status = 0;
+
+  cnt = ow_ds2431_select(ds24, cnt);
+  ds24->prog[cnt++] = (ow_op_t){ .op = OW_OP_WRITE, .len = sizeof(ds24->copy), .w_data = ds24->copy };
+  ds24->prog[cnt++] = (ow_op_t){ .op = OW_OP_WAIT_US, .len = OW_DS2431_PROG_US };
+  ds24->prog[cnt++] = (ow_op_t){ .op = OW_OP_READ, .len = 1, .r_data = &ds24->status };
+
+  return ow_xfer_prog(ds24->handle, ds24->prog, cnt);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Add Reset and ROM select steps to program.
+ * @param[in]  ds24: Pointer to the memory access state.
+ * @param[in]  cnt: Steps in program.
+ * @retval Steps in program after select.
+ */
+static uint8_t ow_ds2431_select(ow_ds2431_t *ds24, uint8_t cnt)
+{
+  ds24->prog[cnt++] = (ow_op_t){ .op = OW_OP_RESET };
+#if (OW_MAX_DEVICE > 1)
+  ds24->prog[cnt++] = (ow_op_t){ .op = OW_OP_MATCH_ROM, .len = ds24->rom_id };
+#else
+  ds24->prog[cnt++] = (ow_op_t){ .op = OW_OP_SKIP_ROM };
+#endif
+  return cnt;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Check both inverted CRC16, address, E/S and data of scratchpad read back.
+ * @param[in]  ds24: Pointer to the memory access state.
+ * @retval OW_ERR_NONE if row can be copied, OW_ERR_CRC or OW_ERR_BUS.
+ */
+static ow_err_t ow_ds2431_verify(ow_ds2431_t *ds24)
+{
+  uint16_t w_crc = (uint16_t)~ow_crc16(ds24->w_sp, sizeof(ds24->w_sp));
+  uint16_t r_crc = ow_crc16_update(0, ds24->r_cmd);
+  for (uint8_t idx = 0; idx < sizeof(ds24->r_sp) - 2; idx++)
+  {
+    r_crc = ow_crc16_update(r_crc, ds24->r_sp[idx]);
+  }
+  r_crc = (uint16_t)~r_crc;
+
+  if ((ds24->w_crc[0] != (uint8_t)(w_crc & 0xFF)) || (ds24->w_crc[1] != (uint8_t)(w_crc >> 8)) ||
+      (ds24->r_sp[11] != (uint8_t)(r_crc & 0xFF)) || (ds24->r_sp[12] != (uint8_t)(r_crc >> 8)))
+  {
+    return OW_ERR_CRC;
+  }
+
+  /* Whole row in scratchpad: E/S ends at offset 7, no partial byte flag */
+  if ((ds24->r_sp[0] != ds24->w_sp[1]) || (ds24->r_sp[1] != ds24->w_sp[2]) ||
+      (ds24->r_sp[2] != (OW_DS2431_ROW_LEN - 1)) ||
+      (memcmp(&ds24->r_sp[3], &ds24->w_sp[3], OW_DS2431_ROW_LEN) != 0))
+  {
+    return OW_ERR_BUS;
+  }
+
+  return OW_ERR_NONE;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Finish read or write and call done callback.
+ * @param[in]  ds24: Pointer to the memory access state.
+ * @param[in]  error: Result of read or write.
+ */
+static void ow_ds2431_done(ow_ds2431_t *ds24, ow_err_t error)
+{
+  ds24->error = error;
+  ds24->busy = false;
+  if (ds24->done_cb != NULL)
+  {
+    ds24->done_cb(ds24);
+  }
+}
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
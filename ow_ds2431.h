@@ -0,0 +1,114 @@
+
+/*
+ * @file        ow_ds2431.h
+ * @brief       DS2431 EEPROM streaming read and row write pipeline on top of OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+
+#ifndef _OW_DS2431_H_
+#define _OW_DS2431_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "ow.h"
+
+#if (OW_PROG == 0)
+#error  ow_ds2431 needs OW_PROG for the row write pipeline!
+#endif
+
+/*************************************************************************************************/
+/** Defines **/
+/*************************************************************************************************/
+
+/* Function commands */
+#define OW_DS2431_CMD_WRITE_SP    0x0F
+#define OW_DS2431_CMD_READ_SP     0xAA
+#define OW_DS2431_CMD_COPY_SP     0x55
+#define OW_DS2431_CMD_READ_MEM    0xF0
+
+/* Memory with registers, scratchpad row length */
+#define OW_DS2431_MEM_LEN         144
+#define OW_DS2431_ROW_LEN         8
+
+/* Copy scratchpad programming time, 0xAA is read after it when copied */
+#define OW_DS2431_PROG_US         10000
+#define OW_DS2431_COPY_DONE       0xAA
+
+/*************************************************************************************************/
+/** Typedef/Struct/Enum **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/* Memory access state */
+struct ow_ds2431_s;
+typedef void (*ow_ds2431_cb_t)(struct ow_ds2431_s *ds24);
+
+typedef struct ow_ds2431_s
+{
+  ow_t                      *handle;               /* 1-Wire bus */
+  uint8_t                   rom_id;                /* ROM ID index of device */
+  ow_ds2431_cb_t            done_cb;               /* Read or write done callback, can be NULL */
+  const uint8_t             *data;                 /* Caller data of write, valid until done */
+  uint16_t                  addr;                  /* Memory address of running row */
+  uint16_t                  end;                   /* Memory address after last row */
+  uint8_t                   step;                  /* Running step */
+  volatile bool             busy;                  /* Read or write running */
+  ow_err_t                  error;                 /* Result, valid when done */
+  uint8_t                   ta[2];                 /* Target address of read */
+  uint8_t                   w_sp[11];              /* Write scratchpad command, address and row */
+  uint8_t                   w_crc[2];              /* Inverted CRC16 of write scratchpad */
+  uint8_t                   r_cmd;                 /* Read scratchpad command */
+  uint8_t                   r_sp[13];              /* Address, E/S, row and inverted CRC16 read back */
+  uint8_t                   copy[4];               /* Copy scratchpad command and authorization */
+  uint8_t                   status;                /* Copy status, OW_DS2431_COPY_DONE when copied */
+  ow_op_t                   prog[8];               /* Program of running step */
+
+} ow_ds2431_t;
+
+/*************************************************************************************************/
+/** API Functions **/
+/*************************************************************************************************/
+
+/* Initialize memory access of device at a ROM ID index */
+void      ow_ds2431_init(ow_ds2431_t *ds24, ow_t *handle, uint8_t rom_id, ow_ds2431_cb_t done_cb);
+
+/* Stream any length of memory into caller buffer, one transaction */
+ow_err_t  ow_ds2431_read(ow_ds2431_t *ds24, uint16_t addr, uint8_t *data, uint16_t len);
+
+/* Write whole rows: write, verify and copy scratchpad of each row from ISR */
+ow_err_t  ow_ds2431_write(ow_ds2431_t *ds24, uint16_t addr, const uint8_t *data, uint16_t len);
+
+/* Must be called in done callback of the 1-Wire bus */
+void      ow_ds2431_callback(ow_ds2431_t *ds24, ow_err_t error);
+
+/* Check if read or write is running */
+bool      ow_ds2431_is_busy(ow_ds2431_t *ds24);
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _OW_DS2431_H_ */
@@ -0,0 +1,306 @@
+
+/*
+ * @file        ow_ds28e17.c
+ * @brief       DS28E17 1-Wire to I2C bridge on top of OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed. 
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "ow_ds28e17.h"
+
+/*************************************************************************************************/
+/** Private Function prototype **/
+/*************************************************************************************************/
+
+/* Build and start program of running frame, or finish all frames */
+static void ow_ds28e17_next(ow_ds28e17_t *e17);
+
+/* Build 1-Wire program of one frame */
+static uint8_t ow_ds28e17_build(ow_ds28e17_t *e17, const ow_ds28e17_frame_t *frame);
+
+/* Decode status bytes of finished frame */
+static void ow_ds28e17_decode(ow_ds28e17_t *e17, ow_ds28e17_frame_t *frame);
+
+/*************************************************************************************************/
+/** Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Initialize DS28E17 bridge.
+ * @param[out] e17: Pointer to the bridge state.
+ * @param[in]  handle: Pointer to the initialized 1-Wire handle.
+ * @param[in]  rom_id: ROM ID index of bridge, ignored if OW_MAX_DEVICE is 1.
+ * @param[in]  done_cb: Called in ISR when all frames are done, can be NULL.
+ */
+void ow_ds28e17_init(ow_ds28e17_t *e17, ow_t *handle, uint8_t rom_id, ow_ds28e17_cb_t done_cb)
+{
+  assert_param(e17 != NULL);
+  assert_param(handle != NULL);
+
+  e17->handle = handle;
+  e17->rom_id = rom_id;
+  e17->done_cb = done_cb;
+  e17->frame = NULL;
+  e17->frame_cnt = 0;
+  e17->idx = 0;
+  e17->busy = false;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Run I2C frames through the bridge.
+ * @param[in]  e17: Pointer to the bridge state.
+ * @param[in,out] frame: Caller frames, results are stored in each frame, valid until done.
+ * @param[in]  frame_cnt: Number of frames.
+ * @retval Error code of first frame start (ow_err_t).
+ *
+ * @details
+ * Each frame is one program: Reset, Match ROM, command with CRC16, busy polling with read slots
+ * and status read. Data is written from and read into caller buffers, not limited by
+ * OW_MAX_DATA_LEN. Next frame starts from the ISR, chained by ow_ds28e17_callback().
+ */
+ow_err_t ow_ds28e17_run(ow_ds28e17_t *e17, ow_ds28e17_frame_t *frame, uint8_t frame_cnt)
+{
+  assert_param(e17 != NULL);
+
+  if (e17->busy)
+  {
+    return OW_ERR_BUSY;
+  }
+  if ((frame == NULL) || (frame_cnt == 0))
+  {
+    return OW_ERR_LEN;
+  }
+
+  for (uint8_t idx = 0; idx < frame_cnt; idx++)
+  {
+    frame[idx].status = 0;
+    frame[idx].w_status = 0;
+    frame[idx].error = OW_ERR_BUSY;
+  }
+  e17->frame = frame;
+  e17->frame_cnt = frame_cnt;
+  e17->idx = 0;
+
+  /* First frame started here, bus busy means no callback follows */
+  uint8_t prog_cnt = ow_ds28e17_build(e17, &frame[0]);
+  if (prog_cnt == 0)
+  {
+    frame[0].error = OW_ERR_LEN;
+    return OW_ERR_LEN;
+  }
+  e17->busy = true;
+  ow_err_t ow_err = ow_xfer_prog(e17->handle, e17->prog, prog_cnt);
+  if (ow_err == OW_ERR_BUSY)
+  {
+    e17->busy = false;
+  }
+
+  return ow_err;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Step frames after each transfer, call it in the done callback of the 1-Wire bus.
+ * @param[in]  e17: Pointer to the bridge state.
+ * @param[in]  error: Error of the finished transfer.
+ */
+void ow_ds28e17_callback(ow_ds28e17_t *e17, ow_err_t error)
+{
+  assert_param(e17 != NULL);
+
+  /* Transfer of someone else */
+  if (!e17->busy)
+  {
+    return;
+  }
+
+  ow_ds28e17_frame_t *frame = &e17->frame[e17->idx];
+  if (error == OW_ERR_NONE)
+  {
+    ow_ds28e17_decode(e17, frame);
+  }
+  else
+  {
+    frame->error = error;
+  }
+  e17->idx++;
+
+  ow_ds28e17_next(e17);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Check if frames are running.
+ * @param[in]  e17: Pointer to the bridge state.
+ * @retval true if running, false if done.
+ */
+bool ow_ds28e17_is_busy(ow_ds28e17_t *e17)
+{
+  assert_param(e17 != NULL);
+  return e17->busy;
+}
+
+/*************************************************************************************************/
+/** Private Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Start program of next frame, or finish all frames.
+ * @param[in]  e17: Pointer to the bridge state.
+ */
+static void ow_ds28e17_next(ow_ds28e17_t *e17)
+{
+  for (; e17->idx < e17->frame_cnt; e17->idx++)
+  {
+    ow_ds28e17_frame_t *frame = &e17->frame[e17->idx];
+    uint8_t prog_cnt = ow_ds28e17_build(e17, frame);
+    if (prog_cnt == 0)
+    {
+      frame->error = OW_ERR_LEN;
+      continue;
+    }
+
+    /* Started, or failed and already stepped by the callback */
+    if (ow_xfer_prog(e17->handle, e17->prog, prog_cnt) != OW_ERR_BUSY)
+    {
+      return;
+    }
+    frame->error = OW_ERR_BUSY;
+  }
+
+  /* All frames done */
+  e17->busy = false;
+  if (e17->done_cb != NULL)
+  {
+    e17->done_cb(e17);
+  }
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Build 1-Wire program of one frame into state.
+ * @param[in]  e17: Pointer to the bridge state.
+ * @param[in]  frame: Pointer to the frame.
+ * @retval Number of program steps, 0 if frame is not valid.
+ */
+static uint8_t ow_ds28e17_build(ow_ds28e17_t *e17, const ow_ds28e17_frame_t *frame)
+{
+  uint8_t cnt = 0;
+  uint8_t tail_len = 2;
+  uint8_t res_len = 2;
+
+  if ((frame->addr > 0x7F) || ((frame->w_len == 0) && (frame->r_len == 0)) ||
+      ((frame->w_len != 0) && (frame->w_data == NULL)) || ((frame->r_len != 0) && (frame->r_data == NULL)))
+  {
+    return 0;
+  }
+
+  /* Command, address with R/W bit, then write length or read length */
+  if (frame->r_len == 0)
+  {
+    e17->hdr[0] = OW_DS28E17_CMD_WRITE;
+    e17->hdr[1] = (uint8_t)(frame->addr << 1);
+    e17->hdr[2] = frame->w_len;
+  }
+  else if (frame->w_len == 0)
+  {
+    e17->hdr[0] = OW_DS28E17_CMD_READ;
+    e17->hdr[1] = (uint8_t)((frame->addr << 1) | 0x01);
+    e17->hdr[2] = frame->r_len;
+    res_len = 1;
+  }
+  else
+  {
+    e17->hdr[0] = OW_DS28E17_CMD_WRITE_READ;
+    e17->hdr[1] = (uint8_t)(frame->addr << 1);
+    e17->hdr[2] = frame->w_len;
+  }
+
+  /* Inverted CRC16 over whole command, LSB first, read length of write-read before it */
+  uint16_t crc = ow_crc16(e17->hdr, 3);
+  for (uint8_t idx = 0; idx < frame->w_len; idx++)
+  {
+    crc = ow_crc16_update(crc, frame->w_data[idx]);
+  }
+  if (e17->hdr[0] == OW_DS28E17_CMD_WRITE_READ)
+  {
+    e17->tail[0] = frame->r_len;
+    crc = ow_crc16_update(crc, frame->r_len);
+    tail_len = 3;
+  }
+  crc = (uint16_t)~crc;
+  e17->tail[tail_len - 2] = (uint8_t)(crc & 0xFF);
+  e17->tail[tail_len - 1] = (uint8_t)(crc >> 8);
+
+  e17->prog[cnt++] = (ow_op_t){ .op = OW_OP_RESET };
+#if (OW_MAX_DEVICE > 1)
+  e17->prog[cnt++] = (ow_op_t){ .op = OW_OP_MATCH_ROM, .len = e17->rom_id };
+#else
+  e17->prog[cnt++] = (ow_op_t){ .op = OW_OP_SKIP_ROM };
+#endif
+  e17->prog[cnt++] = (ow_op_t){ .op = OW_OP_WRITE, .len = 3, .w_data = e17->hdr };
+  if (frame->w_len != 0)
+  {
+    e17->prog[cnt++] = (ow_op_t){ .op = OW_OP_WRITE, .len = frame->w_len, .w_data = frame->w_data };
+  }
+  e17->prog[cnt++] = (ow_op_t){ .op = OW_OP_WRITE, .len = tail_len, .w_data = e17->tail };
+
+  /* Bridge sends 1 while I2C runs, no reset needed before the status */
+  e17->prog[cnt++] = (ow_op_t){ .op = OW_OP_READ_UNTIL_0, .len = OW_DS28E17_POLL_SLOTS };
+  e17->prog[cnt++] = (ow_op_t){ .op = OW_OP_READ, .len = res_len, .r_data = e17->res };
+  if (frame->r_len != 0)
+  {
+    e17->prog[cnt++] = (ow_op_t){ .op = OW_OP_READ, .len = frame->r_len, .r_data = frame->r_data };
+  }
+
+  return cnt;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Decode status bytes of finished frame.
+ * @param[in]  e17: Pointer to the bridge state.
+ * @param[out] frame: Pointer to the frame.
+ */
+static void ow_ds28e17_decode(ow_ds28e17_t *e17, ow_ds28e17_frame_t *frame)
+{
+  frame->status = e17->res[0];
+  frame->w_status = (e17->hdr[0] == OW_DS28E17_CMD_READ) ? 0 : e17->res[1];
+
+  if ((frame->status & OW_DS28E17_STATUS_CRC) != 0)
+  {
+    frame->error = OW_ERR_CRC;
+  }
+  else if ((frame->status != 0) || (frame->w_status != 0))
+  {
+    frame->error = OW_ERR_BUS;
+  }
+  else
+  {
+    frame->error = OW_ERR_NONE;
+  }
+}
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
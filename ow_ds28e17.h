@@ -0,0 +1,118 @@
+
+/*
+ * @file        ow_ds28e17.h
+ * @brief       DS28E17 1-Wire to I2C bridge on top of OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+#ifndef _OW_DS28E17_H_
+#define _OW_DS28E17_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "ow.h"
+
+#if (OW_PROG == 0)
+#error  ow_ds28e17 needs OW_PROG for the busy polling!
+#endif
+
+/*************************************************************************************************/
+/** Defines **/
+/*************************************************************************************************/
+
+/* Function commands, all end with I2C stop */
+#define OW_DS28E17_CMD_WRITE      0x4B
+#define OW_DS28E17_CMD_READ       0x87
+#define OW_DS28E17_CMD_WRITE_READ 0x2D
+
+/* Status byte: CRC16 of frame wrong, I2C address not acknowledged, I2C start failed */
+#define OW_DS28E17_STATUS_CRC     0x01
+#define OW_DS28E17_STATUS_NACK    0x02
+#define OW_DS28E17_STATUS_START   0x08
+
+/* Busy poll slots, about 70 us each at standard speed */
+#define OW_DS28E17_POLL_SLOTS     2000
+
+/*************************************************************************************************/
+/** Typedef/Struct/Enum **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/* One I2C frame: write, read or write then read with repeated start */
+typedef struct
+{
+  uint8_t                   addr;                  /* 7-bit I2C address */
+  const uint8_t             *w_data;               /* Write data, can be NULL if w_len is 0 */
+  uint8_t                   w_len;                 /* Write length */
+  uint8_t                   *r_data;               /* Read buffer, can be NULL if r_len is 0 */
+  uint8_t                   r_len;                 /* Read length */
+  uint8_t                   status;                /* Status byte of bridge, set when done */
+  uint8_t                   w_status;              /* Write status, 0 == all bytes acknowledged */
+  ow_err_t                  error;                 /* OW_ERR_NONE, OW_ERR_CRC, OW_ERR_BUS (NACK) or bus error */
+
+} ow_ds28e17_frame_t;
+
+/*************************************************************************************************/
+/* Bridge state */
+struct ow_ds28e17_s;
+typedef void (*ow_ds28e17_cb_t)(struct ow_ds28e17_s *e17);
+
+typedef struct ow_ds28e17_s
+{
+  ow_t                      *handle;               /* 1-Wire bus */
+  uint8_t                   rom_id;                /* ROM ID index of bridge */
+  ow_ds28e17_cb_t           done_cb;               /* All frames done callback, can be NULL */
+  ow_ds28e17_frame_t        *frame;                /* Caller frames, valid until done */
+  uint8_t                   frame_cnt;             /* Number of frames */
+  uint8_t                   idx;                   /* Running frame */
+  volatile bool             busy;                  /* Frames running */
+  uint8_t                   hdr[3];                /* Command, address and length of running frame */
+  uint8_t                   tail[3];               /* Read length and CRC16 of running frame */
+  uint8_t                   res[2];                /* Status and write status of running frame */
+  ow_op_t                   prog[8];               /* Program of running frame */
+
+} ow_ds28e17_t;
+
+/*************************************************************************************************/
+/** API Functions **/
+/*************************************************************************************************/
+
+/* Initialize bridge at a ROM ID index */
+void      ow_ds28e17_init(ow_ds28e17_t *e17, ow_t *handle, uint8_t rom_id, ow_ds28e17_cb_t done_cb);
+
+/* Run I2C frames back-to-back, one 1-Wire program per frame */
+ow_err_t  ow_ds28e17_run(ow_ds28e17_t *e17, ow_ds28e17_frame_t *frame, uint8_t frame_cnt);
+
+/* Must be called in done callback of the 1-Wire bus */
+void      ow_ds28e17_callback(ow_ds28e17_t *e17, ow_err_t error);
+
+/* Check if frames are running */
+bool      ow_ds28e17_is_busy(ow_ds28e17_t *e17);
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _OW_DS28E17_H_ */
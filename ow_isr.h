@@ -0,0 +1,94 @@
+
+/*
+ * @file        ow_isr.h
+ * @brief       OneWire slot ISR hooks, shared by ow.c and the bindings of ow.hpp
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+#ifndef _OW_ISR_H_
+#define _OW_ISR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include <string.h>
+#include "ow.h"
+
+/*************************************************************************************************/
+/** Defines **/
+/*************************************************************************************************/
+
+/*
+ * ow_isr_impl.h holds the slot ISR. ow.c builds it once for all handles, pin access and
+ * slot timing read from the handle. ow.hpp builds it again per bus binding, with hooks
+ * resolved at compile time:
+ *
+ *   OW_PIN_WRITE(handle, high)    Release (true) or pull low (false) the bus
+ *   OW_PIN_READ(handle)           Bus level, 1 == high
+ *   OW_SLOT(handle, field)        Field of ow_tim_t at current bus speed, in timer ticks
+ */
+
+#if (OW_STATS == 1)
+/* Runtime counters, removed if disabled */
+#define OW_STATS_INC(handle, cnt)       ((handle)->stats.cnt++)
+#define OW_STATS_ADD(handle, cnt, val)  ((handle)->stats.cnt += (val))
+#else
+#define OW_STATS_INC(handle, cnt)
+#define OW_STATS_ADD(handle, cnt, val)
+#endif
+
+#if (OW_CALIB == 1)
+/* Edge offset compensation of bus in ticks, edge offset sample while calibrating */
+#define OW_CALIB_ADJ(handle, adj)       ((handle)->calib.adj)
+#define OW_CALIB_MARK(handle, point)    ow_calib_mark((handle), (point))
+#else
+#define OW_CALIB_ADJ(handle, adj)       0
+#define OW_CALIB_MARK(handle, point)
+#endif
+
+/*************************************************************************************************/
+/** Functions called by slot ISR **/
+/*************************************************************************************************/
+
+/* Stop OneWire communication */
+void      ow_stop(ow_t *handle);
+
+#if (OW_TIM_SHARED == 1)
+/* Move bus to its next deadline in event list of compare channel */
+void      ow_tim_sched(ow_t *handle);
+#endif
+
+#if (OW_MAX_DEVICE > 1)
+/* Write ROM select header of device, return its length */
+uint16_t  ow_select(ow_t *handle, uint8_t rom_id);
+
+/* Merge found ROM ID into ROM ID list */
+void      ow_search_merge(ow_t *handle);
+#endif
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _OW_ISR_H_ */
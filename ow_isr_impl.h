@@ -0,0 +1,1147 @@
+
+/*
+ * @file        ow_isr_impl.h
+ * @brief       OneWire slot ISR, built by ow.c and per bus binding by ow.hpp
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+/*
+ * No include guard: included once by ow.c and once inside each ow::Isr<> of ow.hpp, after
+ * ow_isr.h and with OW_PIN_WRITE(), OW_PIN_READ() and OW_SLOT() defined. Functions are
+ * defined only, their prototypes are in ow.c (members of ow::Isr<> need none).
+ */
+
+/*************************************************************************************************/
+/** Slot ISR **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief Handle 1-Wire timer (or UART) event and call state handlers.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ */
+__STATIC_FORCEINLINE void ow_isr(ow_t *handle)
+{
+#if (OW_BACKEND == OW_BACKEND_UART)
+  /* UART error callback: framing, noise or DMA error */
+  if (handle->config.uart_handle->ErrorCode != HAL_UART_ERROR_NONE)
+  {
+    handle->error = OW_ERR_BUS;
+    ow_stop(handle);
+    return;
+  }
+#elif (OW_TIM_SHARED == 1)
+  /* Compare event of another channel, or of another bus on same channel */
+  if ((handle->config.tim_handle->Channel != handle->config.tim_active) || !handle->tim_linked ||
+      (ow_tim_until(handle, __HAL_TIM_GET_COUNTER(handle->config.tim_handle), handle->tim_due) > 0))
+  {
+    return;
+  }
+#endif
+
+#if (OW_STATS == 1)
+  uint32_t cyc = OW_CYCLES();
+  handle->stats_isr_t0 = cyc;
+  handle->stats_in_isr = true;
+#endif
+#if ((OW_STATS == 1) || (OW_TRACE == 1))
+  /* Timer ticks since the programmed event, 0 for UART */
+  uint16_t lat = 0;
+#if (OW_BACKEND == OW_BACKEND_TIM)
+  lat = ow_tim_lat(handle);
+#endif
+#endif
+#if (OW_TRACE == 1)
+  ow_trace_isr(handle, lat);
+#endif
+
+  switch (handle->state)
+  {
+    /* Ongoing data transfer */
+    case OW_STATE_XFER:       
+      ow_state_xfer(handle);
+      break;
+
+#if (OW_PROG == 1)
+    /* Transaction program, same slots as data transfer */
+    case OW_STATE_PROG:
+      ow_state_xfer(handle);
+      break;
+#endif
+
+#if (OW_MAX_DEVICE > 1)
+    /* ROM search operation */
+    case OW_STATE_SEARCH:     
+      ow_state_search(handle);
+      break;
+#endif
+
+    /* Any invalid state -> stop */
+    default:                  
+      ow_stop(handle);
+      break;
+  }
+
+#if (OW_TIM_SHARED == 1)
+  /* Move to next deadline in event list of compare channel, unless stopped */
+  if (handle->tim_linked)
+  {
+    ow_tim_sched(handle);
+  }
+#endif
+
+#if (OW_STATS == 1)
+  ow_stats_isr(handle, OW_CYCLES() - cyc, lat);
+#endif
+}
+
+#if ((OW_BACKEND == OW_BACKEND_TIM) && (OW_TIM_HW == 0))
+/*************************************************************************************************/
+/**
+ * @brief 1-Wire state machine: handle transfer phases (reset, write, read).
+ * @param[in] handle Pointer to the 1-Wire handle.
+ */
+__STATIC_FORCEINLINE void ow_state_xfer(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  switch (handle->buf.bit_ph)
+  {
+    /************ Reset phase: pull bus low ************/
+    case 0:
+      ow_tim_next(handle, OW_SLOT(handle, rst));
+      OW_PIN_WRITE(handle, false);
+      handle->buf.bit_ph++;
+      break;
+
+    /************ Reset phase: release bus (high) ************/
+    case 1:
+      ow_tim_next(handle, OW_SLOT(handle, rst_det));
+      OW_PIN_WRITE(handle, true);
+      handle->buf.bit_ph++;
+      break;
+
+    /************ Reset phase: check presence pulse ************/
+    case 2:
+#if (OW_LANES > 1)
+      if (!ow_lane_presence(handle))
+#else
+      if (OW_PIN_READ(handle) != 0)
+#endif
+      {
+        handle->error = OW_ERR_RESET;
+        ow_stop(handle);
+      }
+      else
+      {
+        ow_tim_next(handle, OW_SLOT(handle, rst));
+        handle->buf.bit_ph++;
+#if (OW_PROG == 1)
+        if (handle->state == OW_STATE_PROG)
+        {
+          ow_prog_next(handle);
+        }
+#endif
+      }
+      break;
+
+    /************ Writing, phase 1: pull low ************/
+    case 3:
+      ow_tim_next(handle,
+        ((ow_buf_write(handle, handle->buf.byte_idx) & (1 << handle->buf.bit_idx)) ? OW_SLOT(handle, write_low) : OW_SLOT(handle, write_high)) -
+        OW_CALIB_ADJ(handle, write_rel));
+      OW_PIN_WRITE(handle, false);
+      OW_CALIB_MARK(handle, 0);
+      handle->buf.bit_ph++;
+      break;
+
+    /************ Writing, phase 2: release bus ************/
+    case 4:
+      ow_tim_next(handle,
+        ((ow_buf_write(handle, handle->buf.byte_idx) & (1 << handle->buf.bit_idx)) ? OW_SLOT(handle, write_high) : OW_SLOT(handle, write_low)) +
+        OW_CALIB_ADJ(handle, write_rel));
+      OW_PIN_WRITE(handle, true);
+      OW_CALIB_MARK(handle, 1);
+      handle->buf.bit_idx++;
+
+      /* Move to next byte or reading phase */
+      if (handle->buf.bit_idx == 8)
+      {
+        handle->buf.bit_idx = 0;
+        handle->buf.byte_idx++;
+#if (OW_OVERDRIVE == 1)
+        /* Overdrive ROM command sent, continue at overdrive speed */
+        if (handle->buf.byte_idx == handle->buf.od_idx)
+        {
+          handle->speed = OW_SPEED_OD;
+          handle->tim = &handle->tim_table[OW_SPEED_OD];
+        }
+#endif
+        if (handle->buf.byte_idx == handle->buf.write_len)
+        {
+#if (OW_PROG == 1)
+          if (handle->state == OW_STATE_PROG)
+          {
+            ow_prog_next(handle);
+          }
+          else
+#endif
+          if (handle->buf.read_len > 0)
+          {
+            /* Start reading phase */
+            handle->buf.bit_ph = 5;
+            handle->buf.byte_idx = 0;
+          }
+          else
+          {
+            /* Writing complete, no reading: bus released by this edge, no level to wait for */
+            ow_stop(handle);
+          }
+        }
+        else
+        {
+          /* Continue writing next byte */
+          handle->buf.bit_ph = 3;
+        }
+      }
+      else
+      {
+        /* Continue writing next bit */
+        handle->buf.bit_ph = 3;
+      }
+      break;
+
+    /************ Reading, phase 1: pull low ************/
+    case 5:
+      ow_tim_next(handle, OW_SLOT(handle, read_low) - OW_CALIB_ADJ(handle, read_rel));
+      OW_PIN_WRITE(handle, false);
+      OW_CALIB_MARK(handle, 2);
+      handle->buf.bit_ph++;
+      break;
+
+    /************ Reading, phase 2: release bus ************/
+    case 6:
+      ow_tim_next(handle, OW_SLOT(handle, read_sample) - OW_CALIB_ADJ(handle, read_smp));
+      OW_PIN_WRITE(handle, true);
+      OW_CALIB_MARK(handle, 3);
+      handle->buf.bit_ph++;
+      break;
+
+    /************ Reading, phase 3: sample bus ************/
+    case 7:
+      ow_tim_next(handle, OW_SLOT(handle, read_high) + OW_CALIB_ADJ(handle, read_rel) + OW_CALIB_ADJ(handle, read_smp));
+      OW_CALIB_MARK(handle, 4);
+#if (OW_LANES > 1)
+      ow_lane_sample(handle);
+#else
+      if (OW_PIN_READ(handle))
+      {
+        *ow_buf_read(handle, handle->buf.byte_idx) |= (1 << handle->buf.bit_idx);
+      }
+#endif
+
+      /* Update bit/byte counters */
+      handle->buf.bit_ph = 5;
+      handle->buf.bit_idx++;
+      if (handle->buf.bit_idx == 8)
+      {
+        /* Update response CRC as bytes arrive */
+        handle->buf.crc = ow_crc_update(handle->buf.crc, *ow_buf_read(handle, handle->buf.byte_idx));
+        handle->buf.bit_idx = 0;
+        handle->buf.byte_idx++;
+        if (handle->buf.byte_idx == handle->buf.read_len)
+        {
+#if (OW_PROG == 1)
+          if (handle->state == OW_STATE_PROG)
+          {
+            ow_prog_next(handle);
+            break;
+          }
+#endif
+#if (OW_MAX_DEVICE == 1)
+          /* Single device: verify ROM ID if READ_ROM command */
+          if (handle->buf.data[0] == OW_CMD_READ_ROM)
+          {
+            if (handle->buf.crc == 0)
+            {
+              memcpy(handle->rom_id[0].array, &handle->buf.data[1], 8);
+              handle->error = OW_ERR_NONE;
+            }
+            else
+            {
+              handle->error = OW_ERR_ROM_ID;
+            }
+          }
+#endif
+          ow_tim_done(handle);
+        }
+      }
+      break;
+
+#if (OW_PROG == 1)
+    /************ Program wait: bus released or strong pull-up ************/
+    case 8:
+      ow_prog_wait(handle);
+      break;
+
+    /************ Program poll, phase 1: pull low ************/
+    case 9:
+      ow_tim_next(handle, OW_SLOT(handle, read_low));
+      OW_PIN_WRITE(handle, false);
+      handle->buf.bit_ph++;
+      break;
+
+    /************ Program poll, phase 2: release bus ************/
+    case 10:
+      ow_tim_next(handle, OW_SLOT(handle, read_sample));
+      OW_PIN_WRITE(handle, true);
+      handle->buf.bit_ph++;
+      break;
+
+    /************ Program poll, phase 3: sample, done when device sends 1 (or 0) ************/
+    case 11:
+      ow_tim_next(handle, OW_SLOT(handle, read_high));
+      OW_STATS_INC(handle, bits_rx);
+      if ((OW_PIN_READ(handle) != 0) == (handle->prog[handle->prog_idx - 1].op == OW_OP_READ_UNTIL_1))
+      {
+        ow_prog_next(handle);
+      }
+      else if (--handle->prog_poll == 0)
+      {
+        handle->error = OW_ERR_TIMEOUT;
+        ow_tim_done(handle);
+      }
+      else if (handle->prog[handle->prog_idx - 1].interval > 0)
+      {
+        /* Bus released until next poll slot */
+        handle->prog_wait = handle->prog[handle->prog_idx - 1].interval;
+        handle->buf.bit_ph = 8;
+      }
+      else
+      {
+        handle->buf.bit_ph = 9;
+      }
+      break;
+
+    /************ Program strong pull-up: drive bus high, then wait ************/
+    case 12:
+      ow_pullup(handle, true);
+      handle->buf.bit_ph = 8;
+      ow_prog_wait(handle);
+      break;
+
+    /************ Program strong pull-up done: back to open-drain ************/
+    case 13:
+      ow_pullup(handle, false);
+      ow_tim_next(handle, OW_SLOT(handle, write_low));
+      ow_prog_next(handle);
+      break;
+#endif
+
+    default:
+      break;
+  }
+}
+
+#if (OW_PROG == 1)
+/*************************************************************************************************/
+/**
+ * @brief Load next step of transaction program, it runs at next timer event.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ */
+__STATIC_FORCEINLINE void ow_prog_next(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  /* Last step done, its buffer lengths are the response and counted when done */
+  if (handle->prog_idx == handle->prog_cnt)
+  {
+    /* ROM command and write steps end at a write release, listed before OW_OP_READ */
+    ow_op_code_t last_op = handle->prog[handle->prog_idx - 1].op;
+    if ((last_op != OW_OP_RESET) && (last_op < OW_OP_READ))
+    {
+      ow_stop(handle);
+    }
+    else
+    {
+      ow_tim_done(handle);
+    }
+    return;
+  }
+
+#if (OW_STATS == 1)
+  /* Bits of finished step, before its buffer lengths are cleared */
+  if (handle->prog_idx > 0)
+  {
+    ow_op_code_t done_op = handle->prog[handle->prog_idx - 1].op;
+    if (done_op == OW_OP_READ)
+    {
+      handle->stats.bits_rx += handle->buf.read_len * 8UL;
+    }
+    /* ROM command and write steps are listed before OW_OP_READ */
+    else if ((done_op != OW_OP_RESET) && (done_op < OW_OP_READ))
+    {
+      handle->stats.bits_tx += handle->buf.write_len * 8UL;
+    }
+  }
+#endif
+
+  const ow_op_t *op = &handle->prog[handle->prog_idx++];
+  handle->buf.write_len = 0;
+  handle->buf.read_len = 0;
+  handle->buf.bit_idx = 0;
+  handle->buf.byte_idx = 0;
+  handle->buf.w_ptr = NULL;
+  handle->buf.r_ptr = NULL;
+  switch (op->op)
+  {
+    case OW_OP_RESET:
+      handle->buf.bit_ph = 0;
+      break;
+
+    case OW_OP_SKIP_ROM:
+      handle->buf.data[0] = OW_CMD_SKIP_ROM;
+      handle->buf.write_len = 1;
+      handle->buf.bit_ph = 3;
+      break;
+
+#if (OW_MAX_DEVICE > 1)
+    case OW_OP_MATCH_ROM:
+      handle->buf.write_len = ow_select(handle, (uint8_t)op->len);
+      handle->buf.bit_ph = 3;
+      break;
+#endif
+
+    case OW_OP_WRITE:
+      handle->buf.w_ptr = op->w_data;
+      handle->buf.hdr_len = 0;
+      handle->buf.write_len = op->len;
+      handle->buf.bit_ph = 3;
+      break;
+
+    /* Read bits are set in place, CRC covers this step only */
+    case OW_OP_READ:
+      memset(op->r_data, 0, op->len);
+      handle->buf.r_ptr = op->r_data;
+      handle->buf.read_len = op->len;
+      handle->buf.crc = 0;
+      handle->buf.bit_ph = 5;
+      break;
+
+    case OW_OP_WAIT_US:
+      handle->prog_wait = op->len;
+      handle->buf.bit_ph = 8;
+      break;
+
+    case OW_OP_PULLUP_MS:
+      handle->prog_wait = op->len * 1000UL;
+      handle->buf.bit_ph = 12;
+      break;
+
+    case OW_OP_READ_UNTIL_1:
+    case OW_OP_READ_UNTIL_0:
+      handle->prog_poll = op->len;
+      handle->buf.bit_ph = 9;
+      break;
+
+    default:
+      ow_tim_done(handle);
+      break;
+  }
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Schedule next chunk of wait step, at most OW_TIM_SPAN ticks of the 16-bit timer period.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ */
+__STATIC_FORCEINLINE void ow_prog_wait(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  /* One timer event per chunk, e.g. 12 for a 750 ms pull-up at 1 tick per us */
+  const uint32_t chunk_max = OW_TIM_SPAN / OW_TIM_TICK_PER_US;
+  uint32_t chunk = (handle->prog_wait > chunk_max) ? chunk_max : handle->prog_wait;
+  ow_tim_next(handle, (uint16_t)(chunk * OW_TIM_TICK_PER_US));
+  handle->prog_wait -= chunk;
+
+  /* Last chunk scheduled, release strong pull-up, poll again or load next step after it */
+  if (handle->prog_wait == 0)
+  {
+    if (handle->prog[handle->prog_idx - 1].op == OW_OP_PULLUP_MS)
+    {
+      handle->buf.bit_ph = 13;
+    }
+    else if (handle->prog[handle->prog_idx - 1].op >= OW_OP_READ_UNTIL_1)
+    {
+      handle->buf.bit_ph = 9;
+    }
+    else
+    {
+      ow_prog_next(handle);
+    }
+  }
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Switch bus pin to push-pull for strong pull-up, or back to open-drain.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ * @param[in] enable true to drive bus high, false to release it.
+ */
+__STATIC_FORCEINLINE void ow_pullup(ow_t *handle, bool enable)
+{
+  assert_param(handle != NULL);
+
+  /* Output is already high, only the driver type changes */
+  GPIO_InitTypeDef gpio;
+  memset(&gpio, 0, sizeof(GPIO_InitTypeDef));
+  gpio.Pin = handle->config.pin_read;
+  gpio.Mode = enable ? GPIO_MODE_OUTPUT_PP : GPIO_MODE_OUTPUT_OD;
+  gpio.Pull = GPIO_NOPULL;
+  gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+  HAL_GPIO_Init(handle->config.gpio, &gpio);
+}
+#endif
+
+#if (OW_MAX_DEVICE > 1)
+/*************************************************************************************************/
+/**
+ * @brief  1-Wire ROM search state machine.
+ * @param  handle: Pointer to 1-Wire handle.
+ * @retval None
+ *
+ * @details
+ * Implements non-blocking search, handles reset, read/write bits,
+ * resolves discrepancies, stores found ROMs, and sets state done.
+ */
+__STATIC_FORCEINLINE void ow_state_search(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  switch (handle->buf.bit_ph)
+  {
+  /************ Reset phase: pull bus low ************/
+  case 0:
+    ow_tim_next(handle, OW_SLOT(handle, rst));
+    OW_PIN_WRITE(handle, false);
+    handle->buf.bit_ph++;
+    break;
+
+    /************ Reset phase: release bus (high) ************/
+  case 1:
+    ow_tim_next(handle, OW_SLOT(handle, rst_det));
+    OW_PIN_WRITE(handle, true);
+    handle->buf.bit_ph++;
+    break;
+
+  /************ Reset phase: check presence pulse ************/
+  case 2:
+    if (OW_PIN_READ(handle) != 0)
+    {
+      handle->error = OW_ERR_RESET;
+      ow_stop(handle);
+    }
+    else
+    {
+      ow_tim_next(handle, OW_SLOT(handle, rst));
+      handle->buf.bit_ph++;
+    }
+    break;
+
+  /************ Writing, phase 1: pull low ************/
+  case 3:
+    if (handle->buf.data[0] & (1 << handle->buf.bit_idx))
+    {
+      ow_tim_next(handle, OW_SLOT(handle, write_low) - OW_CALIB_ADJ(handle, write_rel));
+    }
+    else
+    {
+      ow_tim_next(handle, OW_SLOT(handle, write_high) - OW_CALIB_ADJ(handle, write_rel));
+    }
+    OW_PIN_WRITE(handle, false);
+    handle->buf.bit_ph++;
+    break;
+
+  /************ Writing, phase 2: release bus ************/
+  case 4:
+    if (handle->buf.data[0] & (1 << handle->buf.bit_idx))
+    {
+      ow_tim_next(handle, OW_SLOT(handle, write_high) + OW_CALIB_ADJ(handle, write_rel));
+    }
+    else
+    {
+      ow_tim_next(handle, OW_SLOT(handle, write_low) + OW_CALIB_ADJ(handle, write_rel));
+    }
+    OW_PIN_WRITE(handle, true);
+    handle->buf.bit_idx++;
+
+    /* command complete */
+    if (handle->buf.bit_idx == 8)
+    {
+      handle->buf.bit_idx = 0;
+      /* Start reading phase */
+      handle->buf.bit_ph = 5;
+    }
+    else
+    {
+      /* Writing next command bit */
+      handle->buf.bit_ph = 3;
+    }
+    break;
+
+  /************ Reading, phase 1: pull low ************/
+  case 5:
+    ow_tim_next(handle, OW_SLOT(handle, read_low) - OW_CALIB_ADJ(handle, read_rel));
+    OW_PIN_WRITE(handle, false);
+    handle->buf.bit_ph++;
+    break;
+
+  /************ reading bit, phase 2 ************/
+  case 6:
+    ow_tim_next(handle, OW_SLOT(handle, read_sample) - OW_CALIB_ADJ(handle, read_smp));
+    OW_PIN_WRITE(handle, true);
+    handle->buf.bit_ph++;
+    break;
+
+  /************ reading bit, phase 3 ************/
+  case 7:
+    ow_tim_next(handle, OW_SLOT(handle, read_high) + OW_CALIB_ADJ(handle, read_rel) + OW_CALIB_ADJ(handle, read_smp));
+    if (OW_PIN_READ(handle))
+    {
+      handle->search.val = OW_VAL_1;
+    }
+    else
+    {
+      handle->search.val = OW_VAL_DIFF;
+    }
+    handle->buf.bit_ph++;
+    break;
+
+  /************ reading complement bit, phase 1 ************/
+  case 8:
+    ow_tim_next(handle, OW_SLOT(handle, read_low) - OW_CALIB_ADJ(handle, read_rel));
+    OW_PIN_WRITE(handle, false);
+    handle->buf.bit_ph++;
+    break;
+
+  /************ Reading, phase 2: release bus ************/
+  case 9:
+    ow_tim_next(handle, OW_SLOT(handle, read_sample) - OW_CALIB_ADJ(handle, read_smp));
+    OW_PIN_WRITE(handle, true);
+    handle->buf.bit_ph++;
+    break;
+
+  /************ Reading, phase 3: sample bus ************/
+  case 10:
+    ow_tim_next(handle, OW_SLOT(handle, read_high) + OW_CALIB_ADJ(handle, read_rel) + OW_CALIB_ADJ(handle, read_smp));
+    if (OW_PIN_READ(handle))
+    {
+      handle->search.val = (ow_val_t)(handle->search.val | OW_VAL_0);
+    }
+    handle->buf.bit_ph++;
+
+    /* resolve discrepancy, devices lost inside ROM ID start the pass again */
+    if ((ow_search_resolve(handle) == false) &&
+        ((handle->buf.bit_idx == 0) || (ow_search_retry(handle) == false)))
+    {
+      handle->error = OW_ERR_ROM_ID;
+      ow_stop(handle);
+    }
+    break;
+
+  /************ Writing selected bit, phase 1: pull low ************/
+  case 11:
+    if (handle->search.val == OW_VAL_1)
+    {
+      ow_tim_next(handle, OW_SLOT(handle, write_low) - OW_CALIB_ADJ(handle, write_rel));
+    }
+    else
+    {
+      ow_tim_next(handle, OW_SLOT(handle, write_high) - OW_CALIB_ADJ(handle, write_rel));
+    }
+    OW_PIN_WRITE(handle, false);
+    handle->buf.bit_ph++;
+    break;
+
+  /************ Writing selected bit, phase 2: release bus ************/
+  case 12:
+    if (handle->search.val == OW_VAL_1)
+    {
+      ow_tim_next(handle, OW_SLOT(handle, write_high) + OW_CALIB_ADJ(handle, write_rel));
+    }
+    else
+    {
+      ow_tim_next(handle, OW_SLOT(handle, write_low) + OW_CALIB_ADJ(handle, write_rel));
+    }
+    OW_PIN_WRITE(handle, true);
+
+    /* Store selected bit, start next bit or next search */
+    if (ow_search_advance(handle) == false)
+    {
+      handle->buf.bit_ph = 5;
+    }
+    else if (handle->state == OW_STATE_DONE)
+    {
+      /* Search ends at a write release */
+      ow_stop(handle);
+    }
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+/*************************************************************************************************/
+/**
+ * @brief Schedule next timer event relative to current one.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ * @param[in] ticks Time to next event in timer ticks.
+ */
+__STATIC_FORCEINLINE void ow_tim_next(ow_t *handle, uint16_t ticks)
+{
+  assert_param(handle != NULL);
+
+#if (OW_TIM_SHARED == 1)
+  /* Advance own deadline, timer keeps counting for other buses, ow_tim_sched() programs channel */
+  uint32_t due = handle->tim_due + ticks;
+  uint32_t arr = __HAL_TIM_GET_AUTORELOAD(handle->config.tim_handle);
+  if (due > arr)
+  {
+    due -= arr + 1;
+  }
+  handle->tim_due = due;
+#else
+  /* Counter restarts at each update event */
+  __HAL_TIM_SET_AUTORELOAD(handle->config.tim_handle, ticks - 1);
+#endif
+#if (OW_TRACE == 1)
+  handle->trace_time += ticks;
+#endif
+}
+
+#if (OW_TIM_SHARED == 1)
+/*************************************************************************************************/
+/**
+ * @brief Get timer ticks from a counter value to a deadline of the free running timer.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ * @param[in] cnt Counter value, usually now.
+ * @param[in] due Counter value of deadline.
+ * @retval Timer ticks, negative if the deadline is up to half a timer period behind cnt.
+ */
+__STATIC_FORCEINLINE int32_t ow_tim_until(ow_t *handle, uint32_t cnt, uint32_t due)
+{
+  uint32_t arr = __HAL_TIM_GET_AUTORELOAD(handle->config.tim_handle);
+  uint32_t ticks = (due >= cnt) ? (due - cnt) : (due + (arr - cnt) + 1);
+  return (ticks > (arr >> 1)) ? (int32_t)(ticks - arr - 1) : (int32_t)ticks;
+}
+#endif
+
+/*************************************************************************************************/
+/**
+ * @brief Finish transfer at its last read sample, without waiting for one more timer event.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ *
+ * @details
+ * Recovery before the next transfer is covered by the idle time before its reset pulse.
+ * If a device still holds a read 0, the transfer stops at the already scheduled end of the
+ * slot, so a transfer chained from done_cb finds the bus idle. A transfer ending at a write
+ * release calls ow_stop() directly, the pin read in the same ISR is still low.
+ */
+__STATIC_FORCEINLINE void ow_tim_done(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  if (OW_PIN_READ(handle))
+  {
+    ow_stop(handle);
+  }
+  else
+  {
+    /* Stopped on next timer event */
+    handle->state = OW_STATE_DONE;
+  }
+}
+
+#if (OW_CALIB == 1)
+/*************************************************************************************************/
+/**
+ * @brief Sample timer count after pin access while calibrating.
+ * @param[in] handle Pointer to the 1-Wire handle.
+ * @param[in] point Write pull-low, write release, read pull-low, read release or read sample (0..4).
+ */
+__STATIC_FORCEINLINE void ow_calib_mark(ow_t *handle, uint8_t point)
+{
+  if (handle->calib_run)
+  {
+    /* Counter restarts at each event, so it is the offset of this pin access */
+    uint16_t cnt = (uint16_t)__HAL_TIM_GET_COUNTER(handle->config.tim_handle);
+    handle->calib_sum[point] += cnt;
+    handle->calib_cnt[point]++;
+    if (cnt > handle->calib.lat_max)
+    {
+      handle->calib.lat_max = cnt;
+    }
+  }
+}
+#endif
+#endif
+
+/*************************************************************************************************/
+/**
+ * @brief Get write byte of transfer, header in handle, data in caller buffer if set.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @param[in] byte_idx: Byte index from the first written byte.
+ * @retval Byte to write.
+ */
+__STATIC_FORCEINLINE uint8_t ow_buf_write(ow_t *handle, uint16_t byte_idx)
+{
+  if ((handle->buf.w_ptr != NULL) && (byte_idx >= handle->buf.hdr_len))
+  {
+    return handle->buf.w_ptr[byte_idx - handle->buf.hdr_len];
+  }
+  return handle->buf.data[byte_idx];
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Get read byte of transfer, in caller buffer if set, else after written bytes in handle.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @param[in] byte_idx: Byte index from the first read byte.
+ * @retval Pointer to read byte.
+ */
+__STATIC_FORCEINLINE uint8_t *ow_buf_read(ow_t *handle, uint16_t byte_idx)
+{
+  if (handle->buf.r_ptr != NULL)
+  {
+    return &handle->buf.r_ptr[byte_idx];
+  }
+  return &handle->buf.data[handle->buf.write_len + byte_idx];
+}
+
+#if (OW_MAX_DEVICE > 1)
+/*************************************************************************************************/
+/**
+ * @brief  Resolve search direction of current ROM bit from bit and complement (search.val).
+ * @param  handle: Pointer to 1-Wire handle.
+ * @retval false if no device answered, true otherwise.
+ */
+__STATIC_FORCEINLINE bool ow_search_resolve(ow_t *handle)
+{
+  /* Dallas counts bits 1..64 */
+  uint8_t bit_number = handle->buf.bit_idx + 1;
+  if (handle->search.val == OW_VAL_DIFF)
+  {
+    uint8_t bit_choice = 0;
+    if (bit_number < handle->search.last_discrepancy)
+    {
+      /* repeat previous path, a 0 is still an open branch */
+      bit_choice = (handle->search.rom_id[handle->buf.bit_idx / 8] >> (handle->buf.bit_idx % 8)) & 0x01;
+      if (bit_choice == 0)
+      {
+        handle->search.last_zero = bit_number;
+      }
+    }
+    else if (bit_number == handle->search.last_discrepancy)
+    {
+      /* this time choose 1 */
+      bit_choice = 1;
+    }
+    else
+    {
+      /* choose 0 and remember as last zero */
+      bit_choice = 0;
+      handle->search.last_zero = bit_number;
+    }
+    handle->search.val = bit_choice ? OW_VAL_1 : OW_VAL_0;
+  }
+  else if (handle->search.val == OW_VAL_ERR)
+  {
+    return false;
+  }
+  return true;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Store selected ROM bit, finish the ROM ID after the last bit.
+ * @param  handle: Pointer to 1-Wire handle.
+ * @retval true if the ROM ID is complete (next search pass or OW_STATE_DONE), false otherwise.
+ */
+__STATIC_FORCEINLINE bool ow_search_advance(ow_t *handle)
+{
+  /* Search command at first bit, then bit, complement and selected bit */
+  OW_STATS_ADD(handle, bits_tx, (handle->buf.bit_idx == 0) ? 9 : 1);
+  OW_STATS_ADD(handle, bits_rx, 2);
+
+  /* Verify: no device follows ROM ID at this bit */
+  if ((handle->search.mode == OW_SEARCH_VERIFY) &&
+      (((handle->rom_id[handle->search.target].array[handle->buf.bit_idx / 8] >> (handle->buf.bit_idx % 8)) & 0x01) !=
+       ((handle->search.val == OW_VAL_1) ? 1 : 0)))
+  {
+    handle->error = OW_ERR_ROM_ID;
+    handle->buf.bit_idx = 0;
+    handle->buf.bit_ph = 0;
+    handle->state = OW_STATE_DONE;
+    return true;
+  }
+
+  /* Path is kept for next pass, so each bit is set or cleared */
+  if (handle->search.val == OW_VAL_1)
+  {
+    handle->search.rom_id[handle->buf.bit_idx / 8] |= (1 << (handle->buf.bit_idx % 8));
+  }
+  else
+  {
+    handle->search.rom_id[handle->buf.bit_idx / 8] &= ~(1 << (handle->buf.bit_idx % 8));
+  }
+  handle->buf.bit_idx++;
+
+  /* Update ROM ID CRC as bytes complete */
+  if ((handle->buf.bit_idx & 0x07) == 0)
+  {
+    handle->search.crc = ow_crc_update(handle->search.crc, handle->search.rom_id[(handle->buf.bit_idx / 8) - 1]);
+  }
+
+  /* Target family not on bus, rest of ROM ID is not walked */
+  if ((handle->buf.bit_idx == 8) && (handle->search.family != 0) &&
+      (handle->search.rom_id[0] != handle->search.family))
+  {
+    handle->buf.bit_idx = 0;
+    handle->buf.bit_ph = 0;
+    handle->state = OW_STATE_DONE;
+    return true;
+  }
+  if (handle->buf.bit_idx != 64)
+  {
+    return false;
+  }
+
+  /* full ROM read */
+  handle->buf.bit_idx = 0;
+  handle->buf.bit_ph = 0;
+  OW_STATS_INC(handle, search_pass);
+  if (handle->search.crc != 0)
+  {
+    OW_STATS_INC(handle, search_crc_err);
+    if (ow_search_retry(handle))
+    {
+      return true;
+    }
+  }
+  else
+  {
+    if (handle->search.mode == OW_SEARCH_MERGE)
+    {
+      ow_search_merge(handle);
+    }
+    else if ((handle->search.mode == OW_SEARCH_LIST) &&
+             ((handle->rom_id_found == 0) ||
+              (memcmp(handle->rom_id[handle->rom_id_found - 1].array, handle->search.rom_id, 8) != 0)))
+    {
+      /* Noise read as discrepancy sends next pass along same path, found ROM ID is kept once */
+      memcpy(&handle->rom_id[handle->rom_id_found], handle->search.rom_id, 8);
+      handle->rom_id_found++;
+    }
+  }
+  handle->search.crc = 0;
+
+  /* update discrepancy, next branch inside family code is another family */
+  handle->search.last_discrepancy = handle->search.last_zero;
+  handle->search.last_zero = 0;
+  if ((handle->search.last_discrepancy == 0) || (handle->search.mode == OW_SEARCH_VERIFY) ||
+      ((handle->search.mode == OW_SEARCH_LIST) && (handle->rom_id_found == handle->rom_id_max)) ||
+      ((handle->search.family != 0) && (handle->search.last_discrepancy <= 8)))
+  {
+    handle->search.last_device_flag = 1;
+    handle->state = OW_STATE_DONE;
+  }
+#if (OW_SEARCH_RETRY > 0)
+  memcpy(handle->search.path, handle->search.rom_id, 8);
+  handle->search.retry = OW_SEARCH_RETRY;
+#endif
+  return true;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Walk running search pass again from reset, after a ROM ID CRC error or lost devices.
+ * @param  handle: Pointer to 1-Wire handle.
+ * @retval true if the pass is walked again, false if no repeat is left.
+ *
+ * @details
+ * Devices that lost a bit wait for the next reset, so a pass cannot continue from the failed
+ * bit. Path and last discrepancy of the pass are restored instead, a noise hit costs one pass
+ * and neither aborts the search nor drops the branches behind the failed ROM ID.
+ */
+__STATIC_FORCEINLINE bool ow_search_retry(ow_t *handle)
+{
+#if (OW_SEARCH_RETRY > 0)
+  if (handle->search.retry == 0)
+  {
+    return false;
+  }
+  handle->search.retry--;
+  OW_STATS_INC(handle, search_retry);
+
+  memcpy(handle->search.rom_id, handle->search.path, 8);
+  handle->search.crc = 0;
+  handle->search.last_zero = 0;
+  handle->buf.bit_idx = 0;
+  handle->buf.bit_ph = 0;
+  return true;
+#else
+  (void)handle;
+  return false;
+#endif
+}
+#endif
+
+#if (OW_BACKEND == OW_BACKEND_TIM)
+#if ((OW_STATS == 1) || (OW_TRACE == 1))
+/*************************************************************************************************/
+/**
+ * @brief Get timer ticks from programmed event to now.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @retval Timer ticks, the counter restarts at each event unless OW_TIM_SHARED.
+ */
+__STATIC_FORCEINLINE uint16_t ow_tim_lat(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+#if (OW_TIM_SHARED == 1)
+  return (uint16_t)-ow_tim_until(handle, __HAL_TIM_GET_COUNTER(handle->config.tim_handle), handle->tim_due);
+#else
+  return (uint16_t)__HAL_TIM_GET_COUNTER(handle->config.tim_handle);
+#endif
+}
+#endif
+
+#if (OW_LANES > 1)
+/*************************************************************************************************/
+/**
+ * @brief Check presence pulse of each lane, lanes without it are marked absent.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @retval true if at least one lane answered
+ */
+__STATIC_FORCEINLINE bool ow_lane_presence(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  handle->lane_absent = (uint16_t)(handle->config.gpio->IDR & handle->config.pin_read);
+  return (handle->lane_absent != handle->config.pin_read);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief Sample all lanes with one port read, store read bit of each lane.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ */
+__STATIC_FORCEINLINE void ow_lane_sample(ow_t *handle)
+{
+  assert_param(handle != NULL);
+
+  uint32_t idr = handle->config.gpio->IDR;
+  uint8_t mask = (uint8_t)(1 << handle->buf.bit_idx);
+
+  /* Lane 0 response stays in transfer buffer */
+  if (idr & handle->lane_pin[0])
+  {
+    *ow_buf_read(handle, handle->buf.byte_idx) |= mask;
+  }
+  for (uint8_t lane = 1; lane < handle->lane_cnt; lane++)
+  {
+    if (idr & handle->lane_pin[lane])
+    {
+      handle->lane_data[lane - 1][handle->buf.byte_idx] |= mask;
+    }
+  }
+}
+#endif
+#endif
+
+#if (OW_STATS == 1)
+/*************************************************************************************************/
+/**
+ * @brief Update ISR cost counters of one ow_callback() call.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @param[in] cyc: CPU cycles spent in ow_callback().
+ * @param[in] lat: Timer ticks from programmed event to ISR entry.
+ */
+__STATIC_FORCEINLINE void ow_stats_isr(ow_t *handle, uint32_t cyc, uint16_t lat)
+{
+  ow_stats_t *stats = &handle->stats;
+
+  if ((stats->isr_cnt == 0) || (cyc < stats->isr_cyc_min))
+  {
+    stats->isr_cyc_min = cyc;
+  }
+  if (cyc > stats->isr_cyc_max)
+  {
+    stats->isr_cyc_max = cyc;
+  }
+  if ((stats->isr_cnt == 0) || (lat < stats->isr_lat_min))
+  {
+    stats->isr_lat_min = lat;
+  }
+  if (lat > stats->isr_lat_max)
+  {
+    stats->isr_lat_max = lat;
+  }
+  stats->isr_cyc_sum += cyc;
+  stats->isr_cnt++;
+
+  /* Not finished by ow_done() in this call */
+  if (handle->stats_in_isr)
+  {
+    handle->stats_in_isr = false;
+    handle->stats_cyc += cyc;
+    handle->stats_isr++;
+  }
+}
+#endif
+
+#if (OW_TRACE == 1)
+/*************************************************************************************************/
+/**
+ * @brief Record one timer event in trace ring, before the state handler drives the bus.
+ * @param[in] handle: Pointer to 1-Wire handle.
+ * @param[in] lat: Timer ticks from programmed event to ISR entry.
+ */
+__STATIC_FORCEINLINE void ow_trace_isr(ow_t *handle, uint16_t lat)
+{
+  if (!handle->trace_hold)
+  {
+    ow_trace_t *trace = &handle->trace[handle->trace_head];
+    trace->time = (uint16_t)handle->trace_time;
+    trace->lat = lat;
+    trace->state = (uint8_t)handle->state;
+    trace->phase = handle->buf.bit_ph;
+    trace->bit_idx = handle->buf.bit_idx;
+    trace->level = OW_PIN_READ(handle);
+    handle->trace_head = (handle->trace_head + 1) & (OW_TRACE_LEN - 1);
+    if (handle->trace_cnt < OW_TRACE_LEN)
+    {
+      handle->trace_cnt++;
+    }
+  }
+}
+#endif
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
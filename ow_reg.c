@@ -0,0 +1,283 @@
+
+/*
+ * @file        ow_reg.c
+ * @brief       ROM ID indexed device registry on top of OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include <string.h>
+#include "ow_reg.h"
+
+/*************************************************************************************************/
+/** Private Function prototype **/
+/*************************************************************************************************/
+
+/* First hash slot of a ROM ID */
+static uint16_t ow_reg_hash(const ow_id_t *id);
+
+/* Bucket of a family, or OW_REG_NONE */
+static uint8_t ow_reg_family(ow_reg_t *reg, uint8_t family);
+
+/*************************************************************************************************/
+/** Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Initialize registry of a bus with caller metadata table.
+ * @param[out] reg: Pointer to the registry.
+ * @param[in]  handle: Pointer to the 1-Wire bus.
+ * @param[out] dev: Metadata table, one entry per ROM ID list entry of the bus.
+ * @param[in]  dev_max: Entries of metadata table.
+ */
+void ow_reg_init(ow_reg_t *reg, ow_t *handle, ow_reg_dev_t *dev, uint8_t dev_max)
+{
+  assert_param(reg != NULL);
+  assert_param(handle != NULL);
+  assert_param(dev != NULL);
+  assert_param(dev_max >= handle->rom_id_max);
+
+  memset(reg, 0, sizeof(ow_reg_t));
+  reg->handle = handle;
+  reg->dev = dev;
+  reg->dev_max = dev_max;
+  memset(dev, 0, dev_max * sizeof(ow_reg_dev_t));
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Rebuild ROM ID hash and family buckets from ROM ID list of the bus.
+ * @param[in]  reg: Pointer to the registry.
+ * @param[in]  clear: true to clear metadata, e.g. after ow_update_rom_id() reordered the list.
+ * @retval OW_ERR_NONE, OW_ERR_LEN if a family did not fit in OW_REG_MAX_FAMILY buckets.
+ *
+ * @details
+ * Call it when a search is done, not while the bus searches. ow_rescan() keeps indices, so
+ * metadata stays valid and only arrived or departed entries need ow_reg_change().
+ */
+ow_err_t ow_reg_sync(ow_reg_t *reg, bool clear)
+{
+  assert_param(reg != NULL);
+
+  ow_err_t ow_err = OW_ERR_NONE;
+  ow_t *handle = reg->handle;
+
+  memset(reg->hash, 0, sizeof(reg->hash));
+  reg->fam_cnt = 0;
+  if (clear)
+  {
+    memset(reg->dev, 0, reg->dev_max * sizeof(ow_reg_dev_t));
+  }
+
+  /* Backwards, so each bucket lists its devices by rising index */
+  for (uint8_t idx = ow_devices(handle); idx-- > 0;)
+  {
+    const ow_id_t *id = &handle->rom_id[idx];
+    reg->dev[idx].next = OW_REG_NONE;
+    if (id->rom_id_struct.family == 0)
+    {
+      continue;
+    }
+
+    /* Linear probing, table is never full */
+    uint16_t slot = ow_reg_hash(id);
+    while (reg->hash[slot] != 0)
+    {
+      slot = (slot + 1) & (OW_REG_HASH_LEN - 1);
+    }
+    reg->hash[slot] = idx + 1;
+
+    uint8_t fam = ow_reg_family(reg, id->rom_id_struct.family);
+    if (fam == OW_REG_NONE)
+    {
+      if (reg->fam_cnt == OW_REG_MAX_FAMILY)
+      {
+        ow_err = OW_ERR_LEN;
+        continue;
+      }
+      fam = reg->fam_cnt++;
+      reg->fam_code[fam] = id->rom_id_struct.family;
+      reg->fam_head[fam] = OW_REG_NONE;
+    }
+    reg->dev[idx].next = reg->fam_head[fam];
+    reg->fam_head[fam] = idx;
+  }
+
+  return ow_err;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Clear metadata of an arrived or departed device.
+ * @param[in]  reg: Pointer to the registry.
+ * @param[in]  rom_id: ROM ID index of the device.
+ *
+ * @details
+ * Call it in the ow_rescan() callback, then ow_reg_sync() when the rescan is done.
+ */
+void ow_reg_change(ow_reg_t *reg, uint8_t rom_id)
+{
+  assert_param(reg != NULL);
+  assert_param(rom_id < reg->dev_max);
+
+  uint8_t next = reg->dev[rom_id].next;
+  memset(&reg->dev[rom_id], 0, sizeof(ow_reg_dev_t));
+  reg->dev[rom_id].next = next;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Find ROM ID index of a known ROM ID, e.g. one stored in configuration.
+ * @param[in]  reg: Pointer to the registry.
+ * @param[in]  id: Pointer to the ROM ID.
+ * @retval ROM ID index, OW_REG_NONE if the device is not in the list.
+ */
+uint8_t ow_reg_find(ow_reg_t *reg, const ow_id_t *id)
+{
+  assert_param(reg != NULL);
+  assert_param(id != NULL);
+
+  uint16_t slot = ow_reg_hash(id);
+  while (reg->hash[slot] != 0)
+  {
+    uint8_t idx = reg->hash[slot] - 1;
+    if (memcmp(reg->handle->rom_id[idx].array, id->array, 8) == 0)
+    {
+      return idx;
+    }
+    slot = (slot + 1) & (OW_REG_HASH_LEN - 1);
+  }
+
+  return OW_REG_NONE;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Get first device of a family.
+ * @param[in]  reg: Pointer to the registry.
+ * @param[in]  family: Family code.
+ * @retval ROM ID index, OW_REG_NONE if no device of the family.
+ *
+ * @code
+ * for (uint8_t idx = ow_reg_first(&reg, 0x28); idx != OW_REG_NONE; idx = ow_reg_next(&reg, idx))
+ * @endcode
+ */
+uint8_t ow_reg_first(ow_reg_t *reg, uint8_t family)
+{
+  assert_param(reg != NULL);
+
+  uint8_t fam = ow_reg_family(reg, family);
+  return (fam == OW_REG_NONE) ? OW_REG_NONE : reg->fam_head[fam];
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Get next device of same family.
+ * @param[in]  reg: Pointer to the registry.
+ * @param[in]  rom_id: ROM ID index of current device.
+ * @retval ROM ID index, OW_REG_NONE after last device of the family.
+ */
+uint8_t ow_reg_next(ow_reg_t *reg, uint8_t rom_id)
+{
+  assert_param(reg != NULL);
+  assert_param(rom_id < reg->dev_max);
+
+  return reg->dev[rom_id].next;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Get metadata of a device.
+ * @param[in]  reg: Pointer to the registry.
+ * @param[in]  rom_id: ROM ID index of the device.
+ * @retval Pointer to the metadata.
+ */
+ow_reg_dev_t *ow_reg_dev(ow_reg_t *reg, uint8_t rom_id)
+{
+  assert_param(reg != NULL);
+  assert_param(rom_id < reg->dev_max);
+
+  return &reg->dev[rom_id];
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Store result of a transfer to a device.
+ * @param[in]  reg: Pointer to the registry.
+ * @param[in]  rom_id: ROM ID index of the device.
+ * @param[in]  error: Error of the transfer.
+ * @param[in]  value: Value read, kept only if error is OW_ERR_NONE.
+ */
+void ow_reg_update(ow_reg_t *reg, uint8_t rom_id, ow_err_t error, int32_t value)
+{
+  assert_param(reg != NULL);
+  assert_param(rom_id < reg->dev_max);
+
+  ow_reg_dev_t *dev = &reg->dev[rom_id];
+  if (error == OW_ERR_NONE)
+  {
+    dev->value = value;
+    dev->seen = HAL_GetTick();
+  }
+  else if (dev->err_cnt < 0xFFFF)
+  {
+    dev->err_cnt++;
+  }
+}
+
+/*************************************************************************************************/
+/** Private Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Get first hash slot of a ROM ID, CRC and low serial bytes are evenly spread.
+ * @param[in]  id: Pointer to the ROM ID.
+ * @retval Hash slot.
+ */
+static uint16_t ow_reg_hash(const ow_id_t *id)
+{
+  uint16_t hash = (uint16_t)(id->rom_id_struct.crc | (id->rom_id_struct.serial[0] << 8));
+  hash ^= (uint16_t)(id->rom_id_struct.serial[1] << 3);
+  return hash & (OW_REG_HASH_LEN - 1);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Get bucket of a family.
+ * @param[in]  reg: Pointer to the registry.
+ * @param[in]  family: Family code.
+ * @retval Bucket index, OW_REG_NONE if family has no bucket.
+ */
+static uint8_t ow_reg_family(ow_reg_t *reg, uint8_t family)
+{
+  for (uint8_t fam = 0; fam < reg->fam_cnt; fam++)
+  {
+    if (reg->fam_code[fam] == family)
+    {
+      return fam;
+    }
+  }
+  return OW_REG_NONE;
+}
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
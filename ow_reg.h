@@ -0,0 +1,118 @@
+
+/*
+ * @file        ow_reg.h
+ * @brief       ROM ID indexed device registry on top of OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+#ifndef _OW_REG_H_
+#define _OW_REG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "ow.h"
+
+/*************************************************************************************************/
+/** Defines **/
+/*************************************************************************************************/
+
+/* ROM ID hash slots (power of 2, more than OW_MAX_DEVICE) and family buckets of one registry */
+#define OW_REG_HASH_LEN           256
+#define OW_REG_MAX_FAMILY         8
+
+/* No device */
+#define OW_REG_NONE               0xFF
+
+#if (OW_MAX_DEVICE == 1)
+#error  ow_reg needs OW_MAX_DEVICE > 1!
+#endif
+
+#if ((OW_REG_HASH_LEN & (OW_REG_HASH_LEN - 1)) != 0) || (OW_REG_HASH_LEN <= OW_MAX_DEVICE)
+#error  OW_REG_HASH_LEN should be a power of 2 bigger than OW_MAX_DEVICE!
+#endif
+
+/*************************************************************************************************/
+/** Typedef/Struct/Enum **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/* Metadata of one device, same index as ROM ID list of the bus */
+typedef struct
+{
+  int32_t                   value;                 /* Last value, e.g. temperature */
+  uint32_t                  seen;                  /* Tick of last successful transfer */
+  uint16_t                  err_cnt;               /* Failed transfers */
+  bool                      od_cap;                /* Overdrive capable, set by application */
+  uint8_t                   next;                  /* Next device of same family, or OW_REG_NONE */
+
+} ow_reg_dev_t;
+
+/*************************************************************************************************/
+/* Registry of one bus */
+typedef struct
+{
+  ow_t                      *handle;               /* 1-Wire bus */
+  ow_reg_dev_t              *dev;                  /* Metadata table of caller */
+  uint8_t                   dev_max;               /* Entries of metadata table */
+  uint8_t                   hash[OW_REG_HASH_LEN]; /* ROM ID index + 1 by ROM ID hash, 0 == empty */
+  uint8_t                   fam_code[OW_REG_MAX_FAMILY]; /* Family code of each bucket */
+  uint8_t                   fam_head[OW_REG_MAX_FAMILY]; /* First device of each bucket */
+  uint8_t                   fam_cnt;               /* Number of buckets */
+
+} ow_reg_t;
+
+/*************************************************************************************************/
+/** API Functions **/
+/*************************************************************************************************/
+
+/* Initialize registry of a bus with caller metadata table */
+void      ow_reg_init(ow_reg_t *reg, ow_t *handle, ow_reg_dev_t *dev, uint8_t dev_max);
+
+/* Rebuild index from ROM ID list of the bus, after a search or rescan */
+ow_err_t  ow_reg_sync(ow_reg_t *reg, bool clear);
+
+/* Clear metadata of an arrived or departed device, call it in rescan callback */
+void      ow_reg_change(ow_reg_t *reg, uint8_t rom_id);
+
+/* Find ROM ID index of a known ROM ID */
+uint8_t   ow_reg_find(ow_reg_t *reg, const ow_id_t *id);
+
+/* First device of a family, or OW_REG_NONE */
+uint8_t   ow_reg_first(ow_reg_t *reg, uint8_t family);
+
+/* Next device of same family, or OW_REG_NONE */
+uint8_t   ow_reg_next(ow_reg_t *reg, uint8_t rom_id);
+
+/* Get metadata of a device */
+ow_reg_dev_t *ow_reg_dev(ow_reg_t *reg, uint8_t rom_id);
+
+/* Store result of a transfer to a device */
+void      ow_reg_update(ow_reg_t *reg, uint8_t rom_id, ow_err_t error, int32_t value);
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _OW_REG_H_ */
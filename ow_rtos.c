@@ -0,0 +1,258 @@
+
+/*
+ * @file        ow_rtos.c
+ * @brief       RTOS layer of OneWire driver, bus mutex and blocking waits (CMSIS-RTOS2)
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed. 
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "ow_rtos.h"
+
+/*************************************************************************************************/
+/** Private Function prototype **/
+/*************************************************************************************************/
+
+/* Done callback of the bus, wakes the waiting task */
+static void ow_rtos_done(ow_t *handle, ow_err_t error, void *arg);
+
+/* Wait for started transfer, abort it on timeout */
+static ow_err_t ow_rtos_finish(ow_rtos_t *rtos, uint32_t timeout);
+
+/*************************************************************************************************/
+/** Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Create RTOS objects of a bus and register their done callback.
+ * @param[out] rtos: Pointer to the RTOS state.
+ * @param[in]  handle: Pointer to the initialized 1-Wire handle, done_cb of ow_init_t stays in use.
+ * @retval OW_ERR_NONE, OW_ERR_BUSY if the bus is running, OW_ERR_BUS if an object was not created.
+ *
+ * @details
+ * Call it after ow_init() and after the RTOS kernel is initialized.
+ */
+ow_err_t ow_rtos_init(ow_rtos_t *rtos, ow_t *handle)
+{
+  assert_param(rtos != NULL);
+  assert_param(handle != NULL);
+
+  /* Priority inheritance, a low priority owner runs while a high priority task waits */
+  const osMutexAttr_t mutex_attr = { .name = "ow", .attr_bits = osMutexPrioInherit };
+
+  rtos->handle = handle;
+  rtos->error = OW_ERR_NONE;
+  rtos->mutex = osMutexNew(&mutex_attr);
+  rtos->done = osSemaphoreNew(1, 0, NULL);
+  if ((rtos->mutex == NULL) || (rtos->done == NULL))
+  {
+    return OW_ERR_BUS;
+  }
+
+  return ow_set_done_cb(handle, ow_rtos_done, rtos);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Take bus for a sequence of transfers, e.g. convert then read.
+ * @param[in]  rtos: Pointer to the RTOS state.
+ * @param[in]  timeout: Max wait for the bus in RTOS ticks, osWaitForever to wait forever.
+ * @retval OW_ERR_NONE, OW_ERR_TIMEOUT if another task kept the bus.
+ */
+ow_err_t ow_rtos_lock(ow_rtos_t *rtos, uint32_t timeout)
+{
+  assert_param(rtos != NULL);
+
+  if (osMutexAcquire(rtos->mutex, timeout) != osOK)
+  {
+    return OW_ERR_TIMEOUT;
+  }
+
+  /* Drop done signal of a transfer nobody waited for */
+  (void)osSemaphoreAcquire(rtos->done, 0);
+
+  return OW_ERR_NONE;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Give bus back, next waiting task of highest priority takes it.
+ * @param[in]  rtos: Pointer to the RTOS state.
+ */
+void ow_rtos_unlock(ow_rtos_t *rtos)
+{
+  assert_param(rtos != NULL);
+
+  (void)osMutexRelease(rtos->mutex);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Sleep until the transfer started after ow_rtos_lock() is done, without polling.
+ * @param[in]  rtos: Pointer to the RTOS state.
+ * @param[in]  timeout: Max wait in RTOS ticks, osWaitForever to wait forever.
+ * @retval Error of the transfer, OW_ERR_TIMEOUT if it is still running.
+ *
+ * @details
+ * Call it only when the transfer was started, i.e. did not return OW_ERR_BUSY. A transfer that
+ * failed to start calls done callback at once, so its error is returned without sleeping.
+ */
+ow_err_t ow_xfer_wait(ow_rtos_t *rtos, uint32_t timeout)
+{
+  assert_param(rtos != NULL);
+
+  if (osSemaphoreAcquire(rtos->done, timeout) != osOK)
+  {
+    return OW_ERR_TIMEOUT;
+  }
+
+  return rtos->error;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Transfer by Skip ROM from a task: lock bus, write, read into caller buffer, wait, unlock.
+ * @param[in]  rtos: Pointer to the RTOS state.
+ * @param[in]  fn_cmd: Function command.
+ * @param[in]  w_data: Pointer to write data, can be NULL if w_len is 0.
+ * @param[in]  w_len: Write length.
+ * @param[out] r_data: Caller buffer, can be NULL if r_len is 0.
+ * @param[in]  r_len: Read length, not limited by OW_MAX_DATA_LEN.
+ * @param[in]  timeout: Max wait for bus and for transfer, in RTOS ticks each.
+ * @retval Error of the transfer (ow_err_t), OW_ERR_TIMEOUT if it was aborted.
+ */
+ow_err_t ow_rtos_xfer(ow_rtos_t *rtos, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len,
+                      uint8_t *r_data, uint16_t r_len, uint32_t timeout)
+{
+  ow_err_t ow_err;
+  assert_param(rtos != NULL);
+
+  ow_err = ow_rtos_lock(rtos, timeout);
+  if (ow_err != OW_ERR_NONE)
+  {
+    return ow_err;
+  }
+
+  /* Drop done signal of a queued job ended since lock, busy means a transfer outside the mutex */
+  (void)osSemaphoreAcquire(rtos->done, 0);
+  ow_err = ow_xfer_buf(rtos->handle, fn_cmd, w_data, w_len, r_data, r_len);
+  if (ow_err != OW_ERR_BUSY)
+  {
+    ow_err = ow_rtos_finish(rtos, timeout);
+  }
+
+  ow_rtos_unlock(rtos);
+  return ow_err;
+}
+
+#if (OW_MAX_DEVICE > 1)
+/*************************************************************************************************/
+/**
+ * @brief  Transfer by ROM ID index from a task: lock bus, write, read into caller buffer, wait, unlock.
+ * @param[in]  rtos: Pointer to the RTOS state.
+ * @param[in]  rom_id: ROM ID index.
+ * @param[in]  fn_cmd: Function command.
+ * @param[in]  w_data: Pointer to write data, can be NULL if w_len is 0.
+ * @param[in]  w_len: Write length.
+ * @param[out] r_data: Caller buffer, can be NULL if r_len is 0.
+ * @param[in]  r_len: Read length, not limited by OW_MAX_DATA_LEN.
+ * @param[in]  timeout: Max wait for bus and for transfer, in RTOS ticks each.
+ * @retval Error of the transfer (ow_err_t), OW_ERR_TIMEOUT if it was aborted.
+ */
+ow_err_t ow_rtos_xfer_by_id(ow_rtos_t *rtos, uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data,
+                            uint16_t w_len, uint8_t *r_data, uint16_t r_len, uint32_t timeout)
+{
+  ow_err_t ow_err;
+  assert_param(rtos != NULL);
+
+  ow_err = ow_rtos_lock(rtos, timeout);
+  if (ow_err != OW_ERR_NONE)
+  {
+    return ow_err;
+  }
+
+  /* Drop done signal of a queued job ended since lock, busy means a transfer outside the mutex */
+  (void)osSemaphoreAcquire(rtos->done, 0);
+  ow_err = ow_xfer_buf_by_id(rtos->handle, rom_id, fn_cmd, w_data, w_len, r_data, r_len);
+  if (ow_err != OW_ERR_BUSY)
+  {
+    ow_err = ow_rtos_finish(rtos, timeout);
+  }
+
+  ow_rtos_unlock(rtos);
+  return ow_err;
+}
+#endif
+
+/*************************************************************************************************/
+/** Private Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Done callback of the bus, store error and wake the waiting task.
+ * @param[in]  handle: Pointer to the 1-Wire handle.
+ * @param[in]  error: Error of the finished transfer.
+ * @param[in]  arg: Pointer to the RTOS state.
+ */
+static void ow_rtos_done(ow_t *handle, ow_err_t error, void *arg)
+{
+  ow_rtos_t *rtos = (ow_rtos_t *)arg;
+  (void)handle;
+
+  rtos->error = error;
+  (void)osSemaphoreRelease(rtos->done);
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Wait for the transfer started by this task, abort it on timeout.
+ * @param[in]  rtos: Pointer to the RTOS state.
+ * @param[in]  timeout: Max wait in RTOS ticks, osWaitForever to wait forever.
+ * @retval Error of the transfer, OW_ERR_TIMEOUT if it was aborted.
+ *
+ * @details
+ * The caller buffer may go out of scope after return, so the transfer is stopped before the bus
+ * is given back. A transfer that ended just after the timeout left its done signal, then a queued
+ * job started by its done callback keeps running.
+ */
+static ow_err_t ow_rtos_finish(ow_rtos_t *rtos, uint32_t timeout)
+{
+  if (osSemaphoreAcquire(rtos->done, timeout) == osOK)
+  {
+    return rtos->error;
+  }
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (osSemaphoreGetCount(rtos->done) == 0)
+  {
+    ow_abort(rtos->handle);
+  }
+  __set_PRIMASK(primask);
+
+  /* Done signal of the ended or aborted transfer */
+  (void)osSemaphoreAcquire(rtos->done, 0);
+  return rtos->error;
+}
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
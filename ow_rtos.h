@@ -0,0 +1,84 @@
+
+/*
+ * @file        ow_rtos.h
+ * @brief       RTOS layer of OneWire driver, bus mutex and blocking waits (CMSIS-RTOS2)
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+
+#ifndef _OW_RTOS_H_
+#define _OW_RTOS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "ow.h"
+#include "cmsis_os2.h"
+
+/*************************************************************************************************/
+/** Typedef/Struct/Enum **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/* RTOS objects of one bus */
+typedef struct
+{
+  ow_t                      *handle;               /* 1-Wire bus */
+  osMutexId_t               mutex;                 /* Bus owner, waiting tasks queued by priority */
+  osSemaphoreId_t           done;                  /* Given from ISR when a transfer is done */
+  volatile ow_err_t         error;                 /* Error of last finished transfer */
+
+} ow_rtos_t;
+
+/*************************************************************************************************/
+/** API Functions **/
+/*************************************************************************************************/
+
+/* Create mutex and semaphore of a bus, registers done callback of the handle */
+ow_err_t  ow_rtos_init(ow_rtos_t *rtos, ow_t *handle);
+
+/* Take bus for a sequence of transfers, timeout in RTOS ticks */
+ow_err_t  ow_rtos_lock(ow_rtos_t *rtos, uint32_t timeout);
+
+/* Give bus back to next waiting task */
+void      ow_rtos_unlock(ow_rtos_t *rtos);
+
+/* Sleep until the started transfer is done, timeout in RTOS ticks */
+ow_err_t  ow_xfer_wait(ow_rtos_t *rtos, uint32_t timeout);
+
+/* Lock, transfer by Skip ROM into caller buffer, wait and unlock */
+ow_err_t  ow_rtos_xfer(ow_rtos_t *rtos, uint8_t fn_cmd, const uint8_t *w_data, uint16_t w_len,
+                       uint8_t *r_data, uint16_t r_len, uint32_t timeout);
+
+#if (OW_MAX_DEVICE > 1)
+/* Lock, transfer by ROM ID index into caller buffer, wait and unlock */
+ow_err_t  ow_rtos_xfer_by_id(ow_rtos_t *rtos, uint8_t rom_id, uint8_t fn_cmd, const uint8_t *w_data,
+                             uint16_t w_len, uint8_t *r_data, uint16_t r_len, uint32_t timeout);
+#endif
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _OW_RTOS_H_ */
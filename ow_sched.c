@@ -0,0 +1,353 @@
+
+/*
+ * @file        ow_sched.c
+ * @brief       Periodic job scheduler on top of OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed. 
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include <string.h>
+#include "ow_sched.h"
+
+/*************************************************************************************************/
+/** Private Function prototype **/
+/*************************************************************************************************/
+
+/* Release jobs whose period elapsed */
+static void ow_sched_release(ow_sched_t *sched, uint32_t now);
+
+/* Finish step of bus after its transfer is done */
+static void ow_sched_done(ow_sched_bus_t *bus, uint32_t now);
+
+/* Start ready step with earliest deadline on idle bus */
+static void ow_sched_start(ow_sched_t *sched, ow_sched_bus_t *bus, uint32_t now);
+
+/* Tick a is reached at tick b, tick counter may wrap */
+static bool ow_sched_reached(uint32_t a, uint32_t b);
+
+/*************************************************************************************************/
+/** Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Initialize scheduler without jobs.
+ * @param[out] sched: Pointer to the scheduler.
+ */
+void ow_sched_init(ow_sched_t *sched)
+{
+  assert_param(sched != NULL);
+
+  memset(sched, 0, sizeof(ow_sched_t));
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Add periodic job, its bus is added to the scheduler if new.
+ * @param[in]  sched: Pointer to the scheduler.
+ * @param[out] job: Pointer to the job state, valid while scheduled.
+ * @param[in]  init: Pointer to the job configuration, copied.
+ * @retval OW_ERR_NONE, OW_ERR_LEN if configuration is invalid, OW_ERR_BUSY if scheduler is full.
+ */
+ow_err_t ow_sched_add(ow_sched_t *sched, ow_sched_job_t *job, const ow_sched_job_init_t *init)
+{
+  assert_param(sched != NULL);
+  assert_param(job != NULL);
+  assert_param(init != NULL);
+  assert_param(init->handle != NULL);
+
+  if ((init->step == NULL) || (init->step_cnt == 0) || (init->period_ms == 0))
+  {
+    return OW_ERR_LEN;
+  }
+  for (uint8_t idx = 0; idx < init->step_cnt; idx++)
+  {
+    if ((init->step[idx].w_len > 0) && (init->step[idx].w_data == NULL))
+    {
+      return OW_ERR_LEN;
+    }
+  }
+  if (sched->job_cnt == OW_SCHED_MAX_JOB)
+  {
+    return OW_ERR_BUSY;
+  }
+
+  /* Bus of job */
+  uint8_t idx = 0;
+  while ((idx < sched->bus_cnt) && (sched->bus[idx].handle != init->handle))
+  {
+    idx++;
+  }
+  if (idx == sched->bus_cnt)
+  {
+    if (sched->bus_cnt == OW_SCHED_MAX_BUS)
+    {
+      return OW_ERR_BUSY;
+    }
+    memset(&sched->bus[idx], 0, sizeof(ow_sched_bus_t));
+    sched->bus[idx].handle = init->handle;
+    sched->bus[idx].window = HAL_GetTick();
+    sched->bus_cnt++;
+  }
+
+  /* First release at next run */
+  memset(job, 0, sizeof(ow_sched_job_t));
+  job->cfg = *init;
+  if (job->cfg.deadline_ms == 0)
+  {
+    job->cfg.deadline_ms = job->cfg.period_ms;
+  }
+  job->release = HAL_GetTick();
+  sched->job[sched->job_cnt++] = job;
+
+  return OW_ERR_NONE;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Run scheduler: release jobs, finish done steps and start ready steps on idle buses.
+ * @param[in]  sched: Pointer to the scheduler.
+ *
+ * @details
+ * Call it in main loop. A step waiting for its wait_ms (e.g. conversion) leaves the bus free,
+ * so steps of other jobs run in that window. Ready steps start by earliest deadline.
+ * Job callbacks are called from here, not from ISR.
+ */
+void ow_sched_run(ow_sched_t *sched)
+{
+  assert_param(sched != NULL);
+
+  uint32_t now = HAL_GetTick();
+  ow_sched_release(sched, now);
+  for (uint8_t idx = 0; idx < sched->bus_cnt; idx++)
+  {
+    ow_sched_bus_t *bus = &sched->bus[idx];
+    if ((bus->running != NULL) && !ow_is_busy(bus->handle))
+    {
+      ow_sched_done(bus, now);
+    }
+    if (bus->running == NULL)
+    {
+      ow_sched_start(sched, bus, now);
+    }
+  }
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Get bus load since last call on this bus, by transfer time of scheduled steps.
+ * @param[in]  sched: Pointer to the scheduler.
+ * @param[in]  handle: Pointer to the 1-Wire bus.
+ * @retval Load in percent, 0 if bus is not scheduled.
+ *
+ * @details
+ * Transfer end is seen by ow_sched_run(), so resolution depends on how often it is called.
+ */
+uint8_t ow_sched_load(ow_sched_t *sched, ow_t *handle)
+{
+  assert_param(sched != NULL);
+
+  for (uint8_t idx = 0; idx < sched->bus_cnt; idx++)
+  {
+    ow_sched_bus_t *bus = &sched->bus[idx];
+    if (bus->handle != handle)
+    {
+      continue;
+    }
+
+    /* Running transfer counts up to now, rest in next window */
+    uint32_t now = HAL_GetTick();
+    uint32_t busy = bus->busy_ms;
+    if (bus->running != NULL)
+    {
+      busy += now - bus->start;
+      bus->start = now;
+    }
+    uint32_t elapsed = now - bus->window;
+    bus->window = now;
+    bus->busy_ms = 0;
+    if (elapsed == 0)
+    {
+      return 0;
+    }
+    return (uint8_t)((busy >= elapsed) ? 100 : ((busy * 100) / elapsed));
+  }
+
+  return 0;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Get late or skipped releases of job.
+ * @param[in]  job: Pointer to the job state.
+ * @retval Number of missed deadlines.
+ */
+uint32_t ow_sched_misses(ow_sched_job_t *job)
+{
+  assert_param(job != NULL);
+  return job->misses;
+}
+
+/*************************************************************************************************/
+/** Private Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Release jobs whose period elapsed, a release still running skips the new one.
+ * @param[in]  sched: Pointer to the scheduler.
+ * @param[in]  now: Current tick.
+ */
+static void ow_sched_release(ow_sched_t *sched, uint32_t now)
+{
+  for (uint8_t idx = 0; idx < sched->job_cnt; idx++)
+  {
+    ow_sched_job_t *job = sched->job[idx];
+    if (!ow_sched_reached(job->release, now))
+    {
+      continue;
+    }
+
+    if (job->active)
+    {
+      job->misses++;
+    }
+    else
+    {
+      job->active = true;
+      job->step_idx = 0;
+      job->ready = now;
+      job->due = job->release + job->cfg.deadline_ms;
+    }
+
+    /* Keep period grid, releases missed by a late run are skipped */
+    job->release += job->cfg.period_ms;
+    while (ow_sched_reached(job->release, now))
+    {
+      job->release += job->cfg.period_ms;
+      job->misses++;
+    }
+  }
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Finish step of bus, schedule next step or report job done.
+ * @param[in]  bus: Pointer to the bus state.
+ * @param[in]  now: Current tick.
+ */
+static void ow_sched_done(ow_sched_bus_t *bus, uint32_t now)
+{
+  ow_sched_job_t *job = bus->running;
+  ow_err_t error = ow_last_error(bus->handle);
+
+  bus->running = NULL;
+  bus->busy_ms += now - bus->start;
+
+  /* More steps, bus is free during wait */
+  if ((error == OW_ERR_NONE) && (job->step_idx + 1 < job->cfg.step_cnt))
+  {
+    job->ready = now + job->cfg.step[job->step_idx].wait_ms;
+    job->step_idx++;
+    return;
+  }
+
+  job->active = false;
+  if (error == OW_ERR_NONE)
+  {
+    job->runs++;
+  }
+  else
+  {
+    job->errors++;
+  }
+  if (!ow_sched_reached(now, job->due))
+  {
+    job->misses++;
+  }
+  if (job->cfg.cb != NULL)
+  {
+    job->cfg.cb(job, error);
+  }
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Start ready step with earliest deadline on idle bus.
+ * @param[in]  sched: Pointer to the scheduler.
+ * @param[in]  bus: Pointer to the bus state.
+ * @param[in]  now: Current tick.
+ */
+static void ow_sched_start(ow_sched_t *sched, ow_sched_bus_t *bus, uint32_t now)
+{
+  ow_sched_job_t *next = NULL;
+  ow_err_t ow_err;
+
+  for (uint8_t idx = 0; idx < sched->job_cnt; idx++)
+  {
+    ow_sched_job_t *job = sched->job[idx];
+    if ((job->cfg.handle != bus->handle) || !job->active || !ow_sched_reached(job->ready, now))
+    {
+      continue;
+    }
+    if ((next == NULL) || ((int32_t)(job->due - next->due) < 0))
+    {
+      next = job;
+    }
+  }
+  if (next == NULL)
+  {
+    return;
+  }
+
+  const ow_sched_step_t *step = &next->cfg.step[next->step_idx];
+#if (OW_MAX_DEVICE > 1)
+  if (next->cfg.rom_id != OW_SCHED_SKIP_ROM)
+  {
+    ow_err = ow_xfer_by_id(bus->handle, next->cfg.rom_id, step->fn_cmd, step->w_data, step->w_len, step->r_len);
+  }
+  else
+#endif
+  {
+    ow_err = ow_xfer(bus->handle, step->fn_cmd, step->w_data, step->w_len, step->r_len);
+  }
+
+  /* Bus taken outside scheduler, retry at next run. Other errors are seen when done */
+  if (ow_err != OW_ERR_BUSY)
+  {
+    bus->running = next;
+    bus->start = now;
+  }
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Check if tick a is reached at tick b, tick counter may wrap.
+ * @param[in]  a: Tick to reach.
+ * @param[in]  b: Current tick.
+ * @retval true if b is at or after a.
+ */
+static bool ow_sched_reached(uint32_t a, uint32_t b)
+{
+  return ((int32_t)(b - a) >= 0);
+}
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
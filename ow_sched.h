@@ -0,0 +1,147 @@
+
+
+/*
+ * @file        ow_sched.h
+ * @brief       Periodic job scheduler on top of OneWire driver
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed. 
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+#ifndef _OW_SCHED_H_
+#define _OW_SCHED_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "ow.h"
+
+/*************************************************************************************************/
+/** Defines **/
+/*************************************************************************************************/
+
+/* Max jobs and buses of one scheduler */
+#define OW_SCHED_MAX_JOB          16
+#define OW_SCHED_MAX_BUS          4
+
+/* Job without ROM ID, sent by Skip ROM */
+#define OW_SCHED_SKIP_ROM         0xFF
+
+/*************************************************************************************************/
+/** Typedef/Struct/Enum **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/* One transfer of a job, the bus is free for other jobs during its wait */
+typedef struct
+{
+  uint8_t                   fn_cmd;                /* Function command */
+  const uint8_t             *w_data;               /* Write data, can be NULL if w_len is 0 */
+  uint16_t                  w_len;                 /* Write data length */
+  uint16_t                  r_len;                 /* Read data length */
+  uint16_t                  wait_ms;               /* Time before next step, e.g. conversion */
+
+} ow_sched_step_t;
+
+/*************************************************************************************************/
+/* Job done callback, response of last step can be read by ow_read_resp() inside it */
+struct ow_sched_job_s;
+typedef void (*ow_sched_cb_t)(struct ow_sched_job_s *job, ow_err_t error);
+
+/*************************************************************************************************/
+/* Used to configure a periodic job */
+typedef struct
+{
+  ow_t                      *handle;               /* 1-Wire bus */
+  uint8_t                   rom_id;                /* ROM ID index, or OW_SCHED_SKIP_ROM */
+  const ow_sched_step_t     *step;                 /* Steps, valid while job is scheduled */
+  uint8_t                   step_cnt;              /* Number of steps */
+  uint32_t                  period_ms;             /* Release period */
+  uint32_t                  deadline_ms;           /* Last step done after release, 0 == period */
+  ow_sched_cb_t             cb;                    /* Done callback, can be NULL */
+  void                      *arg;                  /* Callback argument */
+
+} ow_sched_job_init_t;
+
+/*************************************************************************************************/
+/* Periodic job state and counters */
+typedef struct ow_sched_job_s
+{
+  ow_sched_job_init_t       cfg;                   /* Job configuration */
+  uint32_t                  release;               /* Tick of next release */
+  uint32_t                  due;                   /* Deadline tick of running release */
+  uint32_t                  ready;                 /* Tick next step may start */
+  uint8_t                   step_idx;              /* Next step */
+  bool                      active;                /* Release running */
+  uint32_t                  runs;                  /* Completed releases */
+  uint32_t                  misses;                /* Late or skipped releases */
+  uint32_t                  errors;                /* Releases ended by bus error */
+
+} ow_sched_job_t;
+
+/*************************************************************************************************/
+/* State of one bus */
+typedef struct
+{
+  ow_t                      *handle;               /* 1-Wire bus */
+  ow_sched_job_t            *running;              /* Job of ongoing transfer, NULL if none */
+  uint32_t                  start;                 /* Tick ongoing transfer started */
+  uint32_t                  busy_ms;               /* Transfer time in load window */
+  uint32_t                  window;                /* Tick load window started */
+
+} ow_sched_bus_t;
+
+/*************************************************************************************************/
+/* Scheduler of jobs on several buses */
+typedef struct
+{
+  ow_sched_job_t            *job[OW_SCHED_MAX_JOB];  /* Scheduled jobs */
+  uint8_t                   job_cnt;               /* Number of jobs */
+  ow_sched_bus_t            bus[OW_SCHED_MAX_BUS]; /* Buses of jobs */
+  uint8_t                   bus_cnt;               /* Number of buses */
+
+} ow_sched_t;
+
+/*************************************************************************************************/
+/** API Functions **/
+/*************************************************************************************************/
+
+/* Initialize scheduler */
+void      ow_sched_init(ow_sched_t *sched);
+
+/* Add periodic job, first release at once */
+ow_err_t  ow_sched_add(ow_sched_t *sched, ow_sched_job_t *job, const ow_sched_job_init_t *init);
+
+/* Must be called in main loop, starts ready steps on idle buses */
+void      ow_sched_run(ow_sched_t *sched);
+
+/* Bus load in percent since last call on this bus */
+uint8_t   ow_sched_load(ow_sched_t *sched, ow_t *handle);
+
+/* Return late or skipped releases of job */
+uint32_t  ow_sched_misses(ow_sched_job_t *job);
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _OW_SCHED_H_ */
@@ -0,0 +1,203 @@
+
+/*
+ * @file        ow_trace.c
+ * @brief       Slot timing decoder of OneWire trace ring
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include <string.h>
+#include "ow_trace.h"
+
+/*************************************************************************************************/
+/** Private Defines **/
+/*************************************************************************************************/
+
+/* Event role in its slot, pull low roles are the slot type */
+#define OW_TRACE_ROLE_RESET       OW_TRACE_SLOT_RESET
+#define OW_TRACE_ROLE_WRITE       OW_TRACE_SLOT_WRITE
+#define OW_TRACE_ROLE_READ        OW_TRACE_SLOT_READ
+#define OW_TRACE_ROLE_RELEASE     3
+#define OW_TRACE_ROLE_SAMPLE      4
+#define OW_TRACE_ROLE_OTHER       5
+
+/*************************************************************************************************/
+/** Private Function prototype **/
+/*************************************************************************************************/
+
+/* Role of an event in its slot */
+static uint8_t ow_trace_role(const ow_trace_t *trace);
+
+/* Close a slot at the next event */
+static void ow_trace_close(ow_trace_slot_t *slot, uint16_t period);
+
+/*************************************************************************************************/
+/** Private Variables **/
+/*************************************************************************************************/
+
+/* Roles by bit phase of transfers and programs: reset, write, read, wait, poll, strong pull-up */
+static const uint8_t ow_trace_xfer_role[] =
+{
+  OW_TRACE_ROLE_RESET, OW_TRACE_ROLE_RELEASE, OW_TRACE_ROLE_SAMPLE,
+  OW_TRACE_ROLE_WRITE, OW_TRACE_ROLE_RELEASE,
+  OW_TRACE_ROLE_READ, OW_TRACE_ROLE_RELEASE, OW_TRACE_ROLE_SAMPLE,
+  OW_TRACE_ROLE_OTHER,
+  OW_TRACE_ROLE_READ, OW_TRACE_ROLE_RELEASE, OW_TRACE_ROLE_SAMPLE,
+  OW_TRACE_ROLE_OTHER, OW_TRACE_ROLE_OTHER
+};
+
+/* Roles by bit phase of searches: reset, command, bit, complement, selected bit */
+static const uint8_t ow_trace_search_role[] =
+{
+  OW_TRACE_ROLE_RESET, OW_TRACE_ROLE_RELEASE, OW_TRACE_ROLE_SAMPLE,
+  OW_TRACE_ROLE_WRITE, OW_TRACE_ROLE_RELEASE,
+  OW_TRACE_ROLE_READ, OW_TRACE_ROLE_RELEASE, OW_TRACE_ROLE_SAMPLE,
+  OW_TRACE_ROLE_READ, OW_TRACE_ROLE_RELEASE, OW_TRACE_ROLE_SAMPLE,
+  OW_TRACE_ROLE_WRITE, OW_TRACE_ROLE_RELEASE
+};
+
+/*************************************************************************************************/
+/** Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Rebuild slots from events of ow_trace_read().
+ * @param[in]  trace: Events, oldest first.
+ * @param[in]  trace_cnt: Number of events.
+ * @param[out] slot: Decoded slots.
+ * @param[in]  slot_max: Entries of slot table.
+ * @retval Number of decoded slots.
+ *
+ * @details
+ * Times are ISR entries, programmed event plus latency, the pin changes some CPU cycles later.
+ * Events before the first pull low of the ring are skipped. The bus is sampled once per event,
+ * so a reset slot tells that the presence pulse was there at sample, and idle of the next slot
+ * tells that it was gone at the first command slot. Written bits come from the slot shape,
+ * short low is 1, so they are known only if the next event is in the ring.
+ */
+uint16_t ow_trace_decode(const ow_trace_t *trace, uint16_t trace_cnt, ow_trace_slot_t *slot, uint16_t slot_max)
+{
+  assert_param(trace != NULL);
+  assert_param(slot != NULL);
+
+  uint16_t slot_cnt = 0;
+  ow_trace_slot_t *cur = NULL;
+
+  for (uint16_t idx = 0; idx < trace_cnt; idx++)
+  {
+    const ow_trace_t *evt = &trace[idx];
+    uint16_t now = (uint16_t)(evt->time + evt->lat);
+    uint8_t role = ow_trace_role(evt);
+
+    /* Pull low or any other event ends the running slot, a new transaction counts from 0 again */
+    if ((cur != NULL) && ((role <= OW_TRACE_ROLE_READ) || (role == OW_TRACE_ROLE_OTHER)))
+    {
+      bool restart = (evt->state != OW_STATE_DONE) && (evt->phase == 0) && (evt->time == 0);
+      ow_trace_close(cur, restart ? 0 : (uint16_t)(now - cur->start));
+      cur = NULL;
+    }
+
+    if (role <= OW_TRACE_ROLE_READ)
+    {
+      if (slot_cnt == slot_max)
+      {
+        break;
+      }
+      cur = &slot[slot_cnt++];
+      memset(cur, 0, sizeof(ow_trace_slot_t));
+      cur->start = now;
+      cur->lat_max = evt->lat;
+      cur->type = (ow_trace_slot_type_t)role;
+      cur->bit = OW_TRACE_BIT_NONE;
+      cur->idle = (evt->level != 0);
+    }
+    else if (cur != NULL)
+    {
+      if (evt->lat > cur->lat_max)
+      {
+        cur->lat_max = evt->lat;
+      }
+      if (role == OW_TRACE_ROLE_RELEASE)
+      {
+        cur->low = (uint16_t)(now - cur->start);
+      }
+      else if (role == OW_TRACE_ROLE_SAMPLE)
+      {
+        cur->sample = (uint16_t)(now - cur->start);
+        cur->bit = evt->level;
+      }
+    }
+  }
+
+  return slot_cnt;
+}
+
+/*************************************************************************************************/
+/** Private Function Implementations **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/**
+ * @brief  Get role of an event from state and bit phase of the TIM backend.
+ * @param[in]  trace: Pointer to the event.
+ * @retval Slot type for pull low events, OW_TRACE_ROLE_RELEASE, OW_TRACE_ROLE_SAMPLE or OW_TRACE_ROLE_OTHER.
+ */
+static uint8_t ow_trace_role(const ow_trace_t *trace)
+{
+  uint8_t role = OW_TRACE_ROLE_OTHER;
+
+  if ((trace->state == OW_STATE_XFER) || (trace->state == OW_STATE_PROG))
+  {
+    if (trace->phase < sizeof(ow_trace_xfer_role))
+    {
+      role = ow_trace_xfer_role[trace->phase];
+    }
+  }
+  else if (trace->state == OW_STATE_SEARCH)
+  {
+    if (trace->phase < sizeof(ow_trace_search_role))
+    {
+      role = ow_trace_search_role[trace->phase];
+    }
+  }
+
+  return role;
+}
+
+/*************************************************************************************************/
+/**
+ * @brief  Close a slot at the next event.
+ * @param[in,out] slot: Pointer to the slot.
+ * @param[in]  period: Pull low to next event, 0 if not known.
+ */
+static void ow_trace_close(ow_trace_slot_t *slot, uint16_t period)
+{
+  slot->period = period;
+
+  /* Write 1 is released early, write 0 late in the slot */
+  if ((slot->type == OW_TRACE_SLOT_WRITE) && (period > 0))
+  {
+    slot->bit = ((slot->low * 2U) < period) ? 1 : 0;
+  }
+}
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
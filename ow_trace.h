@@ -0,0 +1,88 @@
+
+/*
+ * @file        ow_trace.h
+ * @brief       Slot timing decoder of OneWire trace ring
+ * @author      Nima Askari
+ * @version     1.0.0
+ * @license     See the LICENSE file in the root folder.
+ *
+ * @note        All my libraries are dual-licensed.
+ *              Please review the licensing terms before using them.
+ *              For any inquiries, feel free to contact me.
+ *
+ * @github      https://www.github.com/nimaltd
+ * @linkedin    https://www.linkedin.com/in/nimaltd
+ * @youtube     https://www.youtube.com/@nimaltd
+ * @instagram   https://instagram.com/github.nimaltd
+ *
+ * Copyright (C) 2025 Nima Askari - NimaLTD. All rights reserved.
+ */
+
+#ifndef _OW_TRACE_H_
+#define _OW_TRACE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*************************************************************************************************/
+/** Includes **/
+/*************************************************************************************************/
+
+#include "ow.h"
+
+#if (OW_TRACE == 0)
+#error  ow_trace needs OW_TRACE!
+#endif
+
+/*************************************************************************************************/
+/** Defines **/
+/*************************************************************************************************/
+
+/* Written bit not known, last slot of the ring */
+#define OW_TRACE_BIT_NONE         0xFF
+
+/*************************************************************************************************/
+/** Typedef/Struct/Enum **/
+/*************************************************************************************************/
+
+/*************************************************************************************************/
+/* Slot type */
+typedef enum
+{
+  OW_TRACE_SLOT_RESET       = 0,   /* Reset pulse and presence detect */
+  OW_TRACE_SLOT_WRITE,             /* Write slot */
+  OW_TRACE_SLOT_READ,              /* Read slot, also search bits and program polls */
+
+} ow_trace_slot_type_t;
+
+/*************************************************************************************************/
+/* One slot rebuilt from trace events, times in timer ticks at ISR entry */
+typedef struct
+{
+  uint16_t                  start;                 /* Pull low, since first event of transaction */
+  uint16_t                  low;                   /* Pull low to release */
+  uint16_t                  sample;                /* Pull low to sample, 0 for write slots */
+  uint16_t                  period;                /* Pull low to next event, 0 if not traced */
+  uint16_t                  lat_max;               /* Max ISR latency of slot events */
+  ow_trace_slot_type_t      type;                  /* Slot type */
+  uint8_t                   bit;                   /* Read bit, presence (0 == present) or written bit */
+  bool                      idle;                  /* Bus was high before pull low, false if not recovered */
+
+} ow_trace_slot_t;
+
+/*************************************************************************************************/
+/** API Functions **/
+/*************************************************************************************************/
+
+/* Rebuild slots from events of ow_trace_read() */
+uint16_t  ow_trace_decode(const ow_trace_t *trace, uint16_t trace_cnt, ow_trace_slot_t *slot, uint16_t slot_max);
+
+/*************************************************************************************************/
+/** End of File **/
+/*************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _OW_TRACE_H_ */